@@ -1,11 +1,23 @@
+import argparse
 import os
+import subprocess
 
-binaryPath = "C:/Users/micce/source/repos/voxomap_lib/x64/Release/benchmark.exe"
+defaultBinaryPath = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "build", "benchmark")
 
-def launchBenchmark(nb_iteration, min, max):
-	for i in range(0, nb_iteration):
-		for e in range(min, max + 1):
-			cmd = binaryPath + " " + str(e)
-			os.system(cmd)
+def launchBenchmark(binaryPath, nb_iteration, min, max, warmup, json):
+	for e in range(min, max + 1):
+		cmd = [binaryPath, "--repetitions", str(nb_iteration), "--warmup", str(warmup), str(e)]
+		if json:
+			cmd += ["--json", "benchmark_report_" + str(e) + ".json"]
+		subprocess.check_call(cmd)
 
-launchBenchmark(10, 0, 21)
\ No newline at end of file
+parser = argparse.ArgumentParser(description="Launch the voxomap benchmarks, results are appended to benchmark_report.csv")
+parser.add_argument("--binary", default=defaultBinaryPath, help="path of the benchmark executable")
+parser.add_argument("--iterations", type=int, default=10, help="number of recorded runs of each test")
+parser.add_argument("--warmup", type=int, default=1, help="number of runs before the recorded runs")
+parser.add_argument("--min", type=int, default=0, help="first test id")
+parser.add_argument("--max", type=int, default=21, help="last test id")
+parser.add_argument("--json", action="store_true", help="also write a JSON report per test")
+args = parser.parse_args()
+
+launchBenchmark(args.binary, args.iterations, args.min, args.max, args.warmup, args.json)
@@ -3,6 +3,7 @@
 
 #include <array>
 #include <memory>
+#include "../utils/MemoryPool.hpp"
 
 namespace voxomap
 {
@@ -29,11 +30,27 @@ public:
         \brief Copy constructor
     */
     Node(Node const& other);
+    /*!
+        \brief Copies \a other and its children inside the node pool of \a octree
+    */
+    Node(Node const& other, Octree<T_Node>& octree);
     /*!
         \brief Destructor method
     */
     virtual ~Node();
 
+    /*!
+        \brief Allocates a node inside the shared memory pool of the nodes
+        \details Nodes are allocated in slabs and freed nodes are reused,
+        it avoids the fragmentation of the heap with the node churn of edit bursts.
+        The octree allocates its own nodes inside its node pool with Octree::createNode.
+    */
+    static void*            operator new(size_t size);
+    /*!
+        \brief Releases a node allocated with a memory pool, the pool is found from the address
+    */
+    static void             operator delete(void* ptr, size_t size);
+
     /*!
         \brief Returns size of node
     */
@@ -28,6 +28,23 @@ Node<T_Node>::Node(Node const& other)
     }
 }
 
+template <class T_Node>
+Node<T_Node>::Node(Node const& other, Octree<T_Node>& octree)
+    : _octree(&octree), _x(other._x), _y(other._y), _z(other._z), _size(other._size)
+    , _childId(other._childId), _nbChildren(other._nbChildren)
+{
+    std::memset(_children.data(), 0, sizeof(_children));
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        if (other._children[i])
+        {
+            _children[i] = octree.createNode(*other._children[i], octree);
+            _children[i]->_parent = static_cast<T_Node*>(this);
+        }
+    }
+}
+
 template <class T_Node>
 Node<T_Node>::~Node()
 {
@@ -43,6 +60,24 @@ Node<T_Node>::~Node()
     }
 }
 
+template <class T_Node>
+void* Node<T_Node>::operator new(size_t size)
+{
+    // Classes inheriting from T_Node have a different size, they use the default allocator
+    if (size != sizeof(T_Node))
+        return ::operator new(size);
+    return MemoryPool<sizeof(T_Node)>::get().allocate();
+}
+
+template <class T_Node>
+void Node<T_Node>::operator delete(void* ptr, size_t size)
+{
+    if (size != sizeof(T_Node))
+        ::operator delete(ptr);
+    else
+        MemoryPool<sizeof(T_Node)>::deallocate(ptr);
+}
+
 template <class T_Node>
 inline uint32_t Node<T_Node>::getSize() const
 {
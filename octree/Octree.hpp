@@ -2,9 +2,12 @@
 #define _VOXOMAP_OCTREE_HPP_
 
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <typeinfo>
 #include <vector>
 #include <assert.h>
+#include "../utils/MemoryPool.hpp"
 
 namespace voxomap
 {
@@ -17,12 +20,15 @@ namespace voxomap
 /*! \class Octree
     \ingroup Octree
     \brief Octree container
+    \details The octree allocates its nodes inside its own memory pool,
+    so the octrees don't share a lock and clear() releases the slabs at once.
 */
 template <class T_Node>
 class Octree
 {
 public:
     using Node = T_Node;
+    using NodePool = MemoryPool<sizeof(T_Node)>;
 
     /*!
         \brief Default constructor
@@ -37,9 +43,9 @@ public:
     */
     Octree(Octree&& other);
     /*!
-        \brief Default virtual destructor
+        \brief Virtual destructor
     */
-    virtual ~Octree() = default;
+    virtual ~Octree();
     /*!
         \brief Assignement operator
         \param other Right operand
@@ -84,6 +90,18 @@ public:
         \return The root node
     */
     T_Node*         getRootNode() const;
+    /*!
+        \brief Returns the memory pool of the nodes
+    */
+    NodePool const& getNodePool() const;
+
+    /*!
+        \brief Creates a node inside the memory pool of the octree
+        \param args Arguments of the node constructor
+        \return The node, to push into the octree
+    */
+    template <typename... T_Args>
+    T_Node*         createNode(T_Args&&... args);
 
 protected:
     // Node method
@@ -155,7 +173,20 @@ protected:
         \brief Called when \a node is remove from the octree
     */
     virtual void    notifyNodeRemoving(T_Node& node);
+    /*!
+        \brief Returns true if \a node is allocated inside the memory pool of the octree
+    */
+    bool            isPoolNode(T_Node const& node) const;
+    /*!
+        \brief Returns the number of nodes of the subtree allocated inside the memory pool of the octree
+    */
+    size_t          countPoolNodes(T_Node const& node) const;
+    /*!
+        \brief Destroys the subtree, the memory of the nodes inside the memory pool of the octree is not released
+    */
+    void            destroyNodes(T_Node& node);
 
+    std::unique_ptr<NodePool, typename NodePool::Deleter> _nodePool;    //!< Memory pool of the nodes
     std::unique_ptr<T_Node> _rootNode;    //!< Main node of the octree
 };
 
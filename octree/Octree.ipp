@@ -3,46 +3,48 @@ namespace voxomap
 
 template <class T_Node>
 Octree<T_Node>::Octree()
+    : _nodePool(NodePool::create())
 {
     this->clear();
 }
 
 template <class T_Node>
 Octree<T_Node>::Octree(Octree const& other)
+    : _nodePool(NodePool::create())
 {
     if (other._rootNode)
-    {
-        _rootNode.reset(new T_Node(*other._rootNode));
-        _rootNode->changeOctree(*this);
-    }
-    else
-        _rootNode = nullptr;
+        _rootNode.reset(this->createNode(*other._rootNode, *this));
 }
 
 template <class T_Node>
 Octree<T_Node>::Octree(Octree&& other)
-    : _rootNode(std::move(other._rootNode))
+    : _nodePool(std::move(other._nodePool)), _rootNode(std::move(other._rootNode))
 {
+    other._nodePool.reset(NodePool::create());
     if (_rootNode)
         _rootNode->changeOctree(*this);
 }
 
+template <class T_Node>
+Octree<T_Node>::~Octree()
+{
+    this->Octree<T_Node>::clear();
+}
+
 template <class T_Node>
 Octree<T_Node>& Octree<T_Node>::operator=(Octree const& other)
 {
-    if (other._rootNode)
-    {
-        _rootNode.reset(new T_Node(*other._rootNode));
-        _rootNode->changeOctree(*this);
-    }
-    else
-        _rootNode = nullptr;
+    T_Node* rootNode = other._rootNode ? this->createNode(*other._rootNode, *this) : nullptr;
+    this->Octree<T_Node>::clear();
+    _rootNode.reset(rootNode);
     return *this;
 }
 
 template <class T_Node>
 Octree<T_Node>& Octree<T_Node>::operator=(Octree&& other)
 {
+    this->Octree<T_Node>::clear();
+    std::swap(_nodePool, other._nodePool);
     _rootNode = std::move(other._rootNode);
     if (_rootNode)
         _rootNode->changeOctree(*this);
@@ -67,7 +69,16 @@ T_Node* Octree<T_Node>::findNode(int x, int y, int z, uint32_t size) const
 template <class T_Node>
 void Octree<T_Node>::clear()
 {
-    _rootNode = nullptr;
+    if (!_rootNode)
+        return;
+    // When all the nodes of the pool are inside the octree, the slabs are released at once
+    if (this->countPoolNodes(*_rootNode) == _nodePool->getNbUsedBlocks())
+    {
+        this->destroyNodes(*_rootNode.release());
+        _nodePool->releaseAll();
+    }
+    else
+        _rootNode = nullptr;
 }
 
 template <class T_Node>
@@ -76,6 +87,28 @@ T_Node* Octree<T_Node>::getRootNode() const
     return _rootNode.get();
 }
 
+template <class T_Node>
+typename Octree<T_Node>::NodePool const& Octree<T_Node>::getNodePool() const
+{
+    return *_nodePool;
+}
+
+template <class T_Node>
+template <typename... T_Args>
+T_Node* Octree<T_Node>::createNode(T_Args&&... args)
+{
+    void* ptr = _nodePool->allocate();
+    try
+    {
+        return ::new (ptr) T_Node(std::forward<T_Args>(args)...);
+    }
+    catch (...)
+    {
+        NodePool::deallocate(ptr);
+        throw;
+    }
+}
+
 template <class T_Node>
 T_Node* Octree<T_Node>::push(T_Node& node)
 {
@@ -236,7 +269,7 @@ void Octree<T_Node>::insertIntermediateNode(T_Node& child, T_Node& newChild)
         return;
     }
 
-    T_Node* parent = new T_Node(child._x, child._y, child._z, child._size);
+    T_Node* parent = this->createNode(child._x, child._y, child._z, child._size);
     parent->_octree = this;
 
     // If the two nodes have coordinates with different signs
@@ -395,4 +428,43 @@ void Octree<T_Node>::notifyNodeRemoving(T_Node& node)
 {
 }
 
+template <class T_Node>
+inline bool Octree<T_Node>::isPoolNode(T_Node const& node) const
+{
+    // Nodes of a derived class don't come from a pool
+    return typeid(node) == typeid(T_Node) && &NodePool::getPool(&node) == _nodePool.get();
+}
+
+template <class T_Node>
+size_t Octree<T_Node>::countPoolNodes(T_Node const& node) const
+{
+    size_t nb = this->isPoolNode(node) ? 1 : 0;
+    for (auto child : node._children)
+    {
+        if (child)
+            nb += this->countPoolNodes(*child);
+    }
+    return nb;
+}
+
+template <class T_Node>
+void Octree<T_Node>::destroyNodes(T_Node& node)
+{
+    for (auto& child : node._children)
+    {
+        if (child)
+        {
+            child->_parent = nullptr;
+            this->destroyNodes(*child);
+            child = nullptr;
+        }
+    }
+    node._nbChildren = 0;
+
+    if (this->isPoolNode(node))
+        node.~T_Node();
+    else
+        delete &node;
+}
+
 }
\ No newline at end of file
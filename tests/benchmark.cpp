@@ -1,19 +1,31 @@
 #include <iostream>
 #include <chrono>
 #include <map>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <thread>
+#include <functional>
 #include "../voxel_octree/VoxelOctree.hpp"
 #include "../voxel_octree/VoxelContainer/SparseContainer.hpp"
 #include "../voxel_octree/VoxelContainer/ArrayContainer.hpp"
 #include "../voxel_octree/VoxelContainer/SidedContainer.hpp"
+#include "../voxel_octree/VoxelContainer/PaletteContainer.hpp"
 #include "../voxel_octree/SuperContainer/ArraySuperContainer.hpp"
 #include "../voxel_octree/SuperContainer/SparseSuperContainer.hpp"
+#include "../utils/VoxelAccessor.hpp"
 #include "common.hpp"
 
-static const size_t gNbVoxel = 500000;
+static size_t gNbVoxel = 500000;
 static const size_t gContiguousArea = 256;
 static size_t gNbError = 0;
 
+/*!
+    \brief Collects the values of the benchmarks
+    \details Keys starting with "nb_" are parameters of the benchmark (number of voxels, of threads...),
+    the other keys are measures. Each run of a benchmark is a sample, the JSON report gives
+    the median and the percentiles of the samples of each measure.
+*/
 class Report
 {
 public:
@@ -23,12 +35,26 @@ public:
         return instance;
     }
 
+    /*!
+        \brief Values are ignored when recording is disabled, used for warm-up runs
+    */
+    void setRecording(bool recording)
+    {
+        _recording = recording;
+    }
+
     template <typename ...Args>
     void addValues(std::string const& benchName, std::string const& className, Args&&... args)
     {
+        if (!_recording)
+            return;
+
         _lines.emplace_back(benchName);
         _lines.back().append(";");
         _lines.back().append(className);
+        _entries.emplace_back();
+        _entries.back().benchName = benchName;
+        _entries.back().className = className;
         this->_addValues(std::forward<Args>(args)...);
     }
 
@@ -45,7 +71,103 @@ public:
         }
     }
 
+    /*!
+        \brief Write the statistics of each measure, grouped by benchmark, container type and parameters
+        \param path Path of the JSON file
+        \param repetitions Number of recorded runs
+        \param warmup Number of warm-up runs
+    */
+    void writeJSON(std::string const& path, size_t repetitions, size_t warmup)
+    {
+        std::ofstream file(path.c_str(), std::ios_base::out | std::ios_base::trunc);
+        if (!file)
+            return;
+        file.precision(12);
+
+        // Group samples of the same benchmark, container type and parameters, in insertion order
+        std::vector<std::string> groupOrder;
+        std::map<std::string, std::pair<Entry const*, std::map<std::string, std::vector<double>>>> groups;
+        std::map<std::string, std::vector<std::string>> metricOrder;
+        for (auto const& entry : _entries)
+        {
+            std::string key = entry.benchName + ";" + entry.className;
+            for (auto const& param : entry.params)
+                key += ";" + param.first + "=" + param.second;
+
+            auto it = groups.find(key);
+            if (it == groups.end())
+            {
+                groupOrder.push_back(key);
+                it = groups.emplace(key, std::make_pair(&entry, std::map<std::string, std::vector<double>>())).first;
+            }
+            for (auto const& metric : entry.metrics)
+            {
+                auto& samples = it->second.second[metric.first];
+                if (samples.empty())
+                    metricOrder[key].push_back(metric.first);
+                samples.push_back(metric.second);
+            }
+        }
+
+        file << "{\n";
+        file << "  \"repetitions\": " << repetitions << ",\n";
+        file << "  \"warmup\": " << warmup << ",\n";
+        file << "  \"results\": [";
+        for (size_t i = 0; i < groupOrder.size(); ++i)
+        {
+            auto const& group = groups[groupOrder[i]];
+            Entry const& entry = *group.first;
+
+            file << (i ? "," : "") << "\n    {\n";
+            file << "      \"benchmark\": \"" << entry.benchName << "\",\n";
+            file << "      \"container\": \"" << entry.className << "\",\n";
+            file << "      \"parameters\": {";
+            for (size_t p = 0; p < entry.params.size(); ++p)
+                file << (p ? ", " : "") << "\"" << entry.params[p].first << "\": " << entry.params[p].second;
+            file << "},\n";
+            file << "      \"measures\": {";
+            auto const& metrics = metricOrder[groupOrder[i]];
+            for (size_t m = 0; m < metrics.size(); ++m)
+            {
+                std::vector<double> samples = group.second.at(metrics[m]);
+                std::sort(samples.begin(), samples.end());
+                file << (m ? "," : "") << "\n        \"" << metrics[m] << "\": {";
+                file << "\"median\": " << percentile(samples, 50);
+                file << ", \"p10\": " << percentile(samples, 10);
+                file << ", \"p90\": " << percentile(samples, 90);
+                file << ", \"min\": " << samples.front();
+                file << ", \"max\": " << samples.back();
+                file << ", \"samples\": [";
+                for (size_t v = 0; v < samples.size(); ++v)
+                    file << (v ? ", " : "") << samples[v];
+                file << "]}";
+            }
+            file << "\n      }\n    }";
+        }
+        file << "\n  ]\n}\n";
+    }
+
 private:
+    struct Entry
+    {
+        std::string benchName;
+        std::string className;
+        std::vector<std::pair<std::string, std::string>> params;
+        std::vector<std::pair<std::string, double>> metrics;
+    };
+
+    /*!
+        \brief Percentile with linear interpolation between the closest ranks, \a samples must be sorted
+    */
+    static double percentile(std::vector<double> const& samples, double percent)
+    {
+        double rank = percent / 100.0 * (samples.size() - 1);
+        size_t index = static_cast<size_t>(rank);
+        if (index + 1 >= samples.size())
+            return samples.back();
+        return samples[index] + (rank - index) * (samples[index + 1] - samples[index]);
+    }
+
     template <typename Value, typename... Args>
     void _addValues(char const* key, Value&& value, Args&&... args)
     {
@@ -64,6 +186,8 @@ private:
     }
 
     std::vector<std::string> _lines;
+    std::vector<Entry> _entries;
+    bool _recording = true;
 };
 
 template <>
@@ -73,6 +197,11 @@ void Report::addValue(char const* key, std::string value)
     _lines.back().append(key);
     _lines.back().append("=");
     _lines.back().append(value);
+
+    if (std::string(key).compare(0, 3, "nb_") == 0)
+        _entries.back().params.emplace_back(key, value);
+    else
+        _entries.back().metrics.emplace_back(key, std::stod(value));
 }
 
 /*!
@@ -96,6 +225,7 @@ bool bench_random()
     }
     auto t2 = std::chrono::high_resolution_clock::now();
     auto memoryUsed = voxomap::test::computeMemoryUsed();
+    auto memoryUsage = octree.memoryUsage();
 
     size_t read_nb_error = 0;
     for (size_t i = 0; i < voxomap::test::gTestValues.size(); ++i)
@@ -166,6 +296,11 @@ bool bench_random()
     std::cout << "Remove " << gNbVoxel << " voxels in " << rm_time << "ms, " << int(gNbVoxel / float(rm_time / 1000.f)) << " voxels/s." << std::endl;
     std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t5 - t1).count()) << "ms." << std::endl;
     std::cout << "Total memory used " << memory << "MB" << std::endl;
+    std::cout << "Octree memory usage " << memoryUsage.total() / 1024 / 1024 << "MB (nodes " << memoryUsage.nodes / 1024 / 1024
+              << "MB, super containers " << memoryUsage.superContainers / 1024 / 1024
+              << "MB, voxel containers " << memoryUsage.voxelContainers / 1024 / 1024
+              << "MB, id tables " << memoryUsage.idTables / 1024 / 1024
+              << "MB, pool free memory " << memoryUsage.poolFreeMemory / 1024 / 1024 << "MB)" << std::endl;
     std::cout << std::endl;
 
     Report::get().addValues("random", className,
@@ -175,6 +310,7 @@ bool bench_random()
         "iterator", int(gNbVoxel / float(it_time / 1000.f)),
         "update", int(gNbVoxel / float(update_time / 1000.f)),
         "memory", memory,
+        "octree_memory", memoryUsage.total() / 1024 / 1024,
         "nb_voxel", std::to_string(gNbVoxel)
     );
 
@@ -212,6 +348,7 @@ bool bench_contiguous()
     }
     auto t2 = std::chrono::high_resolution_clock::now();
     auto memoryUsed = voxomap::test::computeMemoryUsed();
+    auto memoryUsage = octree.memoryUsage();
 
     size_t read_nb_error = 0;
     for (auto const& data : testValues)
@@ -279,6 +416,11 @@ bool bench_contiguous()
     std::cout << "Remove " << testValues.size() << " voxels in " << rm_time << "ms, " << int(testValues.size() / float(rm_time / 1000.f)) << " voxels/s." << std::endl;
     std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t5 - t1).count()) << "ms." << std::endl;
     std::cout << "Total memory used " << memory << "MB" << std::endl;
+    std::cout << "Octree memory usage " << memoryUsage.total() / 1024 / 1024 << "MB (nodes " << memoryUsage.nodes / 1024 / 1024
+              << "MB, super containers " << memoryUsage.superContainers / 1024 / 1024
+              << "MB, voxel containers " << memoryUsage.voxelContainers / 1024 / 1024
+              << "MB, id tables " << memoryUsage.idTables / 1024 / 1024
+              << "MB, pool free memory " << memoryUsage.poolFreeMemory / 1024 / 1024 << "MB)" << std::endl;
     std::cout << std::endl;
 
     Report::get().addValues("contiguous", className,
@@ -288,12 +430,292 @@ bool bench_contiguous()
         "iterator", int(testValues.size() / float(it_time / 1000.f)),
         "update", int(testValues.size() / float(update_time / 1000.f)),
         "memory", memory,
+        "octree_memory", memoryUsage.total() / 1024 / 1024,
         "nb_voxel", testValues.size()
     );
 
     return read_nb_error == 0 && rm_nb_error == 0 && update_nb_error == 0 && it_count == testValues.size();
 }
 
+template <typename T_Container>
+bool bench_parallel_read()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::string className = voxomap::test::type_name<T_Container>();
+    std::cout << "Launch bench_parallel_read (" << className << "):" << std::endl;
+
+    voxomap::VoxelOctree<T_Container> octree;
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+    voxomap::VoxelOctree<T_Container> const& const_octree = octree;
+
+    size_t read_nb_error = 0;
+    size_t max_nb_thread = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    for (size_t nb_thread = 1; nb_thread <= max_nb_thread; nb_thread *= 2)
+    {
+        std::vector<size_t> nb_errors(nb_thread, 0);
+        std::vector<std::thread> threads;
+
+        auto t1 = std::chrono::high_resolution_clock::now();
+        for (size_t thread_id = 0; thread_id < nb_thread; ++thread_id)
+        {
+            // Each thread reads all voxels, starting at a different offset
+            threads.emplace_back([&const_octree, &nb_errors, thread_id, nb_thread]() {
+                voxomap::VoxelNode<T_Container> const* hint = nullptr;
+                size_t nb_value = voxomap::test::gTestValues.size();
+                for (size_t i = 0; i < nb_value; ++i)
+                {
+                    auto const& data = voxomap::test::gTestValues[(i + thread_id * nb_value / nb_thread) % nb_value];
+                    auto it = const_octree.findVoxel(data.x, data.y, data.z, hint);
+                    if (!it)
+                        ++nb_errors[thread_id];
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        auto t2 = std::chrono::high_resolution_clock::now();
+
+        for (size_t error : nb_errors)
+            read_nb_error += error;
+        double read_time = std::chrono::duration<double>(t2 - t1).count();
+        int rate = int(gNbVoxel * nb_thread / read_time);
+        std::cout << "Read " << gNbVoxel * nb_thread << " voxels with " << nb_thread << " threads in " << int(read_time * 1000) << "ms, " << rate << " voxels/s." << std::endl;
+        Report::get().addValues("parallel_read", className,
+            "nb_thread", nb_thread,
+            "read", rate,
+            "nb_voxel", gNbVoxel
+        );
+    }
+
+    if (read_nb_error == 0)
+        std::cout << "No read error detected" << std::endl;
+    else
+        std::cout << "Error: " << read_nb_error << " read errors detected" << std::endl;
+    std::cout << std::endl;
+
+    return read_nb_error == 0;
+}
+
+template <typename T_Container>
+bool bench_leaf_index()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::string className = voxomap::test::type_name<T_Container>();
+    std::cout << "Launch bench_leaf_index (" << className << "):" << std::endl;
+
+    voxomap::VoxelOctree<T_Container> octree;
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+
+    size_t read_nb_error = 0;
+    auto read = [&octree, &read_nb_error]() {
+        auto t1 = std::chrono::high_resolution_clock::now();
+        for (auto const& data : voxomap::test::gTestValues)
+        {
+            if (!octree.findVoxel(data.x, data.y, data.z))
+                ++read_nb_error;
+        }
+        auto t2 = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(t2 - t1).count();
+    };
+
+    double read_time = read();
+    octree.enableLeafIndex();
+    double indexed_read_time = read();
+
+    int rate = int(gNbVoxel / read_time);
+    int indexed_rate = int(gNbVoxel / indexed_read_time);
+    std::cout << "Read " << gNbVoxel << " voxels in " << int(read_time * 1000) << "ms, " << rate << " voxels/s." << std::endl;
+    std::cout << "Read " << gNbVoxel << " voxels with the leaf index in " << int(indexed_read_time * 1000) << "ms, " << indexed_rate << " voxels/s." << std::endl;
+    std::cout << "Leaf index memory " << octree.memoryUsage().leafIndex / 1024 << "KB" << std::endl;
+    Report::get().addValues("leaf_index", className,
+        "read", rate,
+        "read_indexed", indexed_rate,
+        "nb_voxel", gNbVoxel
+    );
+
+    if (read_nb_error == 0)
+        std::cout << "No read error detected" << std::endl;
+    else
+        std::cout << "Error: " << read_nb_error << " read errors detected" << std::endl;
+    std::cout << std::endl;
+
+    return read_nb_error == 0;
+}
+
+template <typename T_Container>
+bool bench_accessor()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::string className = voxomap::test::type_name<T_Container>();
+    std::cout << "Launch bench_accessor (" << className << "):" << std::endl;
+
+    voxomap::VoxelOctree<T_Container> octree;
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+
+    // Reads the 3x3x3 neighborhood of each voxel, like a physics or an editing tool,
+    // then sweeps lines of voxels, each line crosses several voxel containers and leaves
+    const int line_size = 64;
+    size_t nb_found = 0;
+    auto read = [&nb_found, line_size](std::function<bool(int, int, int)> const& findVoxel) {
+        auto t1 = std::chrono::high_resolution_clock::now();
+        for (auto const& data : voxomap::test::gTestValues)
+        {
+            for (int x = -1; x <= 1; ++x)
+                for (int y = -1; y <= 1; ++y)
+                    for (int z = -1; z <= 1; ++z)
+                        nb_found += findVoxel(data.x + x, data.y + y, data.z + z);
+            for (int x = 0; x < line_size; ++x)
+                nb_found += findVoxel(data.x + x, data.y, data.z);
+        }
+        auto t2 = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(t2 - t1).count();
+    };
+
+    double octree_time = read([&octree](int x, int y, int z) { return bool(octree.findVoxel(x, y, z)); });
+    size_t octree_nb_found = nb_found;
+    nb_found = 0;
+    voxomap::VoxelAccessor<T_Container> accessor(octree);
+    double accessor_time = read([&accessor](int x, int y, int z) { return bool(accessor.findVoxel(x, y, z)); });
+
+    size_t nb_read = gNbVoxel * (27 + line_size);
+    int rate = int(nb_read / octree_time);
+    int accessor_rate = int(nb_read / accessor_time);
+    std::cout << "Read " << nb_read << " voxels in " << int(octree_time * 1000) << "ms, " << rate << " voxels/s." << std::endl;
+    std::cout << "Read " << nb_read << " voxels with an accessor in " << int(accessor_time * 1000) << "ms, " << accessor_rate << " voxels/s." << std::endl;
+    Report::get().addValues("accessor", className,
+        "read", rate,
+        "read_accessor", accessor_rate,
+        "nb_voxel", gNbVoxel
+    );
+
+    bool success = nb_found == octree_nb_found;
+    if (success)
+        std::cout << "No read error detected" << std::endl;
+    else
+        std::cout << "Error: " << "accessor found " << nb_found << " voxels instead of " << octree_nb_found << std::endl;
+    std::cout << std::endl;
+
+    return success;
+}
+
+template <typename T_Container>
+bool bench_parallel_explore()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::string className = voxomap::test::type_name<T_Container>();
+    std::cout << "Launch bench_parallel_explore (" << className << "):" << std::endl;
+
+    voxomap::VoxelOctree<T_Container> octree;
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+
+    auto sum_predicate = [](typename T_Container::iterator const& it, int64_t& sum) { sum += it.voxel->value; };
+    auto sum_reduce = [](int64_t& sum, int64_t task_sum) { sum += task_sum; };
+
+    int64_t sum = 0;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    octree.exploreVoxel([&sum, &sum_predicate](typename T_Container::iterator const& it) { sum_predicate(it, sum); });
+    auto t2 = std::chrono::high_resolution_clock::now();
+    double serial_time = std::chrono::duration<double>(t2 - t1).count();
+    std::cout << "Explore " << gNbVoxel << " voxels in " << int(serial_time * 1000) << "ms." << std::endl;
+
+    size_t explore_nb_error = 0;
+    size_t max_nb_thread = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    for (size_t nb_thread = 1; nb_thread <= max_nb_thread; nb_thread *= 2)
+    {
+        voxomap::ThreadPool pool(static_cast<unsigned int>(nb_thread));
+        t1 = std::chrono::high_resolution_clock::now();
+        int64_t parallel_sum = octree.parallelExploreVoxel(pool, int64_t(0), sum_predicate, sum_reduce);
+        t2 = std::chrono::high_resolution_clock::now();
+
+        if (parallel_sum != sum)
+            ++explore_nb_error;
+        double explore_time = std::chrono::duration<double>(t2 - t1).count();
+        int rate = int(gNbVoxel / explore_time);
+        std::cout << "Explore " << gNbVoxel << " voxels with " << nb_thread << " threads in " << int(explore_time * 1000) << "ms, " << rate << " voxels/s." << std::endl;
+        Report::get().addValues("parallel_explore", className,
+            "nb_thread", nb_thread,
+            "explore", rate,
+            "nb_voxel", gNbVoxel
+        );
+    }
+
+    if (explore_nb_error == 0)
+        std::cout << "No explore error detected" << std::endl;
+    else
+        std::cout << "Error: " << explore_nb_error << " explore errors detected" << std::endl;
+    std::cout << std::endl;
+
+    return explore_nb_error == 0;
+}
+
+template <typename T_Container>
+bool bench_parallel_write()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::string className = voxomap::test::type_name<T_Container>();
+    std::cout << "Launch bench_parallel_write (" << className << "):" << std::endl;
+
+    // Each thread fills, copies and clears its own octree, the nodes come from the pool of the octree
+    // and the voxel containers from the shared pool of their size
+    size_t write_nb_error = 0;
+    size_t max_nb_thread = std::max<size_t>(std::thread::hardware_concurrency(), 4);
+    for (size_t nb_thread = 1; nb_thread <= max_nb_thread; nb_thread *= 2)
+    {
+        size_t nb_value = voxomap::test::gTestValues.size() / nb_thread;
+        std::vector<size_t> nb_errors(nb_thread, 0);
+        std::vector<std::thread> threads;
+
+        auto t1 = std::chrono::high_resolution_clock::now();
+        for (size_t thread_id = 0; thread_id < nb_thread; ++thread_id)
+        {
+            threads.emplace_back([&nb_errors, thread_id, nb_value]() {
+                voxomap::VoxelOctree<T_Container> octree;
+                for (size_t i = thread_id * nb_value; i < (thread_id + 1) * nb_value; ++i)
+                {
+                    auto const& data = voxomap::test::gTestValues[i];
+                    octree.putVoxel(data.x, data.y, data.z, data.value);
+                }
+                voxomap::VoxelOctree<T_Container> octree_copy(octree);
+                if (octree_copy.getNbVoxels() != octree.getNbVoxels())
+                    ++nb_errors[thread_id];
+                octree_copy.clear();
+                octree.clear();
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        auto t2 = std::chrono::high_resolution_clock::now();
+
+        for (size_t error : nb_errors)
+            write_nb_error += error;
+        double write_time = std::chrono::duration<double>(t2 - t1).count();
+        int rate = int(nb_value * nb_thread / write_time);
+        std::cout << "Write, copy and clear " << nb_value * nb_thread << " voxels with " << nb_thread << " threads in " << int(write_time * 1000) << "ms, " << rate << " voxels/s." << std::endl;
+        Report::get().addValues("parallel_write", className,
+            "nb_thread", nb_thread,
+            "write", rate,
+            "nb_voxel", gNbVoxel
+        );
+    }
+
+    if (write_nb_error == 0)
+        std::cout << "No write error detected" << std::endl;
+    else
+        std::cout << "Error: " << write_nb_error << " write errors detected" << std::endl;
+    std::cout << std::endl;
+
+    return write_nb_error == 0;
+}
+
 static bool g_error = false;
 
 template <typename T_Container>
@@ -302,6 +724,11 @@ void launchBenchmark()
     std::cout << "------- BENCHMARK " << voxomap::test::type_name<T_Container>() << " -------\n\n";
     g_error |= !bench_random<T_Container>();
     g_error |= !bench_contiguous<T_Container>();
+    g_error |= !bench_parallel_read<T_Container>();
+    g_error |= !bench_parallel_write<T_Container>();
+    g_error |= !bench_leaf_index<T_Container>();
+    g_error |= !bench_accessor<T_Container>();
+    g_error |= !bench_parallel_explore<T_Container>();
     std::cout << "------- END -------\n\n\n";
 }
 
@@ -324,17 +751,43 @@ struct Test : public ATest
 
 void usage(char const* name, std::vector<std::unique_ptr<ATest>> const& tests)
 {
-    std::cout << "Usage: " << name << " [TEST_ID]" << std::endl;
+    std::cout << "Usage: " << name << " [OPTIONS] [TEST_ID]" << std::endl;
     std::cout << "Voxomap benchmark utility." << std::endl;
     std::cout << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --repetitions N   Number of recorded runs of each test (default 1)" << std::endl;
+    std::cout << "  --warmup N        Number of runs before the recorded runs, ignored in the reports (default 0)" << std::endl;
+    std::cout << "  --voxels N        Number of voxels used by the benchmarks (default " << gNbVoxel << ")" << std::endl;
+    std::cout << "  --csv PATH        CSV report, values are appended (default benchmark_report.csv)" << std::endl;
+    std::cout << "  --json PATH       JSON report with the median and percentiles of each measure" << std::endl;
+    std::cout << std::endl;
     std::cout << "List of tests:" << std::endl;
-    int i = 0;
-    for (int i = 0; i < tests.size(); ++i)
+    for (size_t i = 0; i < tests.size(); ++i)
     {
         std::cout << "  - [" << i << "] " << tests[i]->getTestName() << std::endl;
     }
 }
 
+/*!
+    \brief Parses the unsigned integer \a str, returns false if it isn't valid
+*/
+static bool parseSize(char const* str, size_t& value)
+{
+    try
+    {
+        size_t pos = 0;
+        long long result = std::stoll(str, &pos);
+        if (str[pos] != '\0' || result < 0)
+            return false;
+        value = static_cast<size_t>(result);
+        return true;
+    }
+    catch (std::exception const&)
+    {
+        return false;
+    }
+}
+
 int main(int argc, char* argv[])
 {
     std::vector<std::unique_ptr<ATest>> tests;
@@ -342,6 +795,7 @@ int main(int argc, char* argv[])
     // No super container
     tests.emplace_back(new Test<voxomap::ArrayContainer<voxel>>());
     tests.emplace_back(new Test<voxomap::SparseContainer<voxel>>());
+    tests.emplace_back(new Test<voxomap::PaletteContainer<voxel>>());
     // Sided
     tests.emplace_back(new Test<voxomap::SidedContainer<voxomap::ArrayContainer, voxel>>());
     tests.emplace_back(new Test<voxomap::SidedContainer<SparseContainer, voxel>>());
@@ -370,33 +824,59 @@ int main(int argc, char* argv[])
     tests.emplace_back(new Test<voxomap::SparseSuperContainer<voxomap::ArraySuperContainer<voxomap::SidedContainer<SparseContainer, voxel>>>>());
     tests.emplace_back(new Test<voxomap::SparseSuperContainer<voxomap::SparseSuperContainer<voxomap::SidedContainer<SparseContainer, voxel>>>>());
 
-    if (argc == 1)
-    {
-        for (auto const& test : tests)
-        {
-            test->call();
-        }
-    }
-    else if (argc > 1)
+    size_t repetitions = 1;
+    size_t warmup = 0;
+    std::string csvPath = "benchmark_report.csv";
+    std::string jsonPath;
+    std::vector<size_t> ids;
+    for (int i = 1; i < argc; ++i)
     {
-        try
+        std::string arg = argv[i];
+        bool valid = true;
+        if (arg == "--repetitions" && i + 1 < argc)
+            valid = parseSize(argv[++i], repetitions) && repetitions > 0;
+        else if (arg == "--warmup" && i + 1 < argc)
+            valid = parseSize(argv[++i], warmup);
+        else if (arg == "--voxels" && i + 1 < argc)
+            valid = parseSize(argv[++i], gNbVoxel) && gNbVoxel > 0;
+        else if (arg == "--csv" && i + 1 < argc)
+            csvPath = argv[++i];
+        else if (arg == "--json" && i + 1 < argc)
+            jsonPath = argv[++i];
+        else
         {
-            int id = std::stoi(argv[1]);
-            if (id >= tests.size() || id < 0)
-            {
-                usage(argv[0], tests);
-                exit(-1);
-            }
-            tests[id]->call();
+            size_t id;
+            valid = parseSize(argv[i], id) && id < tests.size();
+            if (valid)
+                ids.push_back(id);
         }
-        catch (std::invalid_argument const&)
+
+        if (!valid)
         {
             usage(argv[0], tests);
             exit(-1);
         }
     }
 
-    Report::get().writeCSV("benchmark_report.csv");
+    if (ids.empty())
+    {
+        for (size_t id = 0; id < tests.size(); ++id)
+            ids.push_back(id);
+    }
+
+    for (size_t id : ids)
+    {
+        Report::get().setRecording(false);
+        for (size_t i = 0; i < warmup; ++i)
+            tests[id]->call();
+        Report::get().setRecording(true);
+        for (size_t i = 0; i < repetitions; ++i)
+            tests[id]->call();
+    }
+
+    Report::get().writeCSV(csvPath);
+    if (!jsonPath.empty())
+        Report::get().writeJSON(jsonPath, repetitions, warmup);
 
     std::cout << "------ FINAL RESULT: ";
     if (g_error)
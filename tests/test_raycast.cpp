@@ -1,9 +1,12 @@
 #include <iostream>
 #include <chrono>
+#include <thread>
+#include <vector>
 #include "../voxel_octree/VoxelOctree.hpp"
 #include "../voxel_octree/VoxelContainer/SparseContainer.hpp"
 #include "../voxel_octree/VoxelContainer/ArrayContainer.hpp"
 #include "../voxel_octree/VoxelContainer/SidedContainer.hpp"
+#include "../voxel_octree/VoxelContainer/PaletteContainer.hpp"
 #include "../voxel_octree/SuperContainer/ArraySuperContainer.hpp"
 #include "../voxel_octree/SuperContainer/SparseSuperContainer.hpp"
 #include "../utils/Raycast.hpp"
@@ -69,6 +72,261 @@ bool test_raycasting()
     return nb_raycasting_error == 0;
 }
 
+template <typename T_Container>
+bool test_frozen_raycasting()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_frozen_raycasting (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+    voxomap::VoxelOctree<T_Container> octree;
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+    auto frozen_octree = octree.freeze();
+
+    size_t nb_raycasting_error = 0;
+    voxomap::Ray ray;
+    ray.setOrigin({ 0.0, 0.0, 0.0 });
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (auto const& data : voxomap::test::gTestValues)
+    {
+        ray.setDirection({ double(data.x) + 0.5, double(data.y) + 0.5, double(data.z) + 0.5 });
+        auto result = voxomap::Raycast<T_Container>::get(ray, octree);
+        auto frozen_result = voxomap::Raycast<T_Container>::get(ray, frozen_octree);
+
+        if (result.distance != frozen_result.distance || result.side != frozen_result.side)
+            ++nb_raycasting_error;
+        else if (result.distance != -1 && result.it.voxel->value != frozen_result.it.voxel->value)
+            ++nb_raycasting_error;
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    if (nb_raycasting_error == 0)
+        std::cout << "No error detected" << std::endl;
+    else
+        std::cout << "Error: there is " << nb_raycasting_error << " frozen raycasting errors." << std::endl;
+
+    std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_raycasting_error == 0;
+}
+
+template <typename T_Container>
+bool test_packet_raycasting()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_packet_raycasting (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+    voxomap::VoxelOctree<T_Container> octree;
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+
+    // Rays from two sources toward the voxels, grouped by packets of the same octant by the batch raycast
+    std::vector<voxomap::Ray> rays;
+    for (auto const& data : voxomap::test::gTestValues)
+    {
+        rays.push_back(voxomap::Ray::getRay({ 0.0, 0.0, 0.0 }, { double(data.x) + 0.5, double(data.y) + 0.5, double(data.z) + 0.5 }));
+        if (rays.size() % 4 == 0)
+            rays.push_back(voxomap::Ray::getRay({ 500.5, 500.5, 500.5 }, { double(data.x) + 0.5, double(data.y) + 0.5, double(data.z) + 0.5 }));
+    }
+
+    std::vector<typename voxomap::Raycast<T_Container>::Result> results(rays.size());
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < rays.size(); ++i)
+        results[i] = voxomap::Raycast<T_Container>::get(rays[i], octree);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::vector<typename voxomap::Raycast<T_Container>::Result> packet_results(rays.size());
+    voxomap::Raycast<T_Container>::get(rays.data(), rays.size(), octree, packet_results.data());
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    size_t nb_raycasting_error = 0;
+    for (size_t i = 0; i < rays.size(); ++i)
+    {
+        auto const& result = results[i];
+        auto const& packet_result = packet_results[i];
+        if (result.distance != packet_result.distance || result.side != packet_result.side)
+            ++nb_raycasting_error;
+        else if (result.distance != -1 && result.it.voxel != packet_result.it.voxel)
+            ++nb_raycasting_error;
+    }
+
+    if (nb_raycasting_error == 0)
+        std::cout << "No error detected" << std::endl;
+    else
+        std::cout << "Error: there is " << nb_raycasting_error << " packet raycasting errors." << std::endl;
+
+    std::cout << "Single raycast time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << "Packet raycast time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_raycasting_error == 0;
+}
+
+template <typename T_Container>
+bool test_shared_cache_raycasting()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_shared_cache_raycasting (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+    voxomap::VoxelOctree<T_Container> octree;
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+
+    typename voxomap::Raycast<T_Container>::Cache cache;
+    cache.fillCache(octree);
+    typename voxomap::Raycast<T_Container>::Cache const& shared_cache = cache;
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    // The threads cast the rays with the same read-only cache
+    const size_t nb_thread = 4;
+    std::vector<size_t> nb_errors(nb_thread, 0);
+    std::vector<std::thread> threads;
+    for (size_t thread_id = 0; thread_id < nb_thread; ++thread_id)
+    {
+        threads.emplace_back([&octree, &shared_cache, &nb_errors, thread_id, nb_thread]() {
+            voxomap::Ray ray;
+            ray.setOrigin({ 0.0, 0.0, 0.0 });
+            for (size_t i = thread_id; i < voxomap::test::gTestValues.size(); i += nb_thread)
+            {
+                auto const& data = voxomap::test::gTestValues[i];
+                ray.setDirection({ double(data.x) + 0.5, double(data.y) + 0.5, double(data.z) + 0.5 });
+                auto result = voxomap::Raycast<T_Container>::get(ray, octree);
+                auto cache_result = voxomap::Raycast<T_Container>::get(ray, octree, shared_cache);
+
+                if (result.distance != cache_result.distance || result.side != cache_result.side)
+                    ++nb_errors[thread_id];
+                else if (result.distance != -1 && result.it.voxel != cache_result.it.voxel)
+                    ++nb_errors[thread_id];
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    size_t nb_raycasting_error = 0;
+    for (size_t nb_error : nb_errors)
+        nb_raycasting_error += nb_error;
+
+    if (nb_raycasting_error == 0)
+        std::cout << "No error detected" << std::endl;
+    else
+        std::cout << "Error: there is " << nb_raycasting_error << " shared cache raycasting errors." << std::endl;
+
+    std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_raycasting_error == 0;
+}
+
+template <typename T_Container>
+bool test_subscribed_cache_raycasting()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_subscribed_cache_raycasting (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+    // The octree is destroyed before the cache, the cache must be detached from it
+    typename voxomap::Raycast<T_Container>::Cache cache;
+    voxomap::VoxelOctree<T_Container> octree;
+    for (size_t i = 0; i < voxomap::test::gTestValues.size(); i += 2)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+    }
+    cache.subscribe(octree);
+
+    // Edits after the subscription: new voxels, removed voxels and removed containers
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 1; i < voxomap::test::gTestValues.size(); i += 2)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+    }
+    for (size_t i = 0; i < voxomap::test::gTestValues.size(); i += 3)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        octree.removeVoxel(data.x, data.y, data.z);
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    size_t nb_raycasting_error = 0;
+    voxomap::Ray ray;
+    ray.setOrigin({ 0.0, 0.0, 0.0 });
+    for (size_t i = 0; i < voxomap::test::gTestValues.size(); ++i)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        ray.setDirection({ double(data.x) + 0.5, double(data.y) + 0.5, double(data.z) + 0.5 });
+        auto result = voxomap::Raycast<T_Container>::get(ray, octree);
+        auto cache_result = voxomap::Raycast<T_Container>::get(ray, octree, cache);
+
+        if (result.distance != cache_result.distance || result.side != cache_result.side)
+            ++nb_raycasting_error;
+        else if (result.distance != -1 && result.it.voxel != cache_result.it.voxel)
+            ++nb_raycasting_error;
+    }
+
+    if (nb_raycasting_error == 0)
+        std::cout << "No error detected" << std::endl;
+    else
+        std::cout << "Error: there is " << nb_raycasting_error << " subscribed cache raycasting errors." << std::endl;
+
+    std::cout << "Edit time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_raycasting_error == 0;
+}
+
+template <typename T_Container>
+bool test_predicate_raycasting()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_predicate_raycasting (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+    voxomap::VoxelOctree<T_Container> octree;
+    for (size_t i = 0; i < voxomap::test::gTestValues.size(); ++i)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+    }
+
+    // Only the odd values stop the rays
+    auto lambda = [](typename T_Container::iterator const& it) -> bool {
+        return it.voxel->value % 2 != 0;
+    };
+    typename voxomap::Raycast<T_Container>::Predicate function = lambda;
+    typename voxomap::Raycast<T_Container>::Predicate empty_function;
+
+    size_t nb_raycasting_error = 0;
+    voxomap::Ray ray;
+    ray.setOrigin({ 0.0, 0.0, 0.0 });
+    for (size_t i = 0; i < voxomap::test::gTestValues.size(); ++i)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        ray.setDirection({ double(data.x) + 0.5, double(data.y) + 0.5, double(data.z) + 0.5 });
+        auto lambda_result = voxomap::Raycast<T_Container>::get(ray, octree, lambda);
+        auto function_result = voxomap::Raycast<T_Container>::get(ray, octree, function);
+        if (lambda_result.distance != function_result.distance || lambda_result.side != function_result.side)
+            ++nb_raycasting_error;
+        else if (lambda_result.distance != -1 && (lambda_result.it.voxel != function_result.it.voxel || !lambda(lambda_result.it)))
+            ++nb_raycasting_error;
+
+        // An empty function accepts all the voxels
+        auto result = voxomap::Raycast<T_Container>::get(ray, octree);
+        auto empty_result = voxomap::Raycast<T_Container>::get(ray, octree, empty_function);
+        if (result.distance != empty_result.distance || result.it.voxel != empty_result.it.voxel)
+            ++nb_raycasting_error;
+    }
+
+    if (nb_raycasting_error == 0)
+        std::cout << "No error detected" << std::endl;
+    else
+        std::cout << "Error: there is " << nb_raycasting_error << " predicate raycasting errors." << std::endl;
+
+    std::cout << std::endl;
+
+    return nb_raycasting_error == 0;
+}
+
 template <typename T_Container>
 bool benchmark_raycasting()
 {
@@ -155,6 +413,9 @@ bool benchmark_raycasting_with_cache()
     int cache_construction_time = static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count());
     int raycast_time = static_cast<int>(std::chrono::duration<double, std::milli>(t4 - t3).count());
     std::cout << "Cache construction time: " << cache_construction_time << "ms." << std::endl;
+    voxomap::MemoryUsage cache_usage;
+    cache.memoryUsage(cache_usage);
+    std::cout << "Cache memory usage: " << cache_usage.raycastCaches / 1024 << "KB." << std::endl;
     std::cout << "Raycast time: " << raycast_time << "ms. , " << (voxomap::test::gTestValues.size() / (float(raycast_time) / 1000.f)) << " raycast/s" << std::endl;
     std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t4 - t1).count()) << "ms." << std::endl;
     std::cout << std::endl;
@@ -169,6 +430,11 @@ void launchTest()
 {
     std::cout << "------- TEST " << voxomap::test::type_name<T_Container>() << " -------\n\n";
     g_error |= !test_raycasting<T_Container>();
+    g_error |= !test_frozen_raycasting<T_Container>();
+    g_error |= !test_packet_raycasting<T_Container>();
+    g_error |= !test_shared_cache_raycasting<T_Container>();
+    g_error |= !test_subscribed_cache_raycasting<T_Container>();
+    g_error |= !test_predicate_raycasting<T_Container>();
     g_error |= !benchmark_raycasting<T_Container>();
     g_error |= !benchmark_raycasting_with_cache<T_Container>();
     std::cout << "------- END -------\n\n\n";
@@ -185,12 +451,14 @@ int main(int argc, char* argv[])
     launchTest<voxomap::ArrayContainer<voxel>>();
     launchTest<voxomap::SidedContainer<SparseContainer, voxel>>();
     launchTest<voxomap::SidedContainer<voxomap::ArrayContainer, voxel>>();
+    launchTest<voxomap::PaletteContainer<voxel>>();
 
     // One super container
     launchTest<voxomap::SparseSuperContainer<voxomap::SparseContainer<voxel>>>();
     launchTest<voxomap::ArraySuperContainer<voxomap::ArrayContainer<voxel>>>();
     launchTest<voxomap::SparseSuperContainer<voxomap::SidedContainer<SparseContainer, voxel>>>();
     launchTest<voxomap::ArraySuperContainer<voxomap::SidedContainer<voxomap::ArrayContainer, voxel>>>();
+    launchTest<voxomap::SparseSuperContainer<voxomap::PaletteContainer<voxel>>>();
 
     // Multiple super container
     launchTest<voxomap::SparseSuperContainer<voxomap::SparseSuperContainer<voxomap::SparseContainer<voxel>>>>();
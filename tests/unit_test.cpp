@@ -1,12 +1,20 @@
 #include <iostream>
+#include <atomic>
 #include <chrono>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <sstream>
+#include <thread>
 #include "../voxel_octree/VoxelOctree.hpp"
 #include "../voxel_octree/VoxelContainer/SparseContainer.hpp"
 #include "../voxel_octree/VoxelContainer/ArrayContainer.hpp"
 #include "../voxel_octree/VoxelContainer/SidedContainer.hpp"
+#include "../voxel_octree/VoxelContainer/PaletteContainer.hpp"
 #include "../voxel_octree/SuperContainer/ArraySuperContainer.hpp"
 #include "../voxel_octree/SuperContainer/SparseSuperContainer.hpp"
 #include "../utils/LocalSearchUtility.hpp"
+#include "../utils/VoxelAccessor.hpp"
 #include "common.hpp"
 
 static const size_t gNbVoxel = 500000;
@@ -88,6 +96,123 @@ void test_octree()
     }
 }
 
+template <typename T_Container>
+bool test_delta_serialization()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_delta_serialization (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+
+    voxomap::VoxelOctree<T_Container> octree;
+    voxomap::VoxelOctree<T_Container> replica;
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+    std::string serialized_octree;
+    octree.serialize(serialized_octree);
+    replica.unserialize(serialized_octree.data(), serialized_octree.size());
+    auto checkpoint = octree.checkpoint();
+
+    size_t nb_error = 0;
+    auto check = [&octree, &replica, &nb_error]() {
+        for (auto const& data : voxomap::test::gTestValues)
+        {
+            for (int z = data.z; z <= data.z + 1; ++z)
+            {
+                auto it = octree.findVoxel(data.x, data.y, z);
+                auto it2 = replica.findVoxel(data.x, data.y, z);
+                if (bool(it) != bool(it2) || (it && it.voxel->value != it2.voxel->value))
+                    ++nb_error;
+            }
+        }
+        size_t nb_voxel = 0;
+        size_t nb_voxel_2 = 0;
+        octree.exploreVoxel([&nb_voxel](typename T_Container::iterator const&) { ++nb_voxel; });
+        replica.exploreVoxel([&nb_voxel_2](typename T_Container::iterator const&) { ++nb_voxel_2; });
+        if (nb_voxel != nb_voxel_2 || replica.getNbVoxels() != nb_voxel_2)
+            ++nb_error;
+    };
+
+    // Update, remove and add a few voxels
+    std::mt19937 r(42);
+    for (size_t i = 0; i < voxomap::test::gTestValues.size() / 100; ++i)
+    {
+        auto const& data = voxomap::test::gTestValues[r() % voxomap::test::gTestValues.size()];
+        if (i % 3 == 0)
+            octree.updateVoxel(data.x, data.y, data.z, data.value + 1);
+        else if (i % 3 == 1)
+            octree.removeVoxel(data.x, data.y, data.z);
+        else
+            octree.putVoxel(data.x, data.y, data.z + 1, data.value);
+    }
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::string delta;
+    octree.serializeDelta(delta, checkpoint);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    if (delta.size() >= serialized_octree.size())
+        ++nb_error;
+    {
+        // Corrupted deltas are rejected without reading outside of the buffer
+        uint32_t nb_removed;
+        std::memcpy(&nb_removed, &delta[8], sizeof(nb_removed));
+        size_t container_pos = 12 + nb_removed * 3 * sizeof(int);
+        voxomap::VoxelOctree<T_Container> tmp(replica);
+
+        std::string corrupted = delta;
+        uint32_t value = 0xFFFFFFFF;
+        std::memcpy(&corrupted[8], &value, sizeof(value));
+        if (tmp.applyDelta(corrupted.data(), corrupted.size()) != 0)
+            ++nb_error;
+
+        corrupted = delta.substr(0, container_pos);
+        value = static_cast<uint32_t>(corrupted.size());
+        std::memcpy(&corrupted[0], &value, sizeof(value));
+        if (tmp.applyDelta(corrupted.data(), corrupted.size()) != 0)
+            ++nb_error;
+
+        corrupted = delta;
+        std::memcpy(&value, &corrupted[container_pos], sizeof(value));
+        ++value;
+        std::memcpy(&corrupted[container_pos], &value, sizeof(value));
+        if (tmp.applyDelta(corrupted.data(), corrupted.size()) != 0)
+            ++nb_error;
+    }
+    if (replica.applyDelta(delta.data(), delta.size()) != delta.size())
+        ++nb_error;
+    check();
+
+    // Unchanged octree gives a delta without effect
+    delta.clear();
+    octree.serializeDelta(delta, octree.checkpoint());
+    if (replica.applyDelta(delta.data(), delta.size()) != delta.size())
+        ++nb_error;
+
+    // Cleared octree
+    checkpoint = octree.checkpoint();
+    octree.discardRemovedLeaves(checkpoint);
+    octree.clear();
+    for (size_t i = 0; i < voxomap::test::gTestValues.size(); i += 100)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+    }
+    delta.clear();
+    octree.serializeDelta(delta, checkpoint);
+    if (replica.applyDelta(delta.data(), delta.size()) != delta.size())
+        ++nb_error;
+    check();
+
+    if (nb_error == 0)
+        std::cout << "No delta error detected" << std::endl;
+    else
+        std::cout << "Error: " << nb_error << " delta errors detected" << std::endl;
+
+    std::cout << "Delta serialization time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_error == 0;
+}
+
 template <typename T_Container>
 bool test_find_relative_voxel()
 {
@@ -309,273 +434,1720 @@ bool test_local_search_utility()
 }
 
 template <typename T_Container>
-bool test_iterator()
+bool test_find_neighbors()
 {
     voxomap::test::initGlobalValues(gNbVoxel);
 
-    std::cout << "Launch test_iterator (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+    std::cout << "Launch test_find_neighbors (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
 
     voxomap::VoxelOctree<T_Container> octree;
-    size_t nb_added_voxel = 0;
-    size_t nb_count_voxel_position = 0;
-
-    auto t1 = std::chrono::high_resolution_clock::now();
     for (size_t i = 0; i < voxomap::test::gTestValues.size(); ++i)
     {
         auto const& data = voxomap::test::gTestValues[i];
-        auto pair = octree.addVoxel(data.x, data.y, data.z, data.value);
-        if (pair.second)
-        {
-            ++nb_added_voxel;
-            int cx, cy, cz;
-            pair.first.getVoxelPosition(cx, cy, cz);
-            if (data.x == cx && data.y == cy && data.z == cz)
-                ++nb_count_voxel_position;
-        }
+        octree.addVoxel(data.x, data.y, data.z, data.value);
     }
-    auto t2 = std::chrono::high_resolution_clock::now();
 
-    size_t nb_count_voxel = 0;
-    for (auto it : octree)
+    const float radius = 6.5f;
+    const int64_t squared_radius = static_cast<int64_t>(radius * radius);
+    size_t nb_error = 0;
+    size_t nb_found_voxel = 0;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < voxomap::test::gTestValues.size() / 100; ++i)
     {
-        ++nb_count_voxel;
-    }
-    auto t3 = std::chrono::high_resolution_clock::now();
+        auto const& data = voxomap::test::gTestValues[i];
+        voxomap::LocalSearchUtility<T_Container> search_area(octree, data.x, data.y, data.z);
+        auto neighbors = search_area.findNeighbors(radius);
 
-    size_t nb_count_voxel_explored = 0;
-    octree.exploreVoxel([&nb_count_voxel_explored](typename T_Container::iterator const&) {
-        ++nb_count_voxel_explored;
-    });
-    auto t4 = std::chrono::high_resolution_clock::now();
+        size_t nb_expected = 0;
+        for (int ix = -6; ix <= 6; ++ix)
+        {
+            for (int iy = -6; iy <= 6; ++iy)
+            {
+                for (int iz = -6; iz <= 6; ++iz)
+                {
+                    if (ix * ix + iy * iy + iz * iz <= squared_radius && octree.findVoxel(data.x + ix, data.y + iy, data.z + iz))
+                        ++nb_expected;
+                }
+            }
+        }
+        if (nb_expected != neighbors.size())
+            ++nb_error;
 
-    auto it = octree.begin();
-    while (it != octree.end())
-    {
-        octree.removeVoxel(it++);
+        int64_t previous_distance = 0;
+        for (auto const& it : neighbors)
+        {
+            int x, y, z;
+            it.getVoxelPosition(x, y, z);
+            int64_t distance = (x - data.x) * (x - data.x) + (y - data.y) * (y - data.y) + (z - data.z) * (z - data.z);
+            if (distance > squared_radius || distance < previous_distance || octree.findVoxel(x, y, z) != it)
+                ++nb_error;
+            previous_distance = distance;
+        }
+        nb_found_voxel += neighbors.size();
     }
-    auto t5 = std::chrono::high_resolution_clock::now();
-
-    size_t nb_remaining_voxel = 0;
-    octree.exploreVoxel([&nb_remaining_voxel](typename T_Container::iterator const&) {
-        ++nb_remaining_voxel;
-    });
-
-    if (nb_added_voxel == nb_count_voxel)
-        std::cout << "No error detected, go through all voxels." << std::endl;
-    else
-        std::cout << "Error: forget to go through " << (nb_added_voxel - nb_count_voxel) << " voxels." << std::endl;
+    auto t2 = std::chrono::high_resolution_clock::now();
 
-    if (nb_count_voxel_position == nb_count_voxel)
-        std::cout << "No error detected, check all voxel positions." << std::endl;
-    else
-        std::cout << "Error: bad position on " << (nb_count_voxel_position - nb_count_voxel) << " voxels." << std::endl;
+    if (nb_found_voxel == 0)
+        std::cout << "Error: " << "No voxel found" << std::endl;
 
-    if (nb_remaining_voxel == 0)
-        std::cout << "No error detected" << std::endl;
+    if (nb_error == 0)
+        std::cout << "No neighbor error detected" << std::endl;
     else
-        std::cout << "Error: there still are " << nb_remaining_voxel << " voxels inside the octree." << std::endl;
+        std::cout << "Error: " << nb_error << " neighbor errors detected" << std::endl;
 
-    int add_time = static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count());
-    int read_time = static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count());
-    int explore_time = static_cast<int>(std::chrono::duration<double, std::milli>(t4 - t3).count());
-    int rm_time = static_cast<int>(std::chrono::duration<double, std::milli>(t5 - t4).count());
-    std::cout << "Added " << nb_added_voxel << " voxels in " << add_time << "ms, " << int(nb_added_voxel / float(add_time / 1000.f)) << " voxels/s." << std::endl;
-    std::cout << "Read " << nb_added_voxel << " voxels in " << read_time << "ms, " << int(nb_added_voxel / float(read_time / 1000.f)) << " voxels/s." << std::endl;
-    std::cout << "Explore " << nb_count_voxel_explored << " voxels in " << explore_time << "ms, " << int(nb_count_voxel_explored / float(explore_time / 1000.f)) << " voxels/s." << std::endl;
-    std::cout << "Remove " << nb_added_voxel << " voxels in " << rm_time << "ms, " << int(nb_added_voxel / float(rm_time / 1000.f)) << " voxels/s." << std::endl;
-    std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t4 - t1).count()) << "ms." << std::endl;
+    std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
     std::cout << std::endl;
 
-    return nb_added_voxel == nb_count_voxel && nb_count_voxel_position == nb_count_voxel && nb_remaining_voxel == 0;
-}
-
-template <typename T_Container>
-static void checkError(typename T_Container::VoxelData const& voxel, typename T_Container::iterator const& it, voxomap::SideEnum side, size_t& nb_error)
-{
-    if (voxel & side)
-    {
-        if (!it)
-            ++nb_error;
-    }
-    else if (it)
-        ++nb_error;
+    return nb_found_voxel != 0 && nb_error == 0;
 }
 
 template <typename T_Container>
-bool test_sided_container()
+bool test_batch_insertion()
 {
     voxomap::test::initGlobalValues(gNbVoxel);
 
-    std::cout << "Launch test_sided_container (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+    std::cout << "Launch test_batch_insertion (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+
+    std::vector<voxomap::Vector3I> positions;
+    std::vector<int64_t> values;
+    for (auto const& data : voxomap::test::gTestValues)
+    {
+        positions.emplace_back(data.x, data.y, data.z);
+        values.push_back(data.value);
+    }
 
     voxomap::VoxelOctree<T_Container> octree;
-    size_t nb_added_voxel = 0;
+    voxomap::VoxelOctree<T_Container> batch_octree;
+    voxomap::VoxelOctree<T_Container> put_octree;
 
     auto t1 = std::chrono::high_resolution_clock::now();
-    for (size_t i = 0; i < voxomap::test::gTestValues.size(); ++i)
+    size_t nb_batch_added_voxel = batch_octree.addVoxels(positions.data(), values.data(), positions.size());
+    auto t2 = std::chrono::high_resolution_clock::now();
+    size_t nb_added_voxel = 0;
+    for (auto const& data : voxomap::test::gTestValues)
     {
-        auto const& data = voxomap::test::gTestValues[i];
         if (octree.addVoxel(data.x, data.y, data.z, data.value).second)
             ++nb_added_voxel;
     }
-    auto t2 = std::chrono::high_resolution_clock::now();
+    auto t3 = std::chrono::high_resolution_clock::now();
+    put_octree.putVoxels(positions.data(), values.data(), positions.size());
 
     size_t nb_error = 0;
-    for (auto it : octree)
+    if (nb_added_voxel != nb_batch_added_voxel)
+        ++nb_error;
+    for (size_t i = 0; i < voxomap::test::gTestValues.size(); ++i)
     {
-        voxomap::LocalSearchUtility<T_Container> search_area(*it);
-
-        if ((it->node->getX() == 120 || it->node->getX() == 128) && it->node->getY() == 104 && it->node->getZ() == 312 &&
-            (it->x == 0 || it->x == 7) && it->y == 7 && it->z == 7)
-        {
-            checkError<T_Container>(*it->voxel, search_area.findVoxel(1, 0, 0), voxomap::XPOS, nb_error);
-            checkError<T_Container>(*it->voxel, search_area.findVoxel(-1, 0, 0), voxomap::XNEG, nb_error);
-            checkError<T_Container>(*it->voxel, search_area.findVoxel(0, 1, 0), voxomap::YPOS, nb_error);
-            checkError<T_Container>(*it->voxel, search_area.findVoxel(0, -1, 0), voxomap::YNEG, nb_error);
-            checkError<T_Container>(*it->voxel, search_area.findVoxel(0, 0, 1), voxomap::ZPOS, nb_error);
-            checkError<T_Container>(*it->voxel, search_area.findVoxel(0, 0, -1), voxomap::ZNEG, nb_error);
-        }
+        auto const& data = voxomap::test::gTestValues[i];
+        auto it = octree.findVoxel(data.x, data.y, data.z);
+        auto bit = batch_octree.findVoxel(data.x, data.y, data.z);
+        auto pit = put_octree.findVoxel(data.x, data.y, data.z);
+        if (!it || !bit || !pit || it.voxel->value != bit.voxel->value)
+            ++nb_error;
+    }
+    for (size_t i = voxomap::test::gTestValues.size(); i-- > 0;)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        auto pit = put_octree.findVoxel(data.x, data.y, data.z);
+        if (pit && pit.voxel->value == data.value)
+            pit.voxel->value = -1;
+        else if (!pit || pit.voxel->value != -1)
+            ++nb_error;
     }
-    auto t3 = std::chrono::high_resolution_clock::now();
 
     if (nb_error == 0)
-        std::cout << "No error detected" << std::endl;
+        std::cout << "No batch error detected" << std::endl;
     else
-        std::cout << "Error: there is " << nb_error << " errors." << std::endl;
+        std::cout << "Error: " << nb_error << " batch errors detected" << std::endl;
 
-    int add_time = static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count());
-    int check_time = static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count());
-    std::cout << "Added " << nb_added_voxel << " voxels in " << add_time << "ms, " << int(nb_added_voxel / float(add_time / 1000.f)) << " voxels/s." << std::endl;
-    std::cout << "Check Side in " << check_time << "ms." << std::endl;
-    std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t1).count()) << "ms." << std::endl;
+    std::cout << "Batch add time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << "Add time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count()) << "ms." << std::endl;
     std::cout << std::endl;
 
     return nb_error == 0;
 }
 
 template <typename T_Container>
-bool test_remove_voxel()
+bool test_find_voxels()
 {
     voxomap::test::initGlobalValues(gNbVoxel);
 
-    std::cout << "Launch test_remove_voxel (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
-    voxomap::VoxelOctree<T_Container> octree;
+    std::cout << "Launch test_find_voxels (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
 
-    std::vector<voxomap::test::Data> testValues;
-    std::vector<voxomap::test::Data> removeTestValues;
-    std::mt19937 r(42);
+    voxomap::VoxelOctree<T_Container> octree;
+    std::vector<voxomap::Vector3I> positions;
     for (auto const& data : voxomap::test::gTestValues)
     {
-        if (r() % 3)
-            removeTestValues.emplace_back(data);
-        else
-            testValues.emplace_back(data);
+        octree.addVoxel(data.x, data.y, data.z, data.value);
+        positions.emplace_back(data.x, data.y, data.z);
+        positions.emplace_back(data.x + 1, data.y - 3, data.z + 300);
     }
 
+    std::vector<typename T_Container::iterator> results(positions.size());
     auto t1 = std::chrono::high_resolution_clock::now();
-    for (auto const& data : voxomap::test::gTestValues)
-        octree.putVoxel(data.x, data.y, data.z, data.value);
-    for (auto const& data : removeTestValues)
-        octree.removeVoxel(data.x, data.y, data.z);
+    octree.findVoxels(positions.data(), results.data(), positions.size());
     auto t2 = std::chrono::high_resolution_clock::now();
 
-    size_t read_nb_error = 0;
-    for (auto const& data : testValues)
-    {
-        auto it = octree.findVoxel(data.x, data.y, data.z);
-        if (!it || it.voxel->value != data.value)
-            ++read_nb_error;
-    }
-    for (auto const& data : removeTestValues)
+    size_t nb_error = 0;
+    size_t nb_found_voxel = 0;
+    for (size_t i = 0; i < positions.size(); ++i)
     {
-        auto it = octree.findVoxel(data.x, data.y, data.z);
-        if (it)
-            ++read_nb_error;
+        auto it = octree.findVoxel(positions[i].x, positions[i].y, positions[i].z);
+        if (it != results[i] || (it && it.voxel->value != results[i].voxel->value))
+            ++nb_error;
+        if (results[i])
+            ++nb_found_voxel;
     }
     auto t3 = std::chrono::high_resolution_clock::now();
 
-    if (read_nb_error == 0)
-        std::cout << "No error detected" << std::endl;
+    if (nb_found_voxel == 0)
+        std::cout << "Error: " << "No voxel found" << std::endl;
+
+    if (nb_error == 0)
+        std::cout << "No find error detected" << std::endl;
     else
-        std::cout << "Error: there is " << read_nb_error << " errors." << std::endl;
+        std::cout << "Error: " << nb_error << " find errors detected" << std::endl;
 
-    std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t1).count()) << "ms." << std::endl;
+    std::cout << "Batch find time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << "Find time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count()) << "ms." << std::endl;
     std::cout << std::endl;
 
-    return read_nb_error == 0;
+    return nb_found_voxel != 0 && nb_error == 0;
 }
 
 template <typename T_Container>
-bool test_serialization()
+bool test_concurrent_read()
 {
     voxomap::test::initGlobalValues(gNbVoxel);
 
-    std::cout << "Launch test_serialization (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
-    voxomap::VoxelOctree<T_Container> octree;
+    std::cout << "Launch test_concurrent_read (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
 
-    std::vector<voxomap::test::Data> testValues;
-    std::vector<voxomap::test::Data> removeTestValues;
-    std::mt19937 r(42);
+    voxomap::VoxelOctree<T_Container> octree;
     for (auto const& data : voxomap::test::gTestValues)
-    {
-        if (r() % 3)
-            removeTestValues.emplace_back(data);
-        else
-            testValues.emplace_back(data);
-    }
+        octree.addVoxel(data.x, data.y, data.z, data.value);
 
-    auto t1 = std::chrono::high_resolution_clock::now();
-    for (auto const& data : voxomap::test::gTestValues)
-        octree.putVoxel(data.x, data.y, data.z, data.value);
-    for (auto const& data : removeTestValues)
-        octree.removeVoxel(data.x, data.y, data.z);
-    auto t2 = std::chrono::high_resolution_clock::now();
+    voxomap::VoxelOctree<T_Container> const& const_octree = octree;
+    const size_t nb_thread = 4;
+    std::vector<size_t> nb_errors(nb_thread, 0);
+    std::vector<std::thread> threads;
 
-    size_t size = 0;
-    voxomap::VoxelOctree<T_Container> octree_2;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (size_t thread_id = 0; thread_id < nb_thread; ++thread_id)
     {
-        std::string serialized_octree;
-        octree.serialize(serialized_octree);
-        size = serialized_octree.size();
-        octree.clear();
-        octree_2.unserialize(serialized_octree.data(), serialized_octree.size());
+        threads.emplace_back([&const_octree, &nb_errors, thread_id, nb_thread]() {
+            voxomap::VoxelNode<T_Container> const* hint = nullptr;
+            for (size_t i = thread_id; i < voxomap::test::gTestValues.size(); i += nb_thread)
+            {
+                auto const& data = voxomap::test::gTestValues[i];
+                auto it = const_octree.findVoxel(data.x, data.y, data.z, hint);
+                auto it2 = const_octree.findVoxel(data.x, data.y, data.z);
+                if (!it || it != it2 || const_octree.findVoxelNode(data.x, data.y, data.z) != it.node)
+                    ++nb_errors[thread_id];
+            }
+        });
     }
-    auto t3 = std::chrono::high_resolution_clock::now();
+    for (auto& thread : threads)
+        thread.join();
+    auto t2 = std::chrono::high_resolution_clock::now();
 
-    size_t read_nb_error = 0;
-    for (auto const& data : testValues)
-    {
+    size_t nb_error = 0;
+    for (size_t error : nb_errors)
+        nb_error += error;
+
+    if (nb_error == 0)
+        std::cout << "No read error detected" << std::endl;
+    else
+        std::cout << "Error: " << nb_error << " read errors detected" << std::endl;
+
+    std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_error == 0;
+}
+
+template <typename T_Container>
+bool test_leaf_index()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_leaf_index (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+
+    voxomap::VoxelOctree<T_Container> octree;
+    voxomap::VoxelOctree<T_Container> indexed_octree;
+    indexed_octree.enableLeafIndex();
+    for (auto const& data : voxomap::test::gTestValues)
+    {
+        octree.addVoxel(data.x, data.y, data.z, data.value);
+        indexed_octree.addVoxel(data.x, data.y, data.z, data.value);
+    }
+
+    size_t nb_error = 0;
+    auto check = [&nb_error](voxomap::VoxelOctree<T_Container> const& reference, voxomap::VoxelOctree<T_Container>& tested) {
+        for (auto const& data : voxomap::test::gTestValues)
+        {
+            auto it = reference.findVoxel(data.x, data.y, data.z);
+            auto it2 = tested.findVoxel(data.x, data.y, data.z);
+            if (bool(it) != bool(it2) || (it && it.voxel->value != it2.voxel->value))
+                ++nb_error;
+            if (bool(reference.findVoxelNode(data.x, data.y, data.z)) != bool(tested.findVoxelNode(data.x + 0.5, data.y + 0.5, data.z + 0.5)))
+                ++nb_error;
+        }
+    };
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    check(octree, indexed_octree);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    // Remove half of the voxels, the emptied leaves are removed from the index
+    for (size_t i = 0; i < voxomap::test::gTestValues.size(); i += 2)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        octree.removeVoxel(data.x, data.y, data.z);
+        indexed_octree.removeVoxel(data.x, data.y, data.z);
+    }
+    check(octree, indexed_octree);
+
+    if (indexed_octree.memoryUsage().leafIndex == 0 || octree.memoryUsage().leafIndex != 0)
+        ++nb_error;
+
+    // Index copied with the octree
+    {
+        voxomap::VoxelOctree<T_Container> copy_octree(indexed_octree);
+        if (!copy_octree.isLeafIndexEnabled())
+            ++nb_error;
+        check(octree, copy_octree);
+    }
+
+    // Index built from an existing octree
+    indexed_octree.enableLeafIndex(false);
+    octree.enableLeafIndex();
+    check(indexed_octree, octree);
+
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.removeVoxel(data.x, data.y, data.z);
+    if (octree.getRootNode() != nullptr || octree.findVoxelNode(0, 0, 0) != nullptr)
+        ++nb_error;
+
+    if (nb_error == 0)
+        std::cout << "No leaf index error detected" << std::endl;
+    else
+        std::cout << "Error: " << nb_error << " leaf index errors detected" << std::endl;
+
+    std::cout << "Find time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_error == 0;
+}
+
+template <typename T_Container>
+bool test_listener()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_listener (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+
+    // Keeps the leaves known from the notifications
+    struct LeafListener : voxomap::VoxelOctree<T_Container>::Listener
+    {
+        void onVoxelModified(typename T_Container::iterator const& it) override
+        {
+            leaves.insert(it.node);
+            ++nb_voxel_modified;
+        }
+        void onLeafModified(voxomap::VoxelNode<T_Container> const& node) override { leaves.insert(&node); }
+        void onLeafRemoving(voxomap::VoxelNode<T_Container> const& node) override { leaves.erase(&node); }
+
+        std::set<voxomap::VoxelNode<T_Container> const*> leaves;
+        size_t nb_voxel_modified = 0;
+    };
+
+    size_t nb_error = 0;
+    auto check = [&nb_error](voxomap::VoxelOctree<T_Container> const& octree, LeafListener const& listener) {
+        std::set<voxomap::VoxelNode<T_Container> const*> leaves;
+        octree.exploreVoxelNode([&leaves](voxomap::VoxelNode<T_Container> const& node) {
+            if (node.getVoxelContainer())
+                leaves.insert(&node);
+        });
+        if (leaves != listener.leaves)
+            ++nb_error;
+    };
+
+    LeafListener listener;
+    voxomap::VoxelOctree<T_Container> other_octree;
+    {
+        voxomap::VoxelOctree<T_Container> octree;
+        octree.addListener(listener);
+        for (auto const& data : voxomap::test::gTestValues)
+            octree.addVoxel(data.x, data.y, data.z, data.value);
+        if (listener.nb_voxel_modified != voxomap::test::gTestValues.size())
+            ++nb_error;
+        check(octree, listener);
+
+        // Emptied leaves are removed
+        for (size_t i = 0; i < voxomap::test::gTestValues.size(); i += 2)
+        {
+            auto const& data = voxomap::test::gTestValues[i];
+            octree.removeVoxel(data.x, data.y, data.z);
+        }
+        check(octree, listener);
+
+        // Leaves moved to another octree
+        other_octree = std::move(octree);
+        if (!listener.leaves.empty())
+            ++nb_error;
+        octree = other_octree;
+        check(octree, listener);
+
+        octree.clear();
+        if (!listener.leaves.empty())
+            ++nb_error;
+        octree = other_octree;
+    }
+    // The destroyed octree removes its leaves and detaches the listener
+    if (!listener.leaves.empty())
+        ++nb_error;
+    other_octree.addListener(listener);
+    other_octree.removeListener(listener);
+    other_octree.clear();
+
+    {
+        LeafListener copy_listener(listener);
+        other_octree.addListener(copy_listener);
+    }
+    other_octree.addVoxel(0, 0, 0, voxomap::test::gTestValues[0].value);
+
+    if (nb_error == 0)
+        std::cout << "No listener error detected" << std::endl;
+    else
+        std::cout << "Error: " << nb_error << " listener errors detected" << std::endl;
+    std::cout << std::endl;
+
+    return nb_error == 0;
+}
+
+template <typename T_Container>
+bool test_frozen_octree()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_frozen_octree (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+
+    voxomap::VoxelOctree<T_Container> octree;
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.addVoxel(data.x, data.y, data.z, data.value);
+
+    size_t nb_error = 0;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto frozen_octree = octree.freeze();
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    for (auto const& data : voxomap::test::gTestValues)
+    {
+        auto it = frozen_octree.findVoxel(data.x, data.y, data.z);
+        if (!it || it.voxel->value != data.value)
+            ++nb_error;
+        if (!frozen_octree.findVoxelNode(data.x, data.y, data.z) || !frozen_octree.findVoxel(data.x + 0.5, data.y + 0.5, data.z + 0.5))
+            ++nb_error;
+    }
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    unsigned int nb_explored = 0;
+    frozen_octree.exploreVoxel([&nb_explored, &octree, &nb_error](typename T_Container::iterator const& it) {
+        int x, y, z;
+        it.getVoxelPosition(x, y, z);
+        auto it2 = octree.findVoxel(x, y, z);
+        if (!it2 || it2.voxel->value != it.voxel->value)
+            ++nb_error;
+        ++nb_explored;
+    });
+    if (nb_explored != frozen_octree.getNbVoxels())
+        ++nb_error;
+
+    // The frozen octree doesn't see the modifications of the source octree
+    for (size_t i = 0; i < voxomap::test::gTestValues.size(); i += 2)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        octree.removeVoxel(data.x, data.y, data.z);
+    }
+    for (auto const& data : voxomap::test::gTestValues)
+    {
+        auto it = frozen_octree.findVoxel(data.x, data.y, data.z);
+        if (!it || it.voxel->value != data.value)
+            ++nb_error;
+    }
+
+    // Thawed octree is editable and has the voxels of the frozen octree
+    {
+        auto thawed_octree = frozen_octree.thaw();
+        if (thawed_octree.getNbVoxels() != frozen_octree.getNbVoxels())
+            ++nb_error;
+        for (size_t i = 0; i < voxomap::test::gTestValues.size(); ++i)
+        {
+            auto const& data = voxomap::test::gTestValues[i];
+            auto it = thawed_octree.findVoxel(data.x, data.y, data.z);
+            if (!it || it.voxel->value != data.value)
+                ++nb_error;
+            if (i % 2 == 1)
+                thawed_octree.removeVoxel(data.x, data.y, data.z);
+        }
+        for (auto const& data : voxomap::test::gTestValues)
+        {
+            if (!frozen_octree.findVoxel(data.x, data.y, data.z))
+                ++nb_error;
+        }
+    }
+
+    voxomap::FrozenVoxelOctree<T_Container> empty_octree(voxomap::VoxelOctree<T_Container>{});
+    if (!empty_octree.empty() || empty_octree.findVoxelNode(0, 0, 0) != nullptr)
+        ++nb_error;
+
+    if (nb_error == 0)
+        std::cout << "No frozen octree error detected" << std::endl;
+    else
+        std::cout << "Error: " << nb_error << " frozen octree errors detected" << std::endl;
+
+    std::cout << "Freeze time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << "Find time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_error == 0;
+}
+
+template <typename T_Container>
+bool test_snapshot()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_snapshot (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+
+    voxomap::VoxelOctree<T_Container> octree;
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.addVoxel(data.x, data.y, data.z, data.value);
+
+    size_t nb_error = 0;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto snapshot = octree.snapshot();
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    // Unchanged octree returns the same snapshot
+    if (octree.snapshot() != snapshot)
+        ++nb_error;
+
+    // Read the snapshot while the octree is modified
+    size_t nb_read_error = 0;
+    std::thread reader([&snapshot, &nb_read_error]() {
+        for (auto const& data : voxomap::test::gTestValues)
+        {
+            auto it = snapshot->findVoxel(data.x, data.y, data.z);
+            if (!it || it.voxel->value != data.value)
+                ++nb_read_error;
+        }
+    });
+    auto version = octree.getVersion();
+    for (size_t i = 0; i < voxomap::test::gTestValues.size(); ++i)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        if (i % 2)
+            octree.updateVoxel(data.x, data.y, data.z, data.value + 1);
+        else
+            octree.removeVoxel(data.x, data.y, data.z);
+    }
+    reader.join();
+    nb_error += nb_read_error;
+    if (octree.getVersion() == version)
+        ++nb_error;
+
+    auto new_snapshot = octree.snapshot();
+    if (new_snapshot == snapshot)
+        ++nb_error;
+    for (size_t i = 0; i < voxomap::test::gTestValues.size(); ++i)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        auto it = new_snapshot->findVoxel(data.x, data.y, data.z);
+        auto it2 = octree.findVoxel(data.x, data.y, data.z);
+        if (bool(it) != bool(it2) || (it && it.voxel->value != it2.voxel->value))
+            ++nb_error;
+    }
+
+    if (nb_error == 0)
+        std::cout << "No snapshot error detected" << std::endl;
+    else
+        std::cout << "Error: " << nb_error << " snapshot errors detected" << std::endl;
+
+    std::cout << "Snapshot time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_error == 0;
+}
+
+template <typename T_Container>
+bool test_voxel_accessor()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_voxel_accessor (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+
+    // Same edits with the accessor and with the octree methods
+    voxomap::VoxelOctree<T_Container> octree;
+    voxomap::VoxelOctree<T_Container> accessor_octree;
+    voxomap::VoxelAccessor<T_Container> accessor(accessor_octree);
+    size_t nb_error = 0;
+    auto const& values = voxomap::test::gTestValues;
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (auto const& data : values)
+    {
+        octree.addVoxel(data.x, data.y, data.z, data.value);
+        auto result = accessor.addVoxel(data.x, data.y, data.z, data.value);
+        if (!result.first)
+            ++nb_error;
+    }
+    for (size_t i = 0; i < values.size(); i += 3)
+    {
+        octree.updateVoxel(values[i].x, values[i].y, values[i].z, values[i].value + 1);
+        if (!accessor.updateVoxel(values[i].x, values[i].y, values[i].z, values[i].value + 1))
+            ++nb_error;
+    }
+    for (size_t i = 0; i < values.size(); i += 2)
+    {
+        bool removed = octree.removeVoxel(values[i].x, values[i].y, values[i].z);
+        if (accessor.removeVoxel(values[i].x, values[i].y, values[i].z) != removed)
+            ++nb_error;
+    }
+    for (size_t i = 0; i < values.size(); i += 4)
+    {
+        octree.putVoxel(values[i].x, values[i].y, values[i].z, values[i].value + 2);
+        accessor.putVoxel(values[i].x, values[i].y, values[i].z, values[i].value + 2);
+    }
+    if (octree.getNbVoxels() != accessor_octree.getNbVoxels())
+        ++nb_error;
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    // The writes after a snapshot copy the containers, the cached ones are not modified
+    auto snapshot = accessor_octree.snapshot();
+    for (size_t i = 0; i < values.size(); i += 4)
+    {
+        octree.putVoxel(values[i].x, values[i].y, values[i].z, values[i].value + 3);
+        octree.putVoxel(values[i].x ^ 1, values[i].y, values[i].z, values[i].value + 3);
+        accessor.putVoxel(values[i].x, values[i].y, values[i].z, values[i].value + 3);
+        accessor.putVoxel(values[i].x ^ 1, values[i].y, values[i].z, values[i].value + 3);
+    }
+    for (size_t i = 0; i < values.size(); i += 4)
+    {
+        auto it = snapshot->findVoxel(values[i].x, values[i].y, values[i].z);
+        if (!it || it.voxel->value != values[i].value + 2)
+            ++nb_error;
+    }
+
+    // Neighborhood of each voxel, the queries cross the voxel containers and the leaves
+    for (auto const& data : values)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            for (int y = -1; y <= 1; ++y)
+            {
+                for (int z = -1; z <= 1; ++z)
+                {
+                    auto it = octree.findVoxel(data.x + x, data.y + y, data.z + z);
+                    auto it2 = accessor.findVoxel(data.x + x, data.y + y, data.z + z);
+                    if (bool(it) != bool(it2) || (it && it.voxel->value != it2.voxel->value))
+                        ++nb_error;
+                }
+            }
+        }
+    }
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    if (nb_error == 0)
+        std::cout << "No accessor error detected" << std::endl;
+    else
+        std::cout << "Error: " << nb_error << " accessor errors detected" << std::endl;
+
+    std::cout << "Edit time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << "Find time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_error == 0;
+}
+
+template <typename T_Container>
+bool test_explore()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_explore (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+
+    voxomap::VoxelOctree<T_Container> octree;
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.addVoxel(data.x, data.y, data.z, data.value);
+
+    size_t nb_voxel = 0;
+    for (auto it : octree)
+        ++nb_voxel;
+
+    // Template callable
+    size_t nb_explored_voxel = 0;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    octree.exploreVoxel([&nb_explored_voxel](typename T_Container::iterator const&) {
+        ++nb_explored_voxel;
+    });
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    // std::function is still accepted
+    size_t nb_function_voxel = 0;
+    std::function<void(typename T_Container::iterator const&)> function = [&nb_function_voxel](typename T_Container::iterator const&) {
+        ++nb_function_voxel;
+    };
+    octree.exploreVoxel(function);
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    size_t nb_container_voxel = 0;
+    octree.exploreVoxelContainer([&nb_container_voxel](typename T_Container::VoxelContainer const& container) {
+        nb_container_voxel += container.getNbVoxel();
+    });
+
+    size_t nb_node_voxel = 0;
+    octree.exploreVoxelNode([&nb_node_voxel](voxomap::VoxelNode<T_Container> const& node) {
+        nb_node_voxel += node.getNbVoxel();
+    });
+
+    size_t nb_in_voxel = 0;
+    voxomap::BoundingBox<int> bounding_box(voxomap::Vector3I(-2000000000, -2000000000, -2000000000), voxomap::Vector3I(2000000000, 2000000000, 2000000000));
+    octree.exploreBoundingBox(bounding_box, [&nb_in_voxel](voxomap::VoxelNode<T_Container>& node) {
+        nb_in_voxel += node.getNbVoxel();
+    }, nullptr);
+
+    bool success = nb_explored_voxel == nb_voxel && nb_function_voxel == nb_voxel
+        && nb_container_voxel == nb_voxel && nb_node_voxel == nb_voxel && nb_in_voxel == nb_voxel;
+    if (success)
+        std::cout << "No explore error detected" << std::endl;
+    else
+        std::cout << "Error: explored " << nb_explored_voxel << ", " << nb_function_voxel << ", " << nb_container_voxel
+                  << ", " << nb_node_voxel << ", " << nb_in_voxel << " voxels instead of " << nb_voxel << std::endl;
+
+    std::cout << "Explore time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << "Explore time with std::function: " << static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return success;
+}
+
+template <typename T_Container>
+bool test_parallel_explore()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_parallel_explore (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+
+    voxomap::VoxelOctree<T_Container> octree;
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.addVoxel(data.x, data.y, data.z, data.value);
+
+    int64_t nb_voxel = 0;
+    int64_t sum = 0;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    octree.exploreVoxel([&nb_voxel, &sum](typename T_Container::iterator const& it) {
+        ++nb_voxel;
+        sum += it.voxel->value;
+    });
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    voxomap::ThreadPool pool(4);
+    std::pair<int64_t, int64_t> parallel_result = octree.parallelExploreVoxel(pool, std::pair<int64_t, int64_t>(0, 0),
+        [](typename T_Container::iterator const& it, std::pair<int64_t, int64_t>& result) {
+            ++result.first;
+            result.second += it.voxel->value;
+        },
+        [](std::pair<int64_t, int64_t>& result, std::pair<int64_t, int64_t> const& task_result) {
+            result.first += task_result.first;
+            result.second += task_result.second;
+        });
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    std::atomic<int64_t> nb_container_voxel(0);
+    octree.parallelExploreVoxelContainer(pool, [&nb_container_voxel](typename T_Container::VoxelContainer const& container) {
+        nb_container_voxel += container.getNbVoxel();
+    }, 1);
+
+    bool success = true;
+    if (parallel_result.first != nb_voxel || parallel_result.second != sum)
+    {
+        std::cout << "Error: parallel explore found " << parallel_result.first << " voxels instead of " << nb_voxel << std::endl;
+        success = false;
+    }
+    if (nb_container_voxel != nb_voxel)
+    {
+        std::cout << "Error: parallel container explore found " << nb_container_voxel << " voxels instead of " << nb_voxel << std::endl;
+        success = false;
+    }
+    if (success)
+        std::cout << "No explore error detected" << std::endl;
+
+    std::cout << "Explore time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << "Parallel explore time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return success;
+}
+
+template <typename T_Container>
+bool test_memory_pool()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_memory_pool (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+
+    using NodePool = typename voxomap::VoxelOctree<T_Container>::NodePool;
+    auto& container_pool = voxomap::MemoryPool<sizeof(typename T_Container::VoxelContainer)>::get();
+    size_t nb_used_container_block = container_pool.getNbUsedBlocks();
+
+    voxomap::VoxelOctree<T_Container> octree;
+    auto& pool = octree.getNodePool();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.addVoxel(data.x, data.y, data.z, data.value);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    size_t nb_node = pool.getNbUsedBlocks();
+
+    // Each octree allocates its nodes inside its own pool
+    voxomap::VoxelOctree<T_Container> octree_copy(octree);
+    bool copy_success = octree_copy.getNodePool().getNbUsedBlocks() == nb_node && pool.getNbUsedBlocks() == nb_node
+        && &NodePool::getPool(octree_copy.getRootNode()) == &octree_copy.getNodePool();
+    octree_copy.clear();
+    copy_success &= octree_copy.getNodePool().getNbUsedBlocks() == 0 && octree_copy.getNodePool().getNbSlabs() == 0;
+
+    // A popped node keeps the pool of a destroyed octree alive
+    bool pop_success = true;
+    {
+        std::unique_ptr<voxomap::VoxelNode<T_Container>> leaf;
+        {
+            voxomap::VoxelOctree<T_Container> tmp_octree(octree);
+            auto it = tmp_octree.findVoxel(voxomap::test::gTestValues[0].x, voxomap::test::gTestValues[0].y, voxomap::test::gTestValues[0].z);
+            pop_success = it && &NodePool::getPool(it.node) == &tmp_octree.getNodePool();
+            if (pop_success)
+                leaf = tmp_octree.pop(*it.node);
+        }
+        pop_success &= leaf && leaf->getVoxelContainer() != nullptr;
+    }
+
+    auto t3 = std::chrono::high_resolution_clock::now();
+    octree.clear();
+    auto t4 = std::chrono::high_resolution_clock::now();
+
+    bool success = nb_node != 0 && copy_success && pop_success && pool.getNbUsedBlocks() == 0 && pool.getNbSlabs() == 0
+        && container_pool.getNbUsedBlocks() == nb_used_container_block;
+    if (success)
+        std::cout << "No pool error detected, " << nb_node << " nodes allocated" << std::endl;
+    else
+        std::cout << "Error: " << pool.getNbUsedBlocks() << " nodes and "
+                  << container_pool.getNbUsedBlocks() - nb_used_container_block << " containers not released, copy "
+                  << copy_success << ", pop " << pop_success << std::endl;
+
+    std::cout << "Add time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << "Clear time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t4 - t3).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return success;
+}
+
+template <typename T_Container>
+bool test_memory_usage()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_memory_usage (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+
+    voxomap::VoxelOctree<T_Container> octree;
+    auto empty_usage = octree.memoryUsage();
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.addVoxel(data.x, data.y, data.z, data.value);
+
+    size_t nb_node = 0;
+    size_t nb_leaf = 0;
+    std::function<void(voxomap::VoxelNode<T_Container> const&)> count_nodes = [&](voxomap::VoxelNode<T_Container> const& node) {
+        ++nb_node;
+        if (node.getVoxelContainer())
+            ++nb_leaf;
+        for (auto child : node.getChildren())
+        {
+            if (child)
+                count_nodes(*child);
+        }
+    };
+    count_nodes(*octree.getRootNode());
+
+    auto usage = octree.memoryUsage();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    octree.memoryUsage();
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    bool success = true;
+    if (empty_usage.nodes != 0 || empty_usage.voxelContainers != 0)
+    {
+        std::cout << "Error: empty octree uses " << empty_usage.nodes + empty_usage.voxelContainers << " bytes" << std::endl;
+        success = false;
+    }
+    if (usage.nodes != nb_node * sizeof(voxomap::VoxelNode<T_Container>))
+    {
+        std::cout << "Error: " << usage.nodes << " bytes of nodes instead of " << nb_node * sizeof(voxomap::VoxelNode<T_Container>) << std::endl;
+        success = false;
+    }
+    if (usage.voxelContainers < nb_leaf * sizeof(typename T_Container::VoxelContainer))
+    {
+        std::cout << "Error: " << usage.voxelContainers << " bytes of voxel containers for " << nb_leaf << " leaves" << std::endl;
+        success = false;
+    }
+    if ((T_Container::NB_SUPERCONTAINER != 0) != (usage.superContainers != 0))
+    {
+        std::cout << "Error: " << usage.superContainers << " bytes of super containers" << std::endl;
+        success = false;
+    }
+
+    // The containers shared with a frozen copy are counted apart, once for the two octrees
+    auto frozen = octree.freeze();
+    auto shared_usage = octree.memoryUsage();
+    voxomap::MemoryUsage both_usage;
+    octree.memoryUsage(both_usage);
+    frozen.memoryUsage(both_usage);
+    size_t container_memory = usage.superContainers + usage.voxelContainers + usage.idTables;
+    if (shared_usage.sharedContainers != container_memory || shared_usage.voxelContainers != 0
+        || both_usage.sharedContainers != container_memory || both_usage.voxelContainers != 0)
+    {
+        std::cout << "Error: " << shared_usage.sharedContainers << " and " << both_usage.sharedContainers
+                  << " bytes of shared containers instead of " << container_memory << std::endl;
+        success = false;
+    }
+    if (success)
+        std::cout << "No memory usage error detected, " << usage.total() / 1024 << "KB used" << std::endl;
+
+    std::cout << "Memory usage time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return success;
+}
+
+template <typename T_Container>
+bool test_iterator()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_iterator (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+
+    voxomap::VoxelOctree<T_Container> octree;
+    size_t nb_added_voxel = 0;
+    size_t nb_count_voxel_position = 0;
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < voxomap::test::gTestValues.size(); ++i)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        auto pair = octree.addVoxel(data.x, data.y, data.z, data.value);
+        if (pair.second)
+        {
+            ++nb_added_voxel;
+            int cx, cy, cz;
+            pair.first.getVoxelPosition(cx, cy, cz);
+            if (data.x == cx && data.y == cy && data.z == cz)
+                ++nb_count_voxel_position;
+        }
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    size_t nb_count_voxel = 0;
+    for (auto it : octree)
+    {
+        ++nb_count_voxel;
+    }
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    size_t nb_count_voxel_explored = 0;
+    octree.exploreVoxel([&nb_count_voxel_explored](typename T_Container::iterator const&) {
+        ++nb_count_voxel_explored;
+    });
+    auto t4 = std::chrono::high_resolution_clock::now();
+
+    auto it = octree.begin();
+    while (it != octree.end())
+    {
+        octree.removeVoxel(it++);
+    }
+    auto t5 = std::chrono::high_resolution_clock::now();
+
+    size_t nb_remaining_voxel = 0;
+    octree.exploreVoxel([&nb_remaining_voxel](typename T_Container::iterator const&) {
+        ++nb_remaining_voxel;
+    });
+
+    if (nb_added_voxel == nb_count_voxel)
+        std::cout << "No error detected, go through all voxels." << std::endl;
+    else
+        std::cout << "Error: forget to go through " << (nb_added_voxel - nb_count_voxel) << " voxels." << std::endl;
+
+    if (nb_count_voxel_position == nb_count_voxel)
+        std::cout << "No error detected, check all voxel positions." << std::endl;
+    else
+        std::cout << "Error: bad position on " << (nb_count_voxel_position - nb_count_voxel) << " voxels." << std::endl;
+
+    if (nb_remaining_voxel == 0)
+        std::cout << "No error detected" << std::endl;
+    else
+        std::cout << "Error: there still are " << nb_remaining_voxel << " voxels inside the octree." << std::endl;
+
+    int add_time = static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count());
+    int read_time = static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count());
+    int explore_time = static_cast<int>(std::chrono::duration<double, std::milli>(t4 - t3).count());
+    int rm_time = static_cast<int>(std::chrono::duration<double, std::milli>(t5 - t4).count());
+    std::cout << "Added " << nb_added_voxel << " voxels in " << add_time << "ms, " << int(nb_added_voxel / float(add_time / 1000.f)) << " voxels/s." << std::endl;
+    std::cout << "Read " << nb_added_voxel << " voxels in " << read_time << "ms, " << int(nb_added_voxel / float(read_time / 1000.f)) << " voxels/s." << std::endl;
+    std::cout << "Explore " << nb_count_voxel_explored << " voxels in " << explore_time << "ms, " << int(nb_count_voxel_explored / float(explore_time / 1000.f)) << " voxels/s." << std::endl;
+    std::cout << "Remove " << nb_added_voxel << " voxels in " << rm_time << "ms, " << int(nb_added_voxel / float(rm_time / 1000.f)) << " voxels/s." << std::endl;
+    std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t4 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_added_voxel == nb_count_voxel && nb_count_voxel_position == nb_count_voxel && nb_remaining_voxel == 0;
+}
+
+template <typename T_Container>
+static void checkError(typename T_Container::VoxelData const& voxel, typename T_Container::iterator const& it, voxomap::SideEnum side, size_t& nb_error)
+{
+    if (voxel & side)
+    {
+        if (!it)
+            ++nb_error;
+    }
+    else if (it)
+        ++nb_error;
+}
+
+template <typename T_Container>
+bool test_sided_container()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_sided_container (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+
+    voxomap::VoxelOctree<T_Container> octree;
+    size_t nb_added_voxel = 0;
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < voxomap::test::gTestValues.size(); ++i)
+    {
+        auto const& data = voxomap::test::gTestValues[i];
+        if (octree.addVoxel(data.x, data.y, data.z, data.value).second)
+            ++nb_added_voxel;
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    size_t nb_error = 0;
+    for (auto it : octree)
+    {
+        voxomap::LocalSearchUtility<T_Container> search_area(*it);
+
+        if ((it->node->getX() == 120 || it->node->getX() == 128) && it->node->getY() == 104 && it->node->getZ() == 312 &&
+            (it->x == 0 || it->x == 7) && it->y == 7 && it->z == 7)
+        {
+            checkError<T_Container>(*it->voxel, search_area.findVoxel(1, 0, 0), voxomap::XPOS, nb_error);
+            checkError<T_Container>(*it->voxel, search_area.findVoxel(-1, 0, 0), voxomap::XNEG, nb_error);
+            checkError<T_Container>(*it->voxel, search_area.findVoxel(0, 1, 0), voxomap::YPOS, nb_error);
+            checkError<T_Container>(*it->voxel, search_area.findVoxel(0, -1, 0), voxomap::YNEG, nb_error);
+            checkError<T_Container>(*it->voxel, search_area.findVoxel(0, 0, 1), voxomap::ZPOS, nb_error);
+            checkError<T_Container>(*it->voxel, search_area.findVoxel(0, 0, -1), voxomap::ZNEG, nb_error);
+        }
+    }
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    if (nb_error == 0)
+        std::cout << "No error detected" << std::endl;
+    else
+        std::cout << "Error: there is " << nb_error << " errors." << std::endl;
+
+    int add_time = static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count());
+    int check_time = static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count());
+    std::cout << "Added " << nb_added_voxel << " voxels in " << add_time << "ms, " << int(nb_added_voxel / float(add_time / 1000.f)) << " voxels/s." << std::endl;
+    std::cout << "Check Side in " << check_time << "ms." << std::endl;
+    std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_error == 0;
+}
+
+template <typename T_Container>
+bool test_remove_voxel()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_remove_voxel (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+    voxomap::VoxelOctree<T_Container> octree;
+
+    std::vector<voxomap::test::Data> testValues;
+    std::vector<voxomap::test::Data> removeTestValues;
+    std::mt19937 r(42);
+    for (auto const& data : voxomap::test::gTestValues)
+    {
+        if (r() % 3)
+            removeTestValues.emplace_back(data);
+        else
+            testValues.emplace_back(data);
+    }
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+    for (auto const& data : removeTestValues)
+        octree.removeVoxel(data.x, data.y, data.z);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    size_t read_nb_error = 0;
+    for (auto const& data : testValues)
+    {
+        auto it = octree.findVoxel(data.x, data.y, data.z);
+        if (!it || it.voxel->value != data.value)
+            ++read_nb_error;
+    }
+    for (auto const& data : removeTestValues)
+    {
+        auto it = octree.findVoxel(data.x, data.y, data.z);
+        if (it)
+            ++read_nb_error;
+    }
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    if (read_nb_error == 0)
+        std::cout << "No error detected" << std::endl;
+    else
+        std::cout << "Error: there is " << read_nb_error << " errors." << std::endl;
+
+    std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return read_nb_error == 0;
+}
+
+template <typename T_Container>
+bool test_serialization()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_serialization (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+    voxomap::VoxelOctree<T_Container> octree;
+
+    std::vector<voxomap::test::Data> testValues;
+    std::vector<voxomap::test::Data> removeTestValues;
+    std::mt19937 r(42);
+    for (auto const& data : voxomap::test::gTestValues)
+    {
+        if (r() % 3)
+            removeTestValues.emplace_back(data);
+        else
+            testValues.emplace_back(data);
+    }
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+    for (auto const& data : removeTestValues)
+        octree.removeVoxel(data.x, data.y, data.z);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    size_t size = 0;
+    voxomap::VoxelOctree<T_Container> octree_2;
+    {
+        std::string serialized_octree;
+        octree.serialize(serialized_octree);
+        size = serialized_octree.size();
+        octree.clear();
+        octree_2.unserialize(serialized_octree.data(), serialized_octree.size());
+    }
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    size_t read_nb_error = 0;
+    for (auto const& data : testValues)
+    {
+        auto it = octree_2.findVoxel(data.x, data.y, data.z);
+        if (!it || it.voxel->value != data.value)
+            ++read_nb_error;
+    }
+    for (auto const& data : removeTestValues)
+    {
+        auto it = octree_2.findVoxel(data.x, data.y, data.z);
+        if (it)
+            ++read_nb_error;
+    }
+    auto t4 = std::chrono::high_resolution_clock::now();
+
+    if (read_nb_error == 0)
+        std::cout << "No error detected" << std::endl;
+    else
+        std::cout << "Error: there is " << read_nb_error << " errors." << std::endl;
+
+    std::cout << "Serialization size: ";
+    if (size < 1024)
+        std::cout << size << "B.";
+    else if (size < (1024 * 1024))
+        std::cout << (size / 1024) << "KB.";
+    else
+        std::cout << (size / (1024 * 1024)) << "MB.";
+    std::cout << std::endl;
+
+    std::cout << "Serialization time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count()) << "ms." << std::endl;
+    std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t4 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return read_nb_error == 0;
+}
+
+template <typename T_Container>
+bool test_stream_serialization()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_stream_serialization (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+    voxomap::VoxelOctree<T_Container> octree;
+
+    std::vector<voxomap::test::Data> testValues;
+    std::vector<voxomap::test::Data> removeTestValues;
+    std::mt19937 r(42);
+    for (auto const& data : voxomap::test::gTestValues)
+    {
+        if (r() % 3)
+            removeTestValues.emplace_back(data);
+        else
+            testValues.emplace_back(data);
+    }
+
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+    for (auto const& data : removeTestValues)
+        octree.removeVoxel(data.x, data.y, data.z);
+
+    size_t nb_error = 0;
+    size_t size = 0;
+    voxomap::VoxelOctree<T_Container> octree_2;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    {
+        // Small buffers, the containers are split between several reads and writes
+        std::stringstream stream;
+        voxomap::StreamWriter writer(stream, 4096);
+        if (!octree.serialize(writer) || !writer.flush())
+            ++nb_error;
+        size = writer.getSize();
+
+        voxomap::StreamReader reader(stream, 1024);
+        if (!octree_2.unserialize(reader) || reader.getSize() != size)
+            ++nb_error;
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    for (auto const& data : testValues)
+    {
+        auto it = octree_2.findVoxel(data.x, data.y, data.z);
+        if (!it || it.voxel->value != data.value)
+            ++nb_error;
+    }
+    for (auto const& data : removeTestValues)
+    {
+        auto it = octree_2.findVoxel(data.x, data.y, data.z);
+        if (it)
+            ++nb_error;
+    }
+
+    // Truncated data
+    {
+        std::string serialized_octree;
+        voxomap::StreamWriter writer([&serialized_octree](char const* data, size_t size) {
+            serialized_octree.append(data, size);
+            return true;
+        });
+        octree.serialize(writer);
+        writer.flush();
+        serialized_octree.resize(serialized_octree.size() / 2);
+
+        std::istringstream stream(serialized_octree);
+        voxomap::StreamReader reader(stream);
+        voxomap::VoxelOctree<T_Container> octree_3;
+        if (octree_3.unserialize(reader))
+            ++nb_error;
+    }
+
+    // Empty octree
+    {
+        std::stringstream stream;
+        voxomap::VoxelOctree<T_Container> empty_octree;
+        voxomap::StreamWriter writer(stream);
+        empty_octree.serialize(writer);
+        writer.flush();
+        voxomap::StreamReader reader(stream);
+        if (!empty_octree.unserialize(reader) || empty_octree.getRootNode())
+            ++nb_error;
+    }
+
+    if (nb_error == 0)
+        std::cout << "No error detected" << std::endl;
+    else
+        std::cout << "Error: there is " << nb_error << " errors." << std::endl;
+
+    std::cout << "Serialization size: " << (size / 1024) << "KB." << std::endl;
+    std::cout << "Serialization time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_error == 0;
+}
+
+template <typename T_Container>
+bool test_mapped_serialization()
+{
+    voxomap::test::initGlobalValues(gNbVoxel);
+
+    std::cout << "Launch test_mapped_serialization (" << voxomap::test::type_name<T_Container>() << "):" << std::endl;
+    voxomap::VoxelOctree<T_Container> octree;
+
+    std::vector<voxomap::test::Data> testValues;
+    std::vector<voxomap::test::Data> removeTestValues;
+    std::mt19937 r(42);
+    for (auto const& data : voxomap::test::gTestValues)
+    {
+        if (r() % 3)
+            removeTestValues.emplace_back(data);
+        else
+            testValues.emplace_back(data);
+    }
+
+    for (auto const& data : voxomap::test::gTestValues)
+        octree.putVoxel(data.x, data.y, data.z, data.value);
+    for (auto const& data : removeTestValues)
+        octree.removeVoxel(data.x, data.y, data.z);
+
+    size_t nb_error = 0;
+    std::string const path = "voxomap_mapped_test.bin";
+    std::string serialized_octree;
+    {
+        octree.serializeMapped(serialized_octree);
+        std::ofstream stream(path, std::ios::binary);
+        stream.write(serialized_octree.data(), static_cast<std::streamsize>(serialized_octree.size()));
+    }
+    octree.clear();
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    voxomap::VoxelOctree<T_Container> octree_2;
+    {
+        auto file = voxomap::MappedFile::open(path);
+        if (!octree_2.unserializeMapped(file))
+            ++nb_error;
+
+        // The voxel containers are used in place
+        if (T_Container::MAPPABLE && !testValues.empty())
+        {
+            auto it = octree_2.findVoxel(testValues[0].x, testValues[0].y, testValues[0].z);
+            char const* voxel = reinterpret_cast<char const*>(it.voxel);
+            if (!it || voxel < file->getData() || voxel >= file->getData() + file->getSize())
+                ++nb_error;
+        }
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    for (auto const& data : testValues)
+    {
         auto it = octree_2.findVoxel(data.x, data.y, data.z);
         if (!it || it.voxel->value != data.value)
-            ++read_nb_error;
+            ++nb_error;
     }
     for (auto const& data : removeTestValues)
     {
         auto it = octree_2.findVoxel(data.x, data.y, data.z);
         if (it)
-            ++read_nb_error;
+            ++nb_error;
     }
-    auto t4 = std::chrono::high_resolution_clock::now();
 
-    if (read_nb_error == 0)
+    // The modifications don't change the file
+    for (auto const& data : testValues)
+        octree_2.updateVoxel(data.x, data.y, data.z, data.value + 1);
+    size_t nb_voxel = 0;
+    octree_2.exploreVoxelContainer([&nb_voxel](typename T_Container::VoxelContainer const& container) {
+        nb_voxel += container.getNbVoxel();
+    });
+    if (nb_voxel != testValues.size())
+        ++nb_error;
+    {
+        auto file = voxomap::MappedFile::open(path);
+        voxomap::VoxelOctree<T_Container> octree_3;
+        if (!octree_3.unserializeMapped(file))
+            ++nb_error;
+        for (auto const& data : testValues)
+        {
+            auto it = octree_2.findVoxel(data.x, data.y, data.z);
+            if (!it || it.voxel->value != data.value + 1)
+                ++nb_error;
+            it = octree_3.findVoxel(data.x, data.y, data.z);
+            if (!it || it.voxel->value != data.value)
+                ++nb_error;
+        }
+    }
+
+    // Invalid files
+    {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream.write("voxomap", 7);
+    }
+    voxomap::VoxelOctree<T_Container> octree_4;
+    if (octree_4.unserializeMapped(voxomap::MappedFile::open(path)) || octree_4.unserializeMapped(voxomap::MappedFile::open(path + ".none")))
+        ++nb_error;
+
+    // Corrupted leaf records: wrong size and misaligned position
+    for (size_t offset : { 4 * sizeof(uint32_t) + 3 * sizeof(int), 4 * sizeof(uint32_t) })
+    {
+        std::string corrupted = serialized_octree;
+        int value;
+        std::memcpy(&value, &corrupted[offset], sizeof(value));
+        ++value;
+        std::memcpy(&corrupted[offset], &value, sizeof(value));
+        {
+            std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+            stream.write(corrupted.data(), static_cast<std::streamsize>(corrupted.size()));
+        }
+        voxomap::VoxelOctree<T_Container> octree_5;
+        if (octree_5.unserializeMapped(voxomap::MappedFile::open(path)))
+            ++nb_error;
+    }
+    std::remove(path.c_str());
+
+    if (nb_error == 0)
         std::cout << "No error detected" << std::endl;
     else
-        std::cout << "Error: there is " << read_nb_error << " errors." << std::endl;
+        std::cout << "Error: there is " << nb_error << " errors." << std::endl;
 
-    std::cout << "Serialization size: ";
-    if (size < 1024)
-        std::cout << size << "B.";
-    else if (size < (1024 * 1024))
-        std::cout << (size / 1024) << "KB.";
+    std::cout << "Load time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
+    std::cout << std::endl;
+
+    return nb_error == 0;
+}
+
+bool test_palette_container()
+{
+    std::cout << "Launch test_palette_container:" << std::endl;
+    using voxel = voxomap::test::voxel;
+    using Container = voxomap::PaletteContainer<voxel>;
+
+    voxomap::VoxelOctree<Container> octree;
+    voxomap::VoxelOctree<voxomap::ArrayContainer<voxel>> array_octree;
+    size_t nb_error = 0;
+
+    // Few different voxels, like a terrain: 3 values in each container
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int x = 0; x < 64; ++x)
+    {
+        for (int y = 0; y < 64; ++y)
+        {
+            for (int z = 0; z < 64; ++z)
+            {
+                octree.putVoxel(x, y, z, 1 + (x + y + z) % 3);
+                array_octree.putVoxel(x, y, z, 1 + (x + y + z) % 3);
+            }
+        }
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    octree.exploreVoxelContainer([&nb_error](Container const& container) {
+        if (container.getNbVoxel() != 512 || container.getPaletteSize() != 3 || container.getIndexBits() != 2)
+            ++nb_error;
+    });
+    auto usage = octree.memoryUsage();
+    auto array_usage = array_octree.memoryUsage();
+    if (usage.voxelContainers * 4 > array_usage.voxelContainers)
+        ++nb_error;
+
+    // The indices grow with the palette
+    for (int i = 0; i < 512; ++i)
+        octree.updateVoxel(i >> 6, i >> 3 & 7, i & 7, 1000 + i);
+    for (int i = 0; i < 512; ++i)
+    {
+        auto it = octree.findVoxel(i >> 6, i >> 3 & 7, i & 7);
+        if (!it || it.voxel->value != 1000 + i)
+            ++nb_error;
+    }
+    auto node = octree.findVoxelNode(0, 0, 0);
+    if (!node || node->getVoxelContainer()->getIndexBits() != 16 || node->getVoxelContainer()->getPaletteSize() != 512)
+        ++nb_error;
+
+    // The unused entries are reused
+    for (int i = 0; i < 512; ++i)
+        octree.updateVoxel(i >> 6, i >> 3 & 7, i & 7, i % 2);
+    for (int i = 0; i < 256; ++i)
+        octree.removeVoxel(i >> 6, i >> 3 & 7, i & 7);
+    for (int i = 0; i < 512; ++i)
+    {
+        auto it = octree.findVoxel(i >> 6, i >> 3 & 7, i & 7);
+        if ((i < 256) == static_cast<bool>(it) || (it && it.voxel->value != i % 2))
+            ++nb_error;
+    }
+    if (!node || node->getNbVoxel() != 256 || node->getVoxelContainer()->getPaletteSize() != 2)
+        ++nb_error;
+
+    if (nb_error == 0)
+        std::cout << "No error detected" << std::endl;
     else
-        std::cout << (size / (1024 * 1024)) << "MB.";
+        std::cout << "Error: there is " << nb_error << " errors." << std::endl;
+
+    std::cout << "Memory of the voxel containers: " << (usage.voxelContainers / 1024) << "KB instead of " << (array_usage.voxelContainers / 1024) << "KB." << std::endl;
+    std::cout << "Insertion time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
     std::cout << std::endl;
 
-    std::cout << "Serialization time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t3 - t2).count()) << "ms." << std::endl;
-    std::cout << "Total time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t4 - t1).count()) << "ms." << std::endl;
+    return nb_error == 0;
+}
+
+bool test_uniform_container()
+{
+    std::cout << "Launch test_uniform_container:" << std::endl;
+    using voxel = voxomap::test::voxel;
+    using Container = voxomap::SparseContainer<voxel>;
+
+    voxomap::VoxelOctree<Container> octree;
+    voxomap::VoxelOctree<voxomap::ArrayContainer<voxel>> array_octree;
+    size_t nb_error = 0;
+
+    // Solid block: each container is full of the same voxel
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (int x = 0; x < 32; ++x)
+    {
+        for (int y = 0; y < 32; ++y)
+        {
+            for (int z = 0; z < 32; ++z)
+            {
+                octree.putVoxel(x, y, z, 7);
+                array_octree.putVoxel(x, y, z, 7);
+            }
+        }
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    size_t nb_container = 0;
+    octree.exploreVoxelContainer([&nb_error, &nb_container](Container const& container) {
+        ++nb_container;
+        if (!container.getUniformVoxel() || container.getUniformVoxel()->value != 7 || container.getNbVoxel() != 512)
+            ++nb_error;
+    });
+    auto usage = octree.memoryUsage();
+    if (nb_container != 64 || usage.idTables != 0 || usage.voxelContainers != nb_container * (sizeof(Container) + sizeof(voxel)))
+        ++nb_error;
+
+    size_t nb_voxel = 0;
+    octree.exploreVoxel([&nb_error, &nb_voxel](voxomap::VoxelOctree<Container>::iterator const& it) {
+        ++nb_voxel;
+        if (it.voxel->value != 7)
+            ++nb_error;
+    });
+    for (auto it = octree.begin(); it != octree.end(); ++it)
+        --nb_voxel;
+    if (nb_voxel != 0)
+        ++nb_error;
+
+    // The serialized containers only contain one voxel
+    std::string str;
+    std::string array_str;
+    octree.serialize(str);
+    array_octree.serialize(array_str);
+    voxomap::VoxelOctree<Container> octree_2;
+    voxomap::VoxelOctree<voxomap::ArrayContainer<voxel>> array_octree_2;
+    octree_2.unserialize(str.data(), str.size());
+    array_octree_2.unserialize(array_str.data(), array_str.size());
+    if (str.size() > 64 * 64 || array_str.size() > 64 * 64 || octree_2.getNbVoxels() != 32 * 32 * 32)
+        ++nb_error;
+    for (int i = 0; i < 32 * 32 * 32; ++i)
+    {
+        auto it = octree_2.findVoxel(i >> 10, i >> 5 & 31, i & 31);
+        auto ait = array_octree_2.findVoxel(i >> 10, i >> 5 & 31, i & 31);
+        if (!it || it.voxel->value != 7 || !ait || ait.voxel->value != 7)
+            ++nb_error;
+    }
+    auto node = octree_2.findVoxelNode(0, 0, 0);
+    if (!node || !node->getVoxelContainer()->getUniformVoxel())
+        ++nb_error;
+
+    // A different voxel expands the container
+    octree.updateVoxel(1, 2, 3, 8);
+    octree.removeVoxel(9, 2, 3);
+    node = octree.findVoxelNode(0, 0, 0);
+    auto node_2 = octree.findVoxelNode(8, 0, 0);
+    if (!node || node->getVoxelContainer()->getUniformVoxel() || !node_2 || node_2->getVoxelContainer()->getUniformVoxel() || node_2->getNbVoxel() != 511)
+        ++nb_error;
+    for (int i = 0; i < 32 * 32 * 32; ++i)
+    {
+        int x = i >> 10, y = i >> 5 & 31, z = i & 31;
+        auto it = octree.findVoxel(x, y, z);
+        if (x == 9 && y == 2 && z == 3)
+        {
+            if (it)
+                ++nb_error;
+        }
+        else if (!it || it.voxel->value != ((x == 1 && y == 2 && z == 3) ? 8 : 7))
+            ++nb_error;
+    }
+
+    // And the container collapses again when it's uniform
+    octree.updateVoxel(1, 2, 3, 7);
+    octree.addVoxel(9, 2, 3, 7);
+    if (!node->getVoxelContainer()->getUniformVoxel() || !node_2->getVoxelContainer()->getUniformVoxel())
+        ++nb_error;
+
+    if (nb_error == 0)
+        std::cout << "No error detected" << std::endl;
+    else
+        std::cout << "Error: there is " << nb_error << " errors." << std::endl;
+
+    std::cout << "Serialized size: " << str.size() << " bytes instead of " << 64 * 512 * sizeof(voxel) << " bytes." << std::endl;
+    std::cout << "Insertion time: " << static_cast<int>(std::chrono::duration<double, std::milli>(t2 - t1).count()) << "ms." << std::endl;
     std::cout << std::endl;
 
-    return read_nb_error == 0;
+    return nb_error == 0;
+}
+
+template <typename T_Container>
+size_t check_occupancy()
+{
+    voxomap::VoxelOctree<T_Container> octree;
+    std::mt19937 r(42);
+    size_t nb_error = 0;
+
+    for (int i = 0; i < 4000; ++i)
+        octree.putVoxel(r() % 24, r() % 24, r() % 24, r() % 4 + 1);
+    for (int i = 0; i < 2000; ++i)
+        octree.removeVoxel(r() % 24, r() % 24, r() % 24);
+
+    size_t nb_voxel = 0;
+    octree.exploreVoxelContainer([&nb_error, &nb_voxel](T_Container const& container) {
+        auto const& occupancy = container.getOccupancy();
+        nb_voxel += occupancy.count();
+        if (occupancy.count() != container.getNbVoxel())
+            ++nb_error;
+        for (uint8_t x = 0; x < T_Container::NB_VOXELS; ++x)
+        {
+            for (uint8_t y = 0; y < T_Container::NB_VOXELS; ++y)
+            {
+                for (uint8_t z = 0; z < T_Container::NB_VOXELS; ++z)
+                {
+                    if (occupancy.test(x, y, z) != (container.findVoxel(x, y, z) != nullptr))
+                        ++nb_error;
+                }
+            }
+        }
+    });
+
+    // The iterator goes through the occupied cells only
+    for (auto it = octree.begin(); it != octree.end(); ++it)
+    {
+        if (!it.voxel)
+            ++nb_error;
+        --nb_voxel;
+    }
+    if (nb_voxel != 0)
+        ++nb_error;
+    return nb_error;
+}
+
+template <typename T_Container>
+size_t check_zero_voxel_serialization()
+{
+    voxomap::VoxelOctree<T_Container> octree;
+    size_t nb_error = 0;
+
+    // A full container where 8 voxels have the same bytes as an empty voxel
+    for (int i = 0; i < 512; ++i)
+        octree.putVoxel(i >> 6, i >> 3 & 7, i & 7, i % 64);
+
+    std::string str;
+    octree.serialize(str);
+    voxomap::VoxelOctree<T_Container> octree_2;
+    if (octree_2.unserialize(str.data(), str.size()) != str.size())
+        ++nb_error;
+
+    size_t nb_voxel = 0;
+    octree_2.exploreVoxelContainer([&nb_voxel](T_Container const& container) {
+        nb_voxel += container.getOccupancy().count();
+    });
+    if (nb_voxel != 512 || octree_2.getNbVoxels() != 512)
+        ++nb_error;
+    for (int i = 0; i < 512; ++i)
+    {
+        auto it = octree_2.findVoxel(i >> 6, i >> 3 & 7, i & 7);
+        if (!it || it.voxel->value != i % 64)
+            ++nb_error;
+    }
+    return nb_error;
+}
+
+bool test_occupancy_mask()
+{
+    std::cout << "Launch test_occupancy_mask:" << std::endl;
+    size_t nb_error = 0;
+
+    voxomap::OccupancyMask mask;
+    std::mt19937 r(42);
+    bool cells[512] = {};
+    for (int i = 0; i < 100; ++i)
+    {
+        int id = r() % 512;
+        cells[id] = true;
+        mask.set(static_cast<uint8_t>(id >> 6), static_cast<uint8_t>(id >> 3 & 7), static_cast<uint8_t>(id & 7));
+    }
+    mask.set(7, 7, 7);
+    cells[511] = true;
+    mask.reset(0, 0, 0);
+    cells[0] = false;
+
+    uint16_t nb_cell = 0;
+    for (uint16_t id = 0; id < 512; ++id)
+    {
+        nb_cell += cells[id];
+        uint16_t next = id;
+        while (next < 512 && !cells[next])
+            ++next;
+        if (mask.findNext(id) != next)
+            ++nb_error;
+    }
+    if (mask.count() != nb_cell || mask.findNext(512) != 512)
+        ++nb_error;
+
+    for (uint8_t size = 1; size <= 8; size <<= 1)
+    {
+        for (uint8_t x = 0; x < 8; x += size)
+        {
+            for (uint8_t y = 0; y < 8; y += size)
+            {
+                for (uint8_t z = 0; z < 8; z += size)
+                {
+                    bool found = false;
+                    for (uint16_t id = 0; id < 512; ++id)
+                    {
+                        found |= cells[id] && (id >> 6) >= x && (id >> 6) < x + size &&
+                            (id >> 3 & 7) >= y && (id >> 3 & 7) < y + size &&
+                            (id & 7) >= z && (id & 7) < z + size;
+                    }
+                    if (mask.testBox(x, y, z, size) != found)
+                        ++nb_error;
+                }
+            }
+        }
+    }
+
+    mask.fill();
+    if (mask.count() != 512 || !mask.testBox(4, 4, 4, 2))
+        ++nb_error;
+    mask.clear();
+    if (mask.count() != 0 || mask.test(3) || mask.findNext(0) != 512)
+        ++nb_error;
+
+    nb_error += check_occupancy<voxomap::SparseContainer<voxomap::test::voxel>>();
+    nb_error += check_occupancy<voxomap::ArrayContainer<voxomap::test::voxel>>();
+    nb_error += check_occupancy<voxomap::PaletteContainer<voxomap::test::voxel>>();
+    nb_error += check_zero_voxel_serialization<voxomap::SparseContainer<voxomap::test::voxel>>();
+    nb_error += check_zero_voxel_serialization<voxomap::ArrayContainer<voxomap::test::voxel>>();
+    nb_error += check_zero_voxel_serialization<voxomap::PaletteContainer<voxomap::test::voxel>>();
+
+    if (nb_error == 0)
+        std::cout << "No error detected" << std::endl;
+    else
+        std::cout << "Error: there is " << nb_error << " errors." << std::endl;
+    std::cout << std::endl;
+
+    return nb_error == 0;
 }
 
 template <typename T_Container>
@@ -585,9 +2157,25 @@ void launchTest()
     g_error |= !test_iterator<T_Container>();
     g_error |= !test_remove_voxel<T_Container>();
     g_error |= !test_serialization<T_Container>();
+    g_error |= !test_delta_serialization<T_Container>();
+    g_error |= !test_stream_serialization<T_Container>();
+    g_error |= !test_mapped_serialization<T_Container>();
     g_error |= !test_find_relative_voxel<T_Container>();
     g_error |= !test_find_relative_voxel_with_cache<T_Container>();
     g_error |= !test_local_search_utility<T_Container>();
+    g_error |= !test_find_neighbors<T_Container>();
+    g_error |= !test_batch_insertion<T_Container>();
+    g_error |= !test_find_voxels<T_Container>();
+    g_error |= !test_concurrent_read<T_Container>();
+    g_error |= !test_leaf_index<T_Container>();
+    g_error |= !test_listener<T_Container>();
+    g_error |= !test_voxel_accessor<T_Container>();
+    g_error |= !test_frozen_octree<T_Container>();
+    g_error |= !test_snapshot<T_Container>();
+    g_error |= !test_explore<T_Container>();
+    g_error |= !test_parallel_explore<T_Container>();
+    g_error |= !test_memory_pool<T_Container>();
+    g_error |= !test_memory_usage<T_Container>();
     std::cout << "------- END -------\n\n\n";
 }
 
@@ -602,10 +2190,15 @@ int main(int argc, char* argv[])
     // No super container
     launchTest<voxomap::SparseContainer<voxel>>();
     launchTest<voxomap::ArrayContainer<voxel>>();
+    g_error |= !test_uniform_container();
+    g_error |= !test_occupancy_mask();
     test_sided_container<voxomap::SidedContainer<SparseContainer, voxel>>();
     launchTest<voxomap::SidedContainer<SparseContainer, voxel>>();
     test_sided_container<voxomap::SidedContainer<voxomap::ArrayContainer, voxel>>();
     launchTest<voxomap::SidedContainer<voxomap::ArrayContainer, voxel>>();
+    g_error |= !test_palette_container();
+    launchTest<voxomap::PaletteContainer<voxel>>();
+    test_sided_container<voxomap::SidedContainer<voxomap::PaletteContainer, voxel>>();
 
     // One super container
     launchTest<voxomap::SparseSuperContainer<voxomap::SparseContainer<voxel>>>();
@@ -614,6 +2207,8 @@ int main(int argc, char* argv[])
     launchTest<voxomap::SparseSuperContainer<voxomap::SidedContainer<SparseContainer, voxel>>>();
     test_sided_container<voxomap::ArraySuperContainer<voxomap::SidedContainer<voxomap::ArrayContainer, voxel>>>();
     launchTest<voxomap::ArraySuperContainer<voxomap::SidedContainer<voxomap::ArrayContainer, voxel>>>();
+    test_sided_container<voxomap::SparseSuperContainer<voxomap::SidedContainer<voxomap::PaletteContainer, voxel>>>();
+    launchTest<voxomap::SparseSuperContainer<voxomap::SidedContainer<voxomap::PaletteContainer, voxel>>>();
 
     // Multiple super container
     launchTest<voxomap::SparseSuperContainer<voxomap::SparseSuperContainer<voxomap::SparseContainer<voxel>>>>();
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <cstdint>
+#include "Vector3.hpp"
 
 namespace voxomap
 {
@@ -60,13 +61,48 @@ public:
     */
     VoxelNode<T_Container>* findVoxelNode(int x, int y, int z);
     /*!
-        \brief !! NOT IMPLEMENTED YET !! Find voxels inside the radius
-        \return Vector of iterator that point on found voxels
+        \brief Find voxels inside the sphere centered on the reference position
+        \details Only the nodes and the containers intersecting the sphere are explored,
+        the empty rows of the containers are skipped.
+        \param radius Radius of the sphere, in voxels
+        \return Vector of iterator that point on found voxels, sorted by increasing distance
     */
     std::vector<iterator>   findNeighbors(float radius);
 
 private:
+    /*!
+        \brief Voxel found by findNeighbors
+    */
+    struct Neighbor
+    {
+        int64_t distance;   //!< Squared distance from the reference position
+        iterator it;        //!< Iterator on the voxel
+    };
+
     VoxelNode<T_Container>* _findVoxelNode(int x, int y, int z);
+    /*!
+        \brief Search neighbors inside \a node and its children
+    */
+    void                    findNeighbors(VoxelNode<T_Container> const& node, int64_t squaredRadius, std::vector<Neighbor>& neighbors) const;
+    /*!
+        \brief Search neighbors inside a super container
+        \param it Iterator on the node of the container
+        \param container The super container
+        \param boxPosition Position of \a container inside the node
+        \param squaredRadius Squared radius of the sphere
+        \param neighbors Found voxels
+    */
+    template <typename T>
+    void                    findNeighbors(iterator& it, T const& container, Vector3I const& boxPosition, int64_t squaredRadius, std::vector<Neighbor>& neighbors) const;
+    /*!
+        \brief Search neighbors inside a voxel container
+        \param it Iterator on the node of the container
+        \param container The voxel container
+        \param boxPosition Position of \a container inside the node
+        \param squaredRadius Squared radius of the sphere
+        \param neighbors Found voxels
+    */
+    void                    findNeighbors(iterator& it, typename T_Container::VoxelContainer const& container, Vector3I const& boxPosition, int64_t squaredRadius, std::vector<Neighbor>& neighbors) const;
 
     int                             _x = 0;
     int                             _y = 0;
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cmath>
+
 namespace voxomap
 {
 
@@ -13,7 +16,7 @@ LocalSearchUtility<T_Container>::LocalSearchUtility(iterator const& it)
 
 template <class T_Container>
 LocalSearchUtility<T_Container>::LocalSearchUtility(VoxelNode<T_Container> const& node, uint8_t x, uint8_t y, uint8_t z)
-    : _x(node.getX() + x), _y(node.getX() + y), _z(node.getX() + z),
+    : _x(node.getX() + x), _y(node.getY() + y), _z(node.getZ() + z),
       _octree(static_cast<VoxelOctree<T_Container>*>(node.getOctree())), _node(&node)
 {
 }
@@ -75,13 +78,197 @@ VoxelNode<T_Container>* LocalSearchUtility<T_Container>::_findVoxelNode(int x, i
     return nullptr;
 }
 
+/*!
+    \brief Distance between \a position and the segment [\a min, \a max]
+*/
+inline static int64_t neighborAxisDistance(int position, int min, int max)
+{
+    if (position < min)
+        return static_cast<int64_t>(min) - position;
+    if (position > max)
+        return static_cast<int64_t>(position) - max;
+    return 0;
+}
+
+/*!
+    \brief Biggest integer radius whose square is lower or equal to \a squaredRadius
+*/
+inline static int neighborRadius(int64_t squaredRadius)
+{
+    int64_t radius = static_cast<int64_t>(std::sqrt(static_cast<double>(squaredRadius)));
+    while (radius * radius > squaredRadius)
+        --radius;
+    while ((radius + 1) * (radius + 1) <= squaredRadius)
+        ++radius;
+    return static_cast<int>(radius);
+}
+
+/*!
+    \brief Compute the range of cells intersecting [\a center - \a radius, \a center + \a radius]
+    \param center Position of the center relative to the first cell
+    \param radius Radius of the search
+    \param cellSize Size of one cell
+    \param nbCells Number of cells
+    \param first First cell of the range
+    \param last Last cell of the range
+    \return False if the range is empty
+*/
+inline static bool neighborRange(int center, int radius, int cellSize, int nbCells, int& first, int& last)
+{
+    int64_t min = static_cast<int64_t>(center) - radius;
+    int64_t max = static_cast<int64_t>(center) + radius;
+    if (max < 0 || min >= static_cast<int64_t>(cellSize) * nbCells)
+        return false;
+    first = min < 0 ? 0 : static_cast<int>(min / cellSize);
+    last = static_cast<int>(std::min<int64_t>(max / cellSize, nbCells - 1));
+    return true;
+}
+
 template <class T_Container>
 std::vector<typename T_Container::iterator> LocalSearchUtility<T_Container>::findNeighbors(float radius)
 {
     std::vector<iterator> neighbors;
+    if (radius < 0)
+        return neighbors;
 
-    assert(false && "LocalSearchUtility::findNeighbors not yet implemented !!!");
+    VoxelNode<T_Container> const* root = _octree ? _octree->getRootNode() : _node;
+    while (root && root->getParent())
+        root = root->getParent();
+    if (!root)
+        return neighbors;
+
+    std::vector<Neighbor> tmp;
+    this->findNeighbors(*root, static_cast<int64_t>(static_cast<double>(radius) * radius), tmp);
+    std::sort(tmp.begin(), tmp.end(), [](Neighbor const& a, Neighbor const& b) { return a.distance < b.distance; });
+
+    neighbors.reserve(tmp.size());
+    for (auto const& neighbor : tmp)
+        neighbors.push_back(neighbor.it);
     return neighbors;
 }
 
-}
\ No newline at end of file
+template <class T_Container>
+void LocalSearchUtility<T_Container>::findNeighbors(VoxelNode<T_Container> const& node, int64_t squaredRadius, std::vector<Neighbor>& neighbors) const
+{
+    if (node.getSize() == T_Container::NB_VOXELS)
+    {
+        if (!node.hasVoxel())
+            return;
+
+        iterator it;
+        it.node = const_cast<VoxelNode<T_Container>*>(&node);
+        this->findNeighbors(it, *node.getVoxelContainer(), Vector3I(0, 0, 0), squaredRadius, neighbors);
+        return;
+    }
+
+    for (auto child : node.getChildren())
+    {
+        if (!child)
+            continue;
+
+        int last = static_cast<int>(child->getSize()) - 1;
+        int64_t dx = neighborAxisDistance(_x, child->getX(), child->getX() + last);
+        int64_t dy = neighborAxisDistance(_y, child->getY(), child->getY() + last);
+        int64_t dz = neighborAxisDistance(_z, child->getZ(), child->getZ() + last);
+        if (dx * dx + dy * dy + dz * dz <= squaredRadius)
+            this->findNeighbors(*child, squaredRadius, neighbors);
+    }
+}
+
+template <class T_Container>
+template <typename T>
+void LocalSearchUtility<T_Container>::findNeighbors(iterator& it, T const& container, Vector3I const& boxPosition, int64_t squaredRadius, std::vector<Neighbor>& neighbors) const
+{
+    const int size = T::Container::NB_VOXELS;
+    const int cx = _x - it.node->getX() - boxPosition.x;
+    const int cy = _y - it.node->getY() - boxPosition.y;
+    const int cz = _z - it.node->getZ() - boxPosition.z;
+    int firstX, lastX, firstY, lastY, firstZ, lastZ;
+
+    if (!neighborRange(cx, neighborRadius(squaredRadius), size, T::NB_CONTAINERS, firstX, lastX))
+        return;
+    for (int sx = firstX; sx <= lastX; ++sx)
+    {
+        if (!container.hasContainer(sx))
+            continue;
+
+        int64_t dx = neighborAxisDistance(cx, sx * size, sx * size + size - 1);
+        int64_t remainingX = squaredRadius - dx * dx;
+        if (!neighborRange(cy, neighborRadius(remainingX), size, T::NB_CONTAINERS, firstY, lastY))
+            continue;
+        for (int sy = firstY; sy <= lastY; ++sy)
+        {
+            if (!container.hasContainer(sx, sy))
+                continue;
+
+            int64_t dy = neighborAxisDistance(cy, sy * size, sy * size + size - 1);
+            int64_t remainingY = remainingX - dy * dy;
+            if (remainingY < 0 || !neighborRange(cz, neighborRadius(remainingY), size, T::NB_CONTAINERS, firstZ, lastZ))
+                continue;
+            for (int sz = firstZ; sz <= lastZ; ++sz)
+            {
+                auto subContainer = container.findContainer(sx, sy, sz);
+                if (!subContainer)
+                    continue;
+
+                it.containerPosition[T::SUPERCONTAINER_ID].x = static_cast<uint8_t>(sx);
+                it.containerPosition[T::SUPERCONTAINER_ID].y = static_cast<uint8_t>(sy);
+                it.containerPosition[T::SUPERCONTAINER_ID].z = static_cast<uint8_t>(sz);
+                Vector3I subBoxPosition(boxPosition.x + sx * size, boxPosition.y + sy * size, boxPosition.z + sz * size);
+                this->findNeighbors(it, *subContainer, subBoxPosition, squaredRadius, neighbors);
+            }
+        }
+    }
+}
+
+template <class T_Container>
+void LocalSearchUtility<T_Container>::findNeighbors(iterator& it, typename T_Container::VoxelContainer const& container, Vector3I const& boxPosition, int64_t squaredRadius, std::vector<Neighbor>& neighbors) const
+{
+    using VoxelContainer = typename T_Container::VoxelContainer;
+    const int cx = _x - it.node->getX() - boxPosition.x;
+    const int cy = _y - it.node->getY() - boxPosition.y;
+    const int cz = _z - it.node->getZ() - boxPosition.z;
+    int firstX, lastX, firstY, lastY, firstZ, lastZ;
+
+    if (!neighborRange(cx, neighborRadius(squaredRadius), 1, VoxelContainer::NB_VOXELS, firstX, lastX))
+        return;
+    for (int x = firstX; x <= lastX; ++x)
+    {
+        if (!container.hasVoxel(x))
+            continue;
+
+        int64_t dx = static_cast<int64_t>(x) - cx;
+        int64_t remainingX = squaredRadius - dx * dx;
+        if (!neighborRange(cy, neighborRadius(remainingX), 1, VoxelContainer::NB_VOXELS, firstY, lastY))
+            continue;
+        for (int y = firstY; y <= lastY; ++y)
+        {
+            if (!container.hasVoxel(x, y))
+                continue;
+
+            int64_t dy = static_cast<int64_t>(y) - cy;
+            int64_t remainingY = remainingX - dy * dy;
+            if (remainingY < 0 || !neighborRange(cz, neighborRadius(remainingY), 1, VoxelContainer::NB_VOXELS, firstZ, lastZ))
+                continue;
+            for (int z = firstZ; z <= lastZ; ++z)
+            {
+                auto voxel = container.findVoxel(x, y, z);
+                if (!voxel)
+                    continue;
+
+                int64_t dz = static_cast<int64_t>(z) - cz;
+                Neighbor neighbor;
+                neighbor.distance = squaredRadius - remainingY + dz * dz;
+                neighbor.it = it;
+                neighbor.it.voxelContainer = const_cast<VoxelContainer*>(&container);
+                neighbor.it.voxel = const_cast<VoxelData*>(voxel);
+                neighbor.it.x = static_cast<uint8_t>(x);
+                neighbor.it.y = static_cast<uint8_t>(y);
+                neighbor.it.z = static_cast<uint8_t>(z);
+                neighbors.push_back(neighbor);
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,62 @@
+#ifndef _VOXOMAP_MAPPEDFILE_HPP_
+#define _VOXOMAP_MAPPEDFILE_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace voxomap
+{
+
+/*! \class MappedFile
+    \ingroup Utility
+    \brief File mapped in memory, used to load an octree without copying its voxel containers
+    \details The file is mapped privately: the pages are read on demand, and a page modified in memory
+    is copied by the system without modifying the file.
+    On Windows, the file is read inside a buffer.
+*/
+class MappedFile
+{
+public:
+    MappedFile(MappedFile const& other) = delete;
+    /*!
+        \brief Destructor, unmaps the file
+    */
+    ~MappedFile();
+    MappedFile& operator=(MappedFile const& other) = delete;
+
+    /*!
+        \brief Maps the file \a path
+        \details The objects using the mapped memory must share the ownership of the returned pointer.
+        \return The mapped file, nullptr if the file can't be opened
+    */
+    static std::shared_ptr<MappedFile> open(std::string const& path);
+
+    /*!
+        \brief Returns the beginning of the mapped memory, aligned on a page
+    */
+    char*               getData() const;
+    /*!
+        \brief Returns the size of the file
+    */
+    size_t              getSize() const;
+
+private:
+    /*!
+        \brief Default constructor, use MappedFile::open
+    */
+    MappedFile() = default;
+
+    char*               _data = nullptr;    //!< Mapped memory
+    size_t              _size = 0;          //!< Size of the file
+#ifdef _WIN32
+    std::vector<char>   _buffer;            //!< Content of the file
+#endif
+};
+
+}
+
+#include "MappedFile.ipp"
+
+#endif // _VOXOMAP_MAPPEDFILE_HPP_
@@ -0,0 +1,68 @@
+#ifdef _WIN32
+# include <fstream>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace voxomap
+{
+
+inline MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+    if (_data)
+        ::munmap(_data, _size);
+#endif
+}
+
+inline std::shared_ptr<MappedFile> MappedFile::open(std::string const& path)
+{
+    std::shared_ptr<MappedFile> file(new MappedFile());
+
+#ifdef _WIN32
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream)
+        return nullptr;
+    file->_buffer.resize(static_cast<size_t>(stream.tellg()));
+    stream.seekg(0);
+    if (!stream.read(file->_buffer.data(), static_cast<std::streamsize>(file->_buffer.size())))
+        return nullptr;
+    file->_data = file->_buffer.data();
+    file->_size = file->_buffer.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        return nullptr;
+    }
+
+    // Private mapping: a write copies the page instead of modifying the file
+    void* data = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return nullptr;
+    file->_data = static_cast<char*>(data);
+    file->_size = static_cast<size_t>(info.st_size);
+#endif
+    return file;
+}
+
+inline char* MappedFile::getData() const
+{
+    return _data;
+}
+
+inline size_t MappedFile::getSize() const
+{
+    return _size;
+}
+
+}
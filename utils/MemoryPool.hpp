@@ -0,0 +1,238 @@
+#ifndef _VOXOMAP_MEMORYPOOL_HPP_
+#define _VOXOMAP_MEMORYPOOL_HPP_
+
+#include <cstddef>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace voxomap
+{
+
+/*!
+    \ingroup Utility
+    \brief Returns the smallest power of two from \a slabSize that holds \a nbBlocks blocks after the header
+*/
+constexpr size_t computeSlabSize(size_t slabSize, size_t headerSize, size_t blockSize, size_t nbBlocks)
+{
+    return (slabSize - headerSize) / blockSize >= nbBlocks ? slabSize : computeSlabSize(slabSize * 2, headerSize, blockSize, nbBlocks);
+}
+
+/*! \class MemoryPool
+    \ingroup Utility
+    \brief Allocator of fixed size blocks, grouped in slabs
+    \details Freed blocks are kept in a free list of their slab and reused by the next allocations.
+    A slab is released when all its blocks are freed, except the last partially used slab
+    that is kept to avoid allocating and releasing a slab in loop.
+    Slabs are aligned on their size, the slab of a block is found from its address
+    so a block has no header and can be released without knowing its pool.
+    An octree owns a pool for its nodes, get() returns the pool shared by the other objects of the same size.
+    The voxel containers use the shared pools, they are shared between the octrees, their snapshots
+    and their frozen copies, so they don't belong to one octree.
+    A pool is thread safe. The shared pool is used by all the threads, so each thread keeps a cache
+    of free blocks and only locks the pool to exchange a batch of blocks with it.
+    \tparam T_Size Size of a block
+*/
+template <size_t T_Size>
+class MemoryPool
+{
+    /*!
+        \brief Header of a slab, the blocks follow it
+    */
+    struct Slab
+    {
+        MemoryPool*     pool = nullptr;     //!< Pool of the slab
+        Slab*           prev = nullptr;     //!< Previous slab with free blocks
+        Slab*           next = nullptr;     //!< Next slab with free blocks
+        Slab*           prevSlab = nullptr; //!< Previous slab of the pool
+        Slab*           nextSlab = nullptr; //!< Next slab of the pool
+        void*           freeList = nullptr; //!< Freed blocks of the slab, each one starts with the next one
+        size_t          nbUsedBlocks = 0;   //!< Number of used blocks
+        size_t          nbInitBlocks = 0;   //!< Number of blocks already given, blocks after are never used
+
+        /*!
+            \brief Returns the block \a i of the slab
+        */
+        void*           getBlock(size_t i);
+    };
+
+public:
+    static const size_t BLOCK_SIZE = (T_Size + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);  //!< Size of a block, aligned for any type
+    static const size_t SLAB_HEADER_SIZE = (sizeof(Slab) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);  //!< Size of the slab header
+    static const size_t SLAB_SIZE = computeSlabSize(65536, SLAB_HEADER_SIZE, BLOCK_SIZE, 32);   //!< Size of a slab, 64KiB or the smallest power of two with 32 blocks
+    static const size_t NB_BLOCKS_PER_SLAB = (SLAB_SIZE - SLAB_HEADER_SIZE) / BLOCK_SIZE;      //!< Number of blocks inside a slab
+    static const size_t NB_CACHED_BLOCKS = (NB_BLOCKS_PER_SLAB < 4) ? 2 : NB_BLOCKS_PER_SLAB / 2;  //!< Maximum number of blocks in the cache of a thread
+
+    /*!
+        \brief Deleter for the pools created with create()
+    */
+    struct Deleter
+    {
+        void operator()(MemoryPool* pool) const { pool->destroy(); }
+    };
+
+    /*!
+        \brief Returns the pool shared by the objects of size \a T_Size
+        \details The pool is never destroyed, so objects freed during the static destruction
+        can still be released.
+    */
+    static MemoryPool&  get();
+    /*!
+        \brief Creates a pool, released with destroy()
+    */
+    static MemoryPool*  create();
+    /*!
+        \brief Destroys the pool
+        \details The blocks still used keep the pool alive, it is deleted with its last block.
+    */
+    void                destroy();
+
+    /*!
+        \brief Allocates a block of \a T_Size bytes
+    */
+    void*               allocate();
+    /*!
+        \brief Releases a block allocated by any pool of this size
+    */
+    static void         deallocate(void* ptr);
+    /*!
+        \brief Returns the pool that allocated \a ptr
+    */
+    static MemoryPool&  getPool(void const* ptr);
+    /*!
+        \brief Releases all the slabs at once
+        \details All the blocks must be unused, the caller has already destroyed their objects.
+        The shared pool can't be released.
+    */
+    void                releaseAll();
+
+    /*!
+        \brief Returns the number of allocated slabs
+    */
+    size_t              getNbSlabs() const;
+    /*!
+        \brief Returns the number of used blocks, the blocks inside the thread caches are not used
+    */
+    size_t              getNbUsedBlocks() const;
+    /*!
+        \brief Returns the memory allocated by the pool, in bytes
+    */
+    size_t              getAllocatedMemory() const;
+    /*!
+        \brief Returns the memory allocated by the pool that doesn't hold an object: free blocks, padding and slab headers, in bytes
+    */
+    size_t              getFreeMemory() const;
+
+private:
+    static_assert(T_Size >= sizeof(void*), "A block must be able to hold the free list pointer.");
+
+    /*!
+        \brief Free blocks of the shared pool kept by a thread
+    */
+    struct ThreadCache
+    {
+        void*           blocks = nullptr;   //!< Free blocks, each one starts with the next one
+        std::atomic<size_t> nbBlocks;       //!< Number of blocks, only written by the thread
+        ThreadCache*    prev = nullptr;     //!< Previous cache of the shared pool
+        ThreadCache*    next = nullptr;     //!< Next cache of the shared pool
+
+        /*!
+            \brief Registers the cache in the shared pool
+        */
+        ThreadCache();
+        /*!
+            \brief Gives the blocks back to the shared pool at the end of the thread
+        */
+        ~ThreadCache();
+        /*!
+            \brief Adds \a block to the cache
+        */
+        void            push(void* block);
+        /*!
+            \brief Removes a block from the cache
+        */
+        void*           pop();
+    };
+
+    MemoryPool() = default;
+    ~MemoryPool() = default;
+    MemoryPool(MemoryPool const& other) = delete;
+    MemoryPool& operator=(MemoryPool const& other) = delete;
+
+    /*!
+        \brief Returns the slab that contains \a ptr
+    */
+    static Slab*        getSlab(void const* ptr);
+    /*!
+        \brief Allocates a slab aligned on its size
+    */
+    static void*        allocateSlab();
+    /*!
+        \brief Releases a slab allocated by allocateSlab()
+    */
+    static void         releaseSlab(void* slab);
+
+    /*!
+        \brief Returns the cache of the current thread, nullptr if it is already destroyed
+    */
+    static ThreadCache* getThreadCache();
+
+    /*!
+        \brief Moves \a nbBlocks free blocks of the pool into \a cache
+    */
+    void                fillCache(ThreadCache& cache, size_t nbBlocks);
+    /*!
+        \brief Gives \a nbBlocks blocks of \a cache back to the pool
+    */
+    void                flushCache(ThreadCache& cache, size_t nbBlocks);
+    /*!
+        \brief Returns the number of used blocks, the pool must be locked
+    */
+    size_t              countUsedBlocks() const;
+    /*!
+        \brief Takes a free block, the pool must be locked
+    */
+    void*               allocateBlock();
+    /*!
+        \brief Releases \a ptr inside \a slab, the pool must be locked
+    */
+    void                releaseBlock(Slab* slab, void* ptr);
+    /*!
+        \brief Allocates a new slab and adds it to the lists of the pool
+    */
+    void                addSlab();
+    /*!
+        \brief Removes \a slab from the lists of the pool and releases it
+    */
+    void                removeSlab(Slab* slab);
+    /*!
+        \brief Releases \a ptr inside \a slab
+        \return True if the pool is destroyed and its last block is released
+    */
+    bool                release(Slab* slab, void* ptr);
+    /*!
+        \brief Adds \a slab to the list of slabs with free blocks
+    */
+    void                link(Slab* slab);
+    /*!
+        \brief Removes \a slab from the list of slabs with free blocks
+    */
+    void                unlink(Slab* slab);
+
+    mutable std::mutex  _mutex;                 //!< Protects the pool
+    Slab*               _slabs = nullptr;       //!< All the slabs
+    Slab*               _freeSlabs = nullptr;   //!< Slabs with free blocks
+    size_t              _nbSlabs = 0;           //!< Number of allocated slabs
+    size_t              _nbUsedBlocks = 0;      //!< Number of blocks given by the slabs, with the cached ones
+    ThreadCache*        _threadCaches = nullptr;    //!< Caches of the threads, for the shared pool
+    bool                _destroyed = false;     //!< The pool is deleted with its last block
+    bool                _shared = false;        //!< The pool is returned by get(), its blocks go through the thread caches
+
+    static thread_local bool _threadCacheDestroyed; //!< The cache of the thread is destroyed, the blocks go directly to the pool
+};
+
+}
+
+#include "MemoryPool.ipp"
+
+#endif // _VOXOMAP_MEMORYPOOL_HPP_
@@ -0,0 +1,364 @@
+#include <new>
+#include <assert.h>
+#ifdef _WIN32
+# include <malloc.h>
+#else
+# include <cstdlib>
+#endif
+
+namespace voxomap
+{
+
+template <size_t T_Size>
+const size_t MemoryPool<T_Size>::BLOCK_SIZE;
+
+template <size_t T_Size>
+const size_t MemoryPool<T_Size>::SLAB_HEADER_SIZE;
+
+template <size_t T_Size>
+const size_t MemoryPool<T_Size>::SLAB_SIZE;
+
+template <size_t T_Size>
+const size_t MemoryPool<T_Size>::NB_BLOCKS_PER_SLAB;
+
+template <size_t T_Size>
+const size_t MemoryPool<T_Size>::NB_CACHED_BLOCKS;
+
+template <size_t T_Size>
+thread_local bool MemoryPool<T_Size>::_threadCacheDestroyed = false;
+
+template <size_t T_Size>
+MemoryPool<T_Size>& MemoryPool<T_Size>::get()
+{
+    static MemoryPool* pool = []() {
+        MemoryPool* shared = new MemoryPool();
+        shared->_shared = true;
+        return shared;
+    }();
+    return *pool;
+}
+
+template <size_t T_Size>
+MemoryPool<T_Size>* MemoryPool<T_Size>::create()
+{
+    return new MemoryPool();
+}
+
+template <size_t T_Size>
+void MemoryPool<T_Size>::destroy()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_nbUsedBlocks != 0)
+        {
+            _destroyed = true;
+            return;
+        }
+        while (_slabs)
+            this->removeSlab(_slabs);
+    }
+    delete this;
+}
+
+template <size_t T_Size>
+void* MemoryPool<T_Size>::allocate()
+{
+    ThreadCache* cache = _shared ? getThreadCache() : nullptr;
+    if (cache)
+    {
+        if (cache->nbBlocks.load(std::memory_order_relaxed) == 0)
+            this->fillCache(*cache, NB_CACHED_BLOCKS / 2);
+        return cache->pop();
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    return this->allocateBlock();
+}
+
+template <size_t T_Size>
+void MemoryPool<T_Size>::deallocate(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    Slab* slab = getSlab(ptr);
+    MemoryPool* pool = slab->pool;
+    ThreadCache* cache = pool->_shared ? getThreadCache() : nullptr;
+    if (cache)
+    {
+        cache->push(ptr);
+        if (cache->nbBlocks.load(std::memory_order_relaxed) > NB_CACHED_BLOCKS)
+            pool->flushCache(*cache, NB_CACHED_BLOCKS / 2);
+    }
+    else if (pool->release(slab, ptr))
+        delete pool;
+}
+
+template <size_t T_Size>
+MemoryPool<T_Size>& MemoryPool<T_Size>::getPool(void const* ptr)
+{
+    return *getSlab(ptr)->pool;
+}
+
+template <size_t T_Size>
+void MemoryPool<T_Size>::releaseAll()
+{
+    assert(!_shared && "The shared pool can't be released.");
+    std::lock_guard<std::mutex> lock(_mutex);
+    while (_slabs)
+        this->removeSlab(_slabs);
+    _nbUsedBlocks = 0;
+}
+
+template <size_t T_Size>
+size_t MemoryPool<T_Size>::getNbSlabs() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _nbSlabs;
+}
+
+template <size_t T_Size>
+size_t MemoryPool<T_Size>::getNbUsedBlocks() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return this->countUsedBlocks();
+}
+
+template <size_t T_Size>
+size_t MemoryPool<T_Size>::getAllocatedMemory() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _nbSlabs * SLAB_SIZE;
+}
+
+template <size_t T_Size>
+size_t MemoryPool<T_Size>::getFreeMemory() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _nbSlabs * SLAB_SIZE - this->countUsedBlocks() * T_Size;
+}
+
+template <size_t T_Size>
+typename MemoryPool<T_Size>::ThreadCache* MemoryPool<T_Size>::getThreadCache()
+{
+    if (_threadCacheDestroyed)
+        return nullptr;
+    static thread_local ThreadCache cache;
+    return &cache;
+}
+
+template <size_t T_Size>
+void MemoryPool<T_Size>::fillCache(ThreadCache& cache, size_t nbBlocks)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (size_t i = 0; i < nbBlocks; ++i)
+        cache.push(this->allocateBlock());
+}
+
+template <size_t T_Size>
+void MemoryPool<T_Size>::flushCache(ThreadCache& cache, size_t nbBlocks)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (size_t i = 0; i < nbBlocks; ++i)
+    {
+        void* block = cache.pop();
+        this->releaseBlock(getSlab(block), block);
+    }
+}
+
+template <size_t T_Size>
+size_t MemoryPool<T_Size>::countUsedBlocks() const
+{
+    // The counters of the caches are read while their threads update them, the sum is an estimation
+    size_t nbCachedBlocks = 0;
+    for (ThreadCache const* cache = _threadCaches; cache; cache = cache->next)
+        nbCachedBlocks += cache->nbBlocks.load(std::memory_order_relaxed);
+    return nbCachedBlocks < _nbUsedBlocks ? _nbUsedBlocks - nbCachedBlocks : 0;
+}
+
+template <size_t T_Size>
+void* MemoryPool<T_Size>::allocateBlock()
+{
+    if (!_freeSlabs)
+        this->addSlab();
+
+    Slab* slab = _freeSlabs;
+    void* block;
+    if (slab->freeList)
+    {
+        block = slab->freeList;
+        slab->freeList = *static_cast<void**>(block);
+    }
+    else
+        block = slab->getBlock(slab->nbInitBlocks++);
+
+    if (++slab->nbUsedBlocks == NB_BLOCKS_PER_SLAB)
+        this->unlink(slab);
+    ++_nbUsedBlocks;
+    return block;
+}
+
+template <size_t T_Size>
+void MemoryPool<T_Size>::releaseBlock(Slab* slab, void* ptr)
+{
+    *static_cast<void**>(ptr) = slab->freeList;
+    slab->freeList = ptr;
+    if (slab->nbUsedBlocks-- == NB_BLOCKS_PER_SLAB)
+        this->link(slab);
+    --_nbUsedBlocks;
+
+    // Release the empty slab if another slab has free blocks
+    if (slab->nbUsedBlocks == 0 && (slab->prev || slab->next))
+        this->removeSlab(slab);
+}
+
+template <size_t T_Size>
+inline typename MemoryPool<T_Size>::Slab* MemoryPool<T_Size>::getSlab(void const* ptr)
+{
+    return reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(SLAB_SIZE - 1));
+}
+
+template <size_t T_Size>
+void* MemoryPool<T_Size>::allocateSlab()
+{
+#ifdef _WIN32
+    void* slab = ::_aligned_malloc(SLAB_SIZE, SLAB_SIZE);
+#else
+    void* slab = nullptr;
+    if (::posix_memalign(&slab, SLAB_SIZE, SLAB_SIZE) != 0)
+        slab = nullptr;
+#endif
+    if (!slab)
+        throw std::bad_alloc();
+    return slab;
+}
+
+template <size_t T_Size>
+void MemoryPool<T_Size>::releaseSlab(void* slab)
+{
+#ifdef _WIN32
+    ::_aligned_free(slab);
+#else
+    ::free(slab);
+#endif
+}
+
+template <size_t T_Size>
+void MemoryPool<T_Size>::addSlab()
+{
+    Slab* slab = new (allocateSlab()) Slab();
+    slab->pool = this;
+    slab->nextSlab = _slabs;
+    if (_slabs)
+        _slabs->prevSlab = slab;
+    _slabs = slab;
+    this->link(slab);
+    ++_nbSlabs;
+}
+
+template <size_t T_Size>
+void MemoryPool<T_Size>::removeSlab(Slab* slab)
+{
+    if (slab->prev || slab->next || _freeSlabs == slab)
+        this->unlink(slab);
+    if (slab->prevSlab)
+        slab->prevSlab->nextSlab = slab->nextSlab;
+    else
+        _slabs = slab->nextSlab;
+    if (slab->nextSlab)
+        slab->nextSlab->prevSlab = slab->prevSlab;
+    slab->~Slab();
+    releaseSlab(slab);
+    --_nbSlabs;
+}
+
+template <size_t T_Size>
+bool MemoryPool<T_Size>::release(Slab* slab, void* ptr)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    this->releaseBlock(slab, ptr);
+    if (_destroyed && _nbUsedBlocks == 0)
+    {
+        while (_slabs)
+            this->removeSlab(_slabs);
+        return true;
+    }
+    return false;
+}
+
+template <size_t T_Size>
+void MemoryPool<T_Size>::link(Slab* slab)
+{
+    slab->prev = nullptr;
+    slab->next = _freeSlabs;
+    if (_freeSlabs)
+        _freeSlabs->prev = slab;
+    _freeSlabs = slab;
+}
+
+template <size_t T_Size>
+void MemoryPool<T_Size>::unlink(Slab* slab)
+{
+    if (slab->prev)
+        slab->prev->next = slab->next;
+    else
+        _freeSlabs = slab->next;
+    if (slab->next)
+        slab->next->prev = slab->prev;
+    slab->prev = nullptr;
+    slab->next = nullptr;
+}
+
+template <size_t T_Size>
+MemoryPool<T_Size>::ThreadCache::ThreadCache()
+    : nbBlocks(0)
+{
+    MemoryPool& pool = get();
+    std::lock_guard<std::mutex> lock(pool._mutex);
+    next = pool._threadCaches;
+    if (next)
+        next->prev = this;
+    pool._threadCaches = this;
+}
+
+template <size_t T_Size>
+MemoryPool<T_Size>::ThreadCache::~ThreadCache()
+{
+    _threadCacheDestroyed = true;
+    MemoryPool& pool = get();
+    pool.flushCache(*this, nbBlocks.load(std::memory_order_relaxed));
+
+    std::lock_guard<std::mutex> lock(pool._mutex);
+    if (prev)
+        prev->next = next;
+    else
+        pool._threadCaches = next;
+    if (next)
+        next->prev = prev;
+}
+
+template <size_t T_Size>
+inline void MemoryPool<T_Size>::ThreadCache::push(void* block)
+{
+    *static_cast<void**>(block) = blocks;
+    blocks = block;
+    nbBlocks.store(nbBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+template <size_t T_Size>
+inline void* MemoryPool<T_Size>::ThreadCache::pop()
+{
+    void* block = blocks;
+    blocks = *static_cast<void**>(block);
+    nbBlocks.store(nbBlocks.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    return block;
+}
+
+template <size_t T_Size>
+inline void* MemoryPool<T_Size>::Slab::getBlock(size_t i)
+{
+    return reinterpret_cast<char*>(this) + SLAB_HEADER_SIZE + i * BLOCK_SIZE;
+}
+
+}
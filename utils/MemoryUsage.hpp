@@ -0,0 +1,99 @@
+#ifndef _VOXOMAP_MEMORYUSAGE_HPP_
+#define _VOXOMAP_MEMORYUSAGE_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <unordered_set>
+
+namespace voxomap
+{
+
+/*! \struct MemoryUsage
+    \ingroup Utility
+    \brief Memory used by a structure, in bytes, split by category
+    \details Each structure adds its own memory with a memoryUsage(MemoryUsage&) method,
+    so the same MemoryUsage can accumulate several structures.
+    The containers shared by copy-on-write are counted once by MemoryUsage, in \a sharedContainers.
+    Values don't include the bookkeeping of the general purpose allocator.
+*/
+struct MemoryUsage
+{
+    /*!
+        \brief Returns the sum of all categories, without the free memory of the shared pools
+    */
+    size_t total() const
+    {
+        return nodes + superContainers + voxelContainers + idTables + sharedContainers + poolFreeMemory + raycastCaches + leafIndex;
+    }
+
+    /*!
+        \brief Returns true the first time the shared \a object is added, false when it is already counted
+    */
+    bool addShared(void const* object)
+    {
+        return sharedObjects.insert(object).second;
+    }
+
+    size_t nodes = 0;               //!< Octree nodes
+    size_t superContainers = 0;     //!< Super containers and their arrays of sub-containers
+    size_t voxelContainers = 0;     //!< Voxel containers and their voxels
+    size_t idTables = 0;            //!< Id tables and free id lists of the SparseIDArray
+    size_t sharedContainers = 0;    //!< Containers shared with other structures, with their sub-containers
+    size_t poolFreeMemory = 0;      //!< Memory of the memory pools of the structure that doesn't hold an object (free blocks, headers)
+    size_t sharedPoolFreeMemory = 0;    //!< Same as \a poolFreeMemory for the pools shared by all the structures, not included in total()
+    size_t raycastCaches = 0;       //!< Raycast caches
+    size_t leafIndex = 0;           //!< Leaf index of the VoxelOctree, estimated
+
+    std::unordered_set<void const*> sharedObjects;  //!< Shared objects already counted
+};
+
+/*!
+    \ingroup Utility
+    \brief Adds the memory used by the container \a container to \a usage
+    \details A container shared with another structure (snapshot, frozen octree, mapped file)
+    is counted once in MemoryUsage::sharedContainers.
+*/
+template <typename T_Container>
+inline void addContainerMemory(std::shared_ptr<T_Container> const& container, MemoryUsage& usage)
+{
+    if (!container)
+        return;
+    if (container.use_count() == 1)
+        container->memoryUsage(usage);
+    else if (usage.addShared(container.get()))
+    {
+        MemoryUsage sharedUsage;
+        container->memoryUsage(sharedUsage);
+        usage.sharedContainers += sharedUsage.total();
+    }
+}
+
+/*!
+    \ingroup Utility
+    \brief Returns the memory allocated by \a container for its elements, with the capacity if available
+*/
+template <typename T_Container>
+inline auto containerMemory(T_Container const& container, int) -> decltype(container.capacity(), size_t())
+{
+    return container.capacity() * sizeof(typename T_Container::value_type);
+}
+
+template <typename T_Container>
+inline size_t containerMemory(T_Container const& container, long)
+{
+    return container.size() * sizeof(typename T_Container::value_type);
+}
+
+/*!
+    \ingroup Utility
+    \brief Returns the memory allocated by \a container for its elements
+*/
+template <typename T_Container>
+inline size_t containerMemory(T_Container const& container)
+{
+    return containerMemory(container, 0);
+}
+
+}
+
+#endif // _VOXOMAP_MEMORYUSAGE_HPP_
@@ -0,0 +1,85 @@
+#ifndef _VOXOMAP_MORTON_HPP_
+#define _VOXOMAP_MORTON_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace voxomap
+{
+
+/*!
+    \ingroup Utility
+    \brief Spread the 21 lower bits of \a value, two zero bits are inserted between each bit
+*/
+inline uint64_t mortonSpread(uint32_t value)
+{
+    uint64_t x = value & 0x1FFFFF;
+    x = (x | x << 32) & 0x1F00000000FFFFull;
+    x = (x | x << 16) & 0x1F0000FF0000FFull;
+    x = (x | x << 8) & 0x100F00F00F00F00Full;
+    x = (x | x << 4) & 0x10C30C30C30C30C3ull;
+    x = (x | x << 2) & 0x1249249249249249ull;
+    return x;
+}
+
+/*!
+    \ingroup Utility
+    \brief Compute the Morton code (Z-order) of a position
+    \details Only the 21 lower bits of each coordinate are used, positions further
+    than 2^21 have the same code. Points inside an aligned power of two cube have
+    consecutive codes, so sorting by this code groups positions by octree node.
+    \param x X coordinate
+    \param y Y coordinate
+    \param z Z coordinate
+    \return The Morton code
+*/
+inline uint64_t mortonEncode(int x, int y, int z)
+{
+    return mortonSpread(static_cast<uint32_t>(x)) << 2 | mortonSpread(static_cast<uint32_t>(y)) << 1 | mortonSpread(static_cast<uint32_t>(z));
+}
+
+/*!
+    \ingroup Utility
+    \brief Stable sort of (code, value) pairs by code
+    \details Least significant digit radix sort, the passes where all the codes share the same digit are skipped.
+    Linear in the number of elements, which is faster than a comparison sort for the big batches of voxels.
+    \param codes Pairs to sort
+*/
+template <typename T>
+void mortonSort(std::vector<std::pair<uint64_t, T>>& codes)
+{
+    std::vector<size_t> histograms(8 * 256, 0);
+    for (auto const& code : codes)
+    {
+        for (int digit = 0; digit < 8; ++digit)
+            ++histograms[digit * 256 + ((code.first >> (digit * 8)) & 0xFF)];
+    }
+
+    std::vector<std::pair<uint64_t, T>> tmp;
+    for (int digit = 0; digit < 8; ++digit)
+    {
+        size_t* histogram = &histograms[digit * 256];
+        if (codes.empty() || histogram[(codes.front().first >> (digit * 8)) & 0xFF] == codes.size())
+            continue;
+
+        size_t offset = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            size_t count = histogram[i];
+            histogram[i] = offset;
+            offset += count;
+        }
+
+        tmp.resize(codes.size());
+        for (auto const& code : codes)
+            tmp[histogram[(code.first >> (digit * 8)) & 0xFF]++] = code;
+        codes.swap(tmp);
+    }
+}
+
+}
+
+#endif // _VOXOMAP_MORTON_HPP_
@@ -1,15 +1,22 @@
 #ifndef _VOXOMAP_RAYCAST_HPP_
 #define _VOXOMAP_RAYCAST_HPP_
 
+#include <cmath>
+#include <cstring>
 #include <functional>
+#include <limits>
 #include <unordered_map>
 #include <map>
 #include <bitset>
 #include <type_traits>
+#include <utility>
 #include <memory>
+#include <vector>
 #include "Ray.hpp"
+#include "Morton.hpp"
 #include "../voxel_octree/VoxelContainer/SidedContainer.hpp"
 #include "../voxel_octree/VoxelOctree.hpp"
+#include "MemoryUsage.hpp"
 
 namespace voxomap
 {
@@ -25,10 +32,19 @@ public:
     using VoxelData = typename T_Container::VoxelData;
     using T_Node = VoxelNode<T_Container>;
     using T_Octree = VoxelOctree<T_Container>;
+    using T_FrozenOctree = FrozenVoxelOctree<T_Container>;
     using T_VoxelContainer = typename T_Container::VoxelContainer;
     using iterator = typename T_Container::iterator;
     using Predicate = std::function<bool(iterator const&)>;
 
+    /*!
+        \brief True if \a T_Predicate can filter the voxels: a callable bool(iterator const&), or nullptr for no filter
+    */
+    template <typename T_Predicate, typename = void>
+    struct IsPredicate : std::is_same<T_Predicate, std::nullptr_t> {};
+    template <typename T_Predicate>
+    struct IsPredicate<T_Predicate, decltype(void(std::declval<T_Predicate const&>()(std::declval<iterator const&>())))> : std::true_type {};
+
     /*! \struct Result
         \brief Result of a ray cast
     */
@@ -53,9 +69,14 @@ public:
 
     /*! \struct Cache
         \brief Structure used for improve performance of raycasting
+        \details Once filled, the cache is only read by the ray casts: one cache can be shared by several threads as long as
+        it is not filled at the same time. The lookup state of a ray cast is kept outside the cache, in a Hint.
+        A cache subscribed to an octree is updated by the modifications of the octree, see subscribe.
     */
-    struct Cache
+    struct Cache : T_Octree::Listener
     {
+        struct Hint;
+
         /*!
             \brief Constructor
         */
@@ -76,27 +97,58 @@ public:
             \param node The node
             \param boxPosition Position of the box
             \param boxSize Size of the box
+            \param hint Lookup state of the caller, it must not be shared between threads
             \return True if there is voxel
         */
-        bool hasVoxel(T_Node const& node, Vector3I const& boxPosition, int boxSize);
+        bool hasVoxel(T_Node const& node, Vector3I const& boxPosition, int boxSize, Hint& hint) const;
         /*!
             \brief Check if \a node has voxel inside the box and fill the cache if it is not already filled
+            \details Not thread safe, the cache must not be used by other threads during the call.
             \param node The node
             \param boxPosition Position of the box
             \param boxSize Size of the box
+            \param hint Lookup state of the caller
             \return True if there is voxel
         */
-        bool fillHasVoxel(T_Node const& node, Vector3I const& boxPosition, int boxSize);
+        bool fillHasVoxel(T_Node const& node, Vector3I const& boxPosition, int boxSize, Hint& hint);
         /*!
             \brief Initialize the cache with \a node input
+            \details Not thread safe, the cache must not be used by other threads during the call.
             \param node The node
         */
         void fillCache(T_Node const& node);
         /*!
             \brief Initialize the cache
+            \details Not thread safe, the cache must not be used by other threads during the call.
             \param octree The octree
         */
         void fillCache(T_Octree const& octree);
+        /*!
+            \brief Fills the cache with \a octree and keeps it up to date with the modifications of \a octree
+            \details An added or removed voxel only recomputes the presence bits of the boxes that contain it.
+            The updates are made by the thread that modifies the octree, so the cache must not be used by ray casts
+            during the modifications, as the octree itself. The copies of the cache share the updates.
+            Use VoxelOctree::removeListener to stop the updates.
+            \param octree The octree
+        */
+        void subscribe(T_Octree& octree);
+        /*!
+            \brief Recomputes the presence bits of the boxes that contain the voxel \a it
+        */
+        void onVoxelModified(iterator const& it) override;
+        /*!
+            \brief Refills the cache of \a node
+        */
+        void onLeafModified(T_Node const& node) override;
+        /*!
+            \brief Removes \a node from the cache
+        */
+        void onLeafRemoving(T_Node const& node) override;
+        /*!
+            \brief Adds the memory used by the cache to \a usage
+            \details The memory is shared with the copies of the cache.
+        */
+        void memoryUsage(MemoryUsage& usage) const;
 
     private:
         /*! \struct BoxPresenceCache
@@ -104,8 +156,14 @@ public:
         */
         struct PresenceCache
         {
-            bool hasVoxel(Cache& cache, Vector3I const& boxPosition, int boxSize) const;
-            inline bool hasVoxel() const { return reinterpret_cast<uint64_t const*>(presence) != 0; }
+            bool hasVoxel(Vector3I const& boxPosition, int boxSize) const;
+            bool hasVoxel() const;
+            inline size_t getHeapMemory() const { return 0; }
+
+            /*!
+                \brief Sets the presence bit of the box of size 2 that contains the position (x, y, z)
+            */
+            void setPresence(uint8_t x, uint8_t y, uint8_t z, bool present);
 
             uint8_t presence[8] = { 0 }; //!< Represent the presence of voxel/container inside the node
 
@@ -118,7 +176,7 @@ public:
         template <typename T_SubContainer>
         struct ContainerPresenceCache : PresenceCache
         {
-            bool hasVoxel(Cache& cache, Vector3I const& boxPosition, int boxSize) const;
+            bool hasVoxel(Vector3I const& boxPosition, int boxSize) const;
 
             const static uint32_t NB_CONTAINERS = T_SubContainer::NB_CONTAINERS;
             PresenceCache containerPresence[NB_CONTAINERS][NB_CONTAINERS][NB_CONTAINERS];
@@ -134,7 +192,11 @@ public:
                 SuperContainerPresenceCache<typename T_SubContainer::Container>,
                 ContainerPresenceCache<typename T_SubContainer::Container>>::type;
 
-            bool hasVoxel(Cache& cache, Vector3I const& boxPosition, int boxSize) const;
+            bool hasVoxel(Vector3I const& boxPosition, int boxSize) const;
+            /*!
+                \brief Returns the memory allocated for the sub-caches
+            */
+            size_t getHeapMemory() const;
 
             const static uint32_t NB_CONTAINERS = T_SubContainer::NB_CONTAINERS;
             std::unique_ptr<SubCache> containerPresence[NB_CONTAINERS][NB_CONTAINERS][NB_CONTAINERS];
@@ -175,28 +237,90 @@ public:
         */
         template <class T_SubContainer>
         void fillCache(T_SubContainer const& container, PresenceCache& cache);
+        /*!
+            \brief Updates the \a cache for SuperContainerPresenceCache after the modification of the voxel \a it
+            \param container Super container of the cache
+            \param cache Cache structure
+            \param it The modified voxel
+        */
+        template <class T_SubContainer, typename T_Cache>
+        void updateCache(T_SubContainer const& container, T_Cache& cache, iterator const& it);
+        /*!
+            \brief Updates the \a cache for ContainerPresenceCache after the modification of the voxel \a it
+            \param container Super container of the cache
+            \param cache Cache structure
+            \param it The modified voxel
+        */
+        template <class T_SubContainer>
+        void updateCache(T_SubContainer const& container, ContainerPresenceCache<T_SubContainer>& cache, iterator const& it);
+        /*!
+            \brief Updates the \a cache for PresenceCache after the modification of the voxel \a it
+            \param container Voxel container of the cache
+            \param cache Cache structure
+            \param it The modified voxel
+        */
+        template <class T_SubContainer>
+        void updateCache(T_SubContainer const& container, PresenceCache& cache, iterator const& it);
+        /*!
+            \brief Check if there is a container in the box of size 2 that contains the position (x, y, z) of \a container
+        */
+        template <class T_SubContainer>
+        static bool hasContainerInBox(T_SubContainer const& container, uint8_t x, uint8_t y, uint8_t z);
 
         std::shared_ptr<std::unordered_map<T_Node const*, NodeCache>> _nodeCache; //!< Cache memory
-        T_Node const* _lastNode = nullptr;
-        NodeCache* _lastCache = nullptr;
+
+    public:
+        /*! \struct Hint
+            \brief Last node looked up in a cache, consecutive lookups inside the same node skip the map search
+        */
+        struct Hint
+        {
+            T_Node const* node = nullptr;       //!< Last node looked up
+            NodeCache const* cache = nullptr;   //!< Cache of the last node, nullptr if the node isn't in the cache
+        };
     };
 
     /*!
-        \brief Execute a ray cast on the \a node
+        \brief Execute a ray cast on the \a node, filtered by \a predicate
         \param node The node where to execute the ray cast
         \return True if there is an intersection
     */
     bool                execute(T_Node const& node);
+    /*!
+        \brief Execute a ray cast on the frozen \a octree, filtered by \a predicate
+        \param octree The octree where to execute the ray cast
+        \return True if there is an intersection
+    */
+    bool                execute(T_FrozenOctree const& octree);
+    /*!
+        \brief Execute a ray cast on the \a node
+        \details The predicate is called directly by the traversal, a lambda is inlined.
+        \param node The node where to execute the ray cast
+        \param predicate Function that allow to add some conditions in raytracing: bool(iterator const&), nullptr for none
+        \return True if there is an intersection
+    */
+    template <typename T_Predicate>
+    bool                execute(T_Node const& node, T_Predicate const& predicate);
+    /*!
+        \brief Execute a ray cast on the frozen \a octree
+        \param octree The octree where to execute the ray cast
+        \param predicate Function that allow to add some conditions in raytracing: bool(iterator const&), nullptr for none
+        \return True if there is an intersection
+    */
+    template <typename T_Predicate>
+    bool                execute(T_FrozenOctree const& octree, T_Predicate const& predicate);
 
     /*!
         \brief Execute a raycast
         \param ray The ray to cast
         \param node Node where to execute the raycast
-        \param predicate Function that allow to add some conditions in raytracing
+        \param predicate Function that allow to add some conditions in raytracing: bool(iterator const&), nullptr for none
         \param maxDistance Maximum distance where to execute the ray casting
         \return The ray cast result
     */
-    static Result       get(Ray const& ray, T_Node const& node, Predicate const& predicate, double maxDistance = -1);
+    template <typename T_Predicate>
+    static typename std::enable_if<IsPredicate<T_Predicate>::value, Result>::type
+                        get(Ray const& ray, T_Node const& node, T_Predicate const& predicate, double maxDistance = -1);
     /*!
         \brief Execute a raycast
         \param ray The ray to cast
@@ -209,11 +333,13 @@ public:
        \brief Execute a raycast
        \param ray The ray to cast
        \param octree Octree where to execute the raycast
-       \param predicate Function that allow to add some conditions in raytracing
+       \param predicate Function that allow to add some conditions in raytracing: bool(iterator const&), nullptr for none
        \param maxDistance Maximum distance where to execute the ray casting
        \return The ray cast result
     */
-    static Result       get(Ray const& ray, T_Octree const& octree, Predicate const& predicate, double maxDistance = -1);
+    template <typename T_Predicate>
+    static typename std::enable_if<IsPredicate<T_Predicate>::value, Result>::type
+                        get(Ray const& ray, T_Octree const& octree, T_Predicate const& predicate, double maxDistance = -1);
     /*!
        \brief Execute a raycast
        \param ray The ray to cast
@@ -222,17 +348,38 @@ public:
        \return The ray cast result
     */
     static Result       get(Ray const& ray, T_Octree const& octree, double maxDistance = -1);
+    /*!
+       \brief Execute a raycast
+       \param ray The ray to cast
+       \param octree Frozen octree where to execute the raycast
+       \param predicate Function that allow to add some conditions in raytracing: bool(iterator const&), nullptr for none
+       \param maxDistance Maximum distance where to execute the ray casting
+       \return The ray cast result
+    */
+    template <typename T_Predicate>
+    static typename std::enable_if<IsPredicate<T_Predicate>::value, Result>::type
+                        get(Ray const& ray, T_FrozenOctree const& octree, T_Predicate const& predicate, double maxDistance = -1);
+    /*!
+       \brief Execute a raycast
+       \param ray The ray to cast
+       \param octree Frozen octree where to execute the raycast
+       \param maxDistance Maximum distance where to execute the ray casting
+       \return The ray cast result
+    */
+    static Result       get(Ray const& ray, T_FrozenOctree const& octree, double maxDistance = -1);
 
     /*!
        \brief Execute a raycast
        \param ray The ray to cast
        \param node Node where to execute the raycast
        \param cache The cache structure
-       \param predicate Function that allow to add some conditions in raytracing
+       \param predicate Function that allow to add some conditions in raytracing: bool(iterator const&), nullptr for none
        \param maxDistance Maximum distance where to execute the ray casting
        \return The ray cast result
     */
-    static Result       get(Ray const& ray, T_Node const& node, Cache& cache, Predicate const& predicate, double maxDistance = -1);
+    template <typename T_Predicate>
+    static typename std::enable_if<IsPredicate<T_Predicate>::value, Result>::type
+                        get(Ray const& ray, T_Node const& node, Cache const& cache, T_Predicate const& predicate, double maxDistance = -1);
     /*!
        \brief Execute a raycast
        \param ray The ray to cast
@@ -241,17 +388,19 @@ public:
        \param maxDistance Maximum distance where to execute the ray casting
        \return The ray cast result
     */
-    static Result       get(Ray const& ray, T_Node const& node, Cache& cache, double maxDistance = -1);
+    static Result       get(Ray const& ray, T_Node const& node, Cache const& cache, double maxDistance = -1);
     /*!
        \brief Execute a raycast
        \param ray The ray to cast
        \param octree Octree where to execute the raycast
        \param cache The cache structure
-       \param predicate Function that allow to add some conditions in raytracing
+       \param predicate Function that allow to add some conditions in raytracing: bool(iterator const&), nullptr for none
        \param maxDistance Maximum distance where to execute the ray casting
        \return The ray cast result
     */
-    static Result       get(Ray const& ray, T_Octree const& octree, Cache& cache, Predicate const& predicate, double maxDistance = -1);
+    template <typename T_Predicate>
+    static typename std::enable_if<IsPredicate<T_Predicate>::value, Result>::type
+                        get(Ray const& ray, T_Octree const& octree, Cache const& cache, T_Predicate const& predicate, double maxDistance = -1);
     /*!
        \brief Execute a raycast
        \param ray The ray to cast
@@ -260,7 +409,7 @@ public:
        \param maxDistance Maximum distance where to execute the ray casting
        \return The ray cast result
     */
-    static Result       get(Ray const& ray, T_Octree const& octree, Cache& cache, double maxDistance = -1);
+    static Result       get(Ray const& ray, T_Octree const& octree, Cache const& cache, double maxDistance = -1);
 
     /*!
        \brief Execute a raycast
@@ -268,11 +417,62 @@ public:
        \param nodes Array of nodes where to execute the raycast
        \param nbNode Number of nodes inside the array
        \param cache The cache structure
-       \param predicate Function that allow to add some conditions in raytracing
+       \param predicate Function that allow to add some conditions in raytracing: bool(iterator const&), nullptr for none
        \param maxDistance Maximum distance where to execute the ray casting
        \return The ray cast result
     */
-    static Result       get(Ray const& ray, T_Node const* const* nodes, size_t nbNode, Cache& cache, Predicate const& predicate, double maxDistance = -1);
+    template <typename T_Predicate>
+    static typename std::enable_if<IsPredicate<T_Predicate>::value, Result>::type
+                        get(Ray const& ray, T_Node const* const* nodes, size_t nbNode, Cache const& cache, T_Predicate const& predicate, double maxDistance = -1);
+
+    /*!
+       \brief Execute a batch of raycasts
+       \details The rays are sorted by direction and the rays going toward the same octant are traced together by packets of PACKET_SIZE rays: each box
+       is tested against all the rays of a packet at once and the upper levels of the tree are walked once per packet.
+       A ray continues alone inside the voxel containers, or when it is the last ray of its packet.
+       The results are the same as a call to get for each ray.
+       \param rays Array of the rays to cast
+       \param nbRay Number of rays inside the array
+       \param node Node where to execute the raycasts
+       \param results Array of \a nbRay results, filled with the result of each ray
+       \param predicate Function that allow to add some conditions in raytracing: bool(iterator const&), nullptr for none
+       \param maxDistance Maximum distance where to execute the ray casting
+    */
+    template <typename T_Predicate>
+    static typename std::enable_if<IsPredicate<T_Predicate>::value, void>::type
+                        get(Ray const* rays, size_t nbRay, T_Node const& node, Result* results, T_Predicate const& predicate, double maxDistance = -1);
+    /*!
+       \brief Execute a batch of raycasts, see the overload with a predicate
+       \param rays Array of the rays to cast
+       \param nbRay Number of rays inside the array
+       \param node Node where to execute the raycasts
+       \param results Array of \a nbRay results, filled with the result of each ray
+       \param maxDistance Maximum distance where to execute the ray casting
+    */
+    static void         get(Ray const* rays, size_t nbRay, T_Node const& node, Result* results, double maxDistance = -1);
+    /*!
+       \brief Execute a batch of raycasts, see the overload with a node
+       \param rays Array of the rays to cast
+       \param nbRay Number of rays inside the array
+       \param octree Octree where to execute the raycasts
+       \param results Array of \a nbRay results, filled with the result of each ray
+       \param predicate Function that allow to add some conditions in raytracing: bool(iterator const&), nullptr for none
+       \param maxDistance Maximum distance where to execute the ray casting
+    */
+    template <typename T_Predicate>
+    static typename std::enable_if<IsPredicate<T_Predicate>::value, void>::type
+                        get(Ray const* rays, size_t nbRay, T_Octree const& octree, Result* results, T_Predicate const& predicate, double maxDistance = -1);
+    /*!
+       \brief Execute a batch of raycasts, see the overload with a node
+       \param rays Array of the rays to cast
+       \param nbRay Number of rays inside the array
+       \param octree Octree where to execute the raycasts
+       \param results Array of \a nbRay results, filled with the result of each ray
+       \param maxDistance Maximum distance where to execute the ray casting
+    */
+    static void         get(Ray const* rays, size_t nbRay, T_Octree const& octree, Result* results, double maxDistance = -1);
+
+    const static uint32_t PACKET_SIZE = 16;    //!< Maximum number of rays traced together by the batch raycast
 
     Ray         ray;                //!< The ray to cast
     double      maxDistance = -1;   //!< The maximum distance of the ray cast
@@ -280,40 +480,102 @@ public:
     Result      result;             //!< The ray cast result
 
 private:
+    /*! \struct Packet
+        \brief Rays going toward the same octant, traced together
+        The components of the rays are stored in separate arrays, the box test of all the rays is vectorized by the compiler.
+    */
+    struct Packet
+    {
+        /*!
+            \brief Same test as Ray::intersectAABox for each ray of the packet
+            \param active Mask of the rays to test
+            \return Mask of the \a active rays intersecting the box
+        */
+        uint32_t intersectAABox(uint32_t active, double x, double y, double z, double size) const;
+
+        double      srcX[PACKET_SIZE];          //!< X component of the ray sources
+        double      srcY[PACKET_SIZE];          //!< Y component of the ray sources
+        double      srcZ[PACKET_SIZE];          //!< Z component of the ray sources
+        float       invX[PACKET_SIZE];          //!< X component of the inverse directions
+        float       invY[PACKET_SIZE];          //!< Y component of the inverse directions
+        float       invZ[PACKET_SIZE];          //!< Z component of the inverse directions
+        Raycast*    raycasts[PACKET_SIZE];      //!< Ray cast of each ray
+        int         sortingIndex = 0;           //!< Index inside hardcoded array, shared by the rays
+    };
+
+    /*!
+        \brief Raycast of a packet on a node
+        \param packet The packet
+        \param node The node, intersected by the \a active rays
+        \param active Mask of the rays of the packet to cast
+        \param predicate Function that allow to add some conditions in raytracing
+        \return Mask of the rays that intersect a voxel inside the node
+    */
+    template <typename T_Predicate>
+    static uint32_t raycastPacket(Packet& packet, T_Node const& node, uint32_t active, T_Predicate const& predicate);
+
+    /*!
+        \brief Returns the result of \a predicate for the voxel \a it
+    */
+    template <typename T_Predicate>
+    static bool acceptVoxel(T_Predicate const& predicate, iterator const& it);
+    /*!
+        \brief No predicate, all the voxels are accepted
+    */
+    static bool acceptVoxel(std::nullptr_t, iterator const& it);
+
     /*!
         \brief Raycast on a voxel
-        \param node Node where the voxel is
-        \param pos Position of the voxel
-        \return True if ray intersect the voxel
+        \param it Iterator on the voxel
+        \param container Voxel container where the voxel is
+        \param t Ray parameter where the ray enters the voxel
+        \param side Side of the voxel crossed by the ray
+        \param predicate Function that allow to add some conditions in raytracing
+        \return True if the voxel is accepted by the predicate
     */
-    bool raycastVoxel(iterator& it, T_VoxelContainer const& container);
+    template <typename T_Predicate>
+    bool raycastVoxel(iterator& it, T_VoxelContainer const& container, double t, SideEnum side, T_Predicate const& predicate);
     /*!
-        \brief Raycast on a box inside a voxel container
+        \brief Raycast on a box inside a voxel container, the voxels are walked in ray order with a DDA
         \param node Node where the box is
         \param boxPosition Position of the box
         \param boxSize Size of the box
+        \param predicate Function that allow to add some conditions in raytracing
         \return True if ray intersect a voxel inside the box
     */
-    bool raycastContainer(iterator& it, T_VoxelContainer const& container, Vector3I const& boxPosition, int boxSize);
+    template <typename T_Predicate>
+    bool raycastContainer(iterator& it, T_VoxelContainer const& container, Vector3I const& boxPosition, int boxSize, T_Predicate const& predicate);
     /*!
         \brief Raycast on a box inside a super container
         \param node Node where the box is
         \param boxPosition Position of the box
         \param boxSize Size of the box
+        \param predicate Function that allow to add some conditions in raytracing
         \return True if ray intersect a voxel inside the box
     */
-    template <typename T>
-    bool raycastContainer(iterator& it, T const& container, Vector3I const& boxPosition, int boxSize);
+    template <typename T, typename T_Predicate>
+    bool raycastContainer(iterator& it, T const& container, Vector3I const& boxPosition, int boxSize, T_Predicate const& predicate);
     /*!
         \brief Raycast on a node
         \param node The node
+        \param predicate Function that allow to add some conditions in raytracing
+        \return True if ray intersect a voxel inside the node
+    */
+    template <typename T_Predicate>
+    bool raycast(T_Node const& node, T_Predicate const& predicate);
+    /*!
+        \brief Raycast on a node of a frozen octree
+        \param octree The frozen octree
+        \param nodeIndex Index of the node
+        \param predicate Function that allow to add some conditions in raytracing
         \return True if ray intersect a voxel inside the node
     */
-    bool raycast(T_Node const& node);
+    template <typename T_Predicate>
+    bool raycast(T_FrozenOctree const& octree, uint32_t nodeIndex, T_Predicate const& predicate);
 
-    int         _sortingIndex = 0; //!< Index inside hardcoded array, improve ray casting performance
-    SideEnum    _sideToCheck = SideEnum::ALL; //!< Side to check with the ray cast>
-    Cache       _cache; //!< Cache structure, to improve performance
+    int                     _sortingIndex = 0;  //!< Index inside hardcoded array, improve ray casting performance
+    Cache const*            _cache = nullptr;   //!< Cache structure, to improve performance, nullptr if there is none
+    typename Cache::Hint    _cacheHint;         //!< Lookup state inside the cache, owned by the ray cast
 };
 
 }
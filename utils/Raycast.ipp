@@ -1,15 +1,15 @@
 namespace voxomap
 {
 
-static int const gl_raycast_index[][9] = {
-    { 7, 3, 6, 5, 2, 1, 4, 0, SideEnum::XPOS | SideEnum::YPOS | SideEnum::ZPOS }, // Right Top Back
-    { 6, 2, 7, 4, 3, 0, 5, 1, SideEnum::XNEG | SideEnum::YPOS | SideEnum::ZPOS }, // Left Top Back
-    { 5, 1, 7, 4, 3, 6, 0, 2, SideEnum::XPOS | SideEnum::YNEG | SideEnum::ZPOS }, // Right Bottom Back
-    { 4, 5, 6, 0, 7, 2, 1, 3, SideEnum::XNEG | SideEnum::YNEG | SideEnum::ZPOS }, // Left Bottom Back
-    { 3, 1, 2, 7, 0, 5, 6, 4, SideEnum::XPOS | SideEnum::YPOS | SideEnum::ZNEG }, // Right Top Front
-    { 2, 0, 6, 3, 1, 7, 4, 5, SideEnum::XNEG | SideEnum::YPOS | SideEnum::ZNEG }, // Left Top Front
-    { 1, 0, 5, 3, 2, 7, 4, 6, SideEnum::XPOS | SideEnum::YNEG | SideEnum::ZNEG }, // Right Bottom Front
-    { 0, 1, 2, 4, 3, 6, 5, 7, SideEnum::XNEG | SideEnum::YNEG | SideEnum::ZNEG }  // Left Bottom Front
+static int const gl_raycast_index[][8] = {
+    { 7, 3, 6, 5, 2, 1, 4, 0 }, // Right Top Back
+    { 6, 2, 7, 4, 3, 0, 5, 1 }, // Left Top Back
+    { 5, 1, 7, 4, 3, 6, 0, 2 }, // Right Bottom Back
+    { 4, 5, 6, 0, 7, 2, 1, 3 }, // Left Bottom Back
+    { 3, 1, 2, 7, 0, 5, 6, 4 }, // Right Top Front
+    { 2, 0, 6, 3, 1, 7, 4, 5 }, // Left Top Front
+    { 1, 0, 5, 3, 2, 7, 4, 6 }, // Right Bottom Front
+    { 0, 1, 2, 4, 3, 6, 5, 7 }  // Left Bottom Front
 };
 
 inline static int orderId(Vector3D const& direction)
@@ -17,6 +17,9 @@ inline static int orderId(Vector3D const& direction)
     return (direction.x > 0) | ((direction.y > 0) << 1) | ((direction.z > 0) << 2);
 }
 
+template <class T_Container>
+const uint32_t Raycast<T_Container>::PACKET_SIZE;
+
 template <class T_Container>
 inline bool Raycast<T_Container>::Result::operator<(Result const& other) const
 {
@@ -29,156 +32,151 @@ inline bool Raycast<T_Container>::Result::operator>(Result const& other) const
     return other < *this;
 }
 
-inline static double intersection(Vector3D const& corner, size_t size, Ray const& ray, SideEnum& side, SideEnum sideToCheck)
+template <class T_Container>
+template <typename T_Predicate>
+inline bool Raycast<T_Container>::acceptVoxel(T_Predicate const& predicate, iterator const& it)
 {
-    double distance;
-
-    if (sideToCheck & SideEnum::YPOS)
-    {
-        distance = ray.intersectPlane(Vector3D(corner.x, corner.y + size, corner.z), Vector3D(corner.x + size, corner.y + size, corner.z), Vector3D(corner + size));
-        if (distance != -1)
-        {
-            side = SideEnum::YPOS;
-            return distance;
-        }
-    }
-    if (sideToCheck & SideEnum::YNEG)
-    {
-        distance = ray.intersectPlane(Vector3D(corner), Vector3D(corner.x + size, corner.y, corner.z), Vector3D(corner.x + size, corner.y, corner.z + size));
-        if (distance != -1)
-        {
-            side = SideEnum::YNEG;
-            return distance;
-        }
-    }
-    if (sideToCheck & SideEnum::XNEG)
-    {
-        distance = ray.intersectPlane(Vector3D(corner), Vector3D(corner.x, corner.y + size, corner.z), Vector3D(corner.x, corner.y + size, corner.z + size));
-        if (distance != -1)
-        {
-            side = SideEnum::XNEG;
-            return distance;
-        }
-    }
-    if (sideToCheck & SideEnum::XPOS)
-    {
-        distance = ray.intersectPlane(Vector3D(corner.x + size, corner.y, corner.z), Vector3D(corner.x + size, corner.y + size, corner.z), Vector3D(corner + size));
-        if (distance != -1)
-        {
-            side = SideEnum::XPOS;
-            return distance;
-        }
-    }
-    if (sideToCheck & SideEnum::ZNEG)
-    {
-        distance = ray.intersectPlane(Vector3D(corner), Vector3D(corner.x + size, corner.y, corner.z), Vector3D(corner.x + size, corner.y + size, corner.z));
-        if (distance != -1)
-        {
-            side = SideEnum::ZNEG;
-            return distance;
-        }
-    }
-    if (sideToCheck & SideEnum::ZPOS)
-    {
-        distance = ray.intersectPlane(Vector3D(corner.x, corner.y, corner.z + size), Vector3D(corner.x + size, corner.y, corner.z + size), Vector3D(corner + size));
-        if (distance != -1)
-        {
-            side = SideEnum::ZPOS;
-            return distance;
-        }
-    }
-    return -1;
+    return predicate(it);
 }
 
-inline static double getDistance(Vector3I const& boxPosition, size_t boxSize, Ray const& ray, double distance, SideEnum& side, SideEnum checkSide)
-{
-    auto corner2 = boxPosition + boxSize;
-
-    if (ray.src.x >= boxPosition.x && ray.src.x <= corner2.x &&
-        ray.src.y >= boxPosition.y && ray.src.y <= corner2.y &&
-        ray.src.z >= boxPosition.z && ray.src.z <= corner2.z)
-        return 0;
-
-    if ((ray.src.x < boxPosition.x && ray.dir.x < 0) || (ray.src.x > corner2.x && ray.dir.x > 0) ||
-        (ray.src.y < boxPosition.y && ray.dir.y < 0) || (ray.src.y > corner2.y && ray.dir.y > 0) ||
-        (ray.src.z < boxPosition.z && ray.dir.z < 0) || (ray.src.z > corner2.z && ray.dir.z > 0))
-        return -1;
-
-    double tmp = intersection(boxPosition, boxSize, ray, side, checkSide);
-    return (tmp != -1 && (distance == -1 || tmp < distance)) ? tmp : -1;
-}
-
-template <class T_Voxel>
-SideEnum getSideToCheck(SideEnum sideToCheck, T_Voxel&)
+template <class T_Container>
+inline bool Raycast<T_Container>::acceptVoxel(std::nullptr_t, iterator const&)
 {
-    return sideToCheck;
+    return true;
 }
 
 template <class T_Container>
-bool Raycast<T_Container>::raycastVoxel(iterator& it, T_VoxelContainer const& container)
+template <typename T_Predicate>
+bool Raycast<T_Container>::raycastVoxel(iterator& it, T_VoxelContainer const& container, double t, SideEnum side, T_Predicate const& predicate)
 {
-    Vector3I corner;
-    it.getVoxelPosition(corner.x, corner.y, corner.z);
-
-    auto voxel = container.findVoxel(it);
-    if (!voxel)
+    it.voxel = const_cast<typename T_Container::VoxelData*>(container.findVoxel(it));
+    if (!it.voxel)
         return false;
-    it.voxel = const_cast<typename T_Container::VoxelData*>(voxel);
 
-    double computedDistance = getDistance(corner, 1, this->ray, this->maxDistance, this->result.side, getSideToCheck(_sideToCheck, *voxel));
-    if (computedDistance == -1)
+    if (!Raycast::acceptVoxel(predicate, it))
         return false;
 
-    if (this->predicate && !this->predicate(it))
-        return false;
-
-    this->result.distance = std::sqrt(computedDistance);
-    this->result.position = this->ray.src + this->ray.dir * this->result.distance;
+    this->result.distance = t * this->ray.dir.length();
+    this->result.position = this->ray.src + this->ray.dir * t;
+    this->result.side = side;
     this->result.it = it;
     return true;
 }
 
 template <class T_Container>
-bool Raycast<T_Container>::raycastContainer(iterator& it, T_VoxelContainer const& container, Vector3I const& boxPosition, int boxSize)
+template <typename T_Predicate>
+bool Raycast<T_Container>::raycastContainer(iterator& it, T_VoxelContainer const& container, Vector3I const& boxPosition, int boxSize, T_Predicate const& predicate)
 {
-    boxSize >>= 1;
-    for (int i = 0; i < 8; ++i)
-    {
-        int index = gl_raycast_index[_sortingIndex][i];
-        Vector3I newBoxPosition(index & 1, (index >> 1) & 1, (index >> 2) & 1);
-        newBoxPosition.x = newBoxPosition.x * boxSize + boxPosition.x;
-        newBoxPosition.y = newBoxPosition.y * boxSize + boxPosition.y;
-        newBoxPosition.z = newBoxPosition.z * boxSize + boxPosition.z;
+    static const SideEnum negativeSides[3] = { SideEnum::XNEG, SideEnum::YNEG, SideEnum::ZNEG };
+    static const SideEnum positiveSides[3] = { SideEnum::XPOS, SideEnum::YPOS, SideEnum::ZPOS };
+
+    OccupancyMask const& occupancy = container.getOccupancy();
+    if (occupancy.findNext(0) == OccupancyMask::NB_BITS)
+        return false;
 
-        if (boxSize == 1)
+    // Source relative to the corner of the container
+    double const src[3] = {
+        this->ray.src.x - (it.node->getX() + boxPosition.x),
+        this->ray.src.y - (it.node->getY() + boxPosition.y),
+        this->ray.src.z - (it.node->getZ() + boxPosition.z)
+    };
+    double const dir[3] = { this->ray.dir.x, this->ray.dir.y, this->ray.dir.z };
+
+    // Entry of the ray inside the container, no entry axis when the source is inside
+    double tEnter = 0;
+    double tExit = std::numeric_limits<double>::max();
+    int enterAxis = -1;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (dir[axis] == 0)
         {
-            it.x = T_Node::findVoxelPosition(newBoxPosition.x);
-            it.y = T_Node::findVoxelPosition(newBoxPosition.y);
-            it.z = T_Node::findVoxelPosition(newBoxPosition.z);
-            if (this->raycastVoxel(it, container))
-                return true;
+            if (src[axis] < 0 || src[axis] > boxSize)
+                return false;
+            continue;
+        }
+        double t1 = -src[axis] / dir[axis];
+        double t2 = (boxSize - src[axis]) / dir[axis];
+        if (t1 > t2)
+            std::swap(t1, t2);
+        if (t1 > tEnter)
+        {
+            tEnter = t1;
+            enterAxis = axis;
         }
+        tExit = std::min(tExit, t2);
+    }
+    if (tEnter > tExit)
+        return false;
+
+    // Amanatides & Woo traversal: one step per cell along the axis of the nearest cell boundary
+    int cell[3];
+    int step[3];
+    double tMax[3];
+    double tDelta[3];
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (axis == enterAxis)
+            cell[axis] = (dir[axis] > 0) ? 0 : boxSize - 1;
         else
         {
-            if (!_cache.empty() && !_cache.hasVoxel(*it.node, newBoxPosition, boxSize))
-                continue;
+            double position = src[axis] + dir[axis] * tEnter;
+            cell[axis] = static_cast<int>(std::floor(position));
+            if (dir[axis] < 0 && position == cell[axis])
+                --cell[axis];
+            cell[axis] = std::min(std::max(cell[axis], 0), boxSize - 1);
+        }
 
-            if (!this->ray.intersectAABox(it.node->getX() + newBoxPosition.x,
-                                          it.node->getY() + newBoxPosition.y,
-                                          it.node->getZ() + newBoxPosition.z,
-                                          boxSize))
-                continue;
+        if (dir[axis] > 0)
+        {
+            step[axis] = 1;
+            tMax[axis] = (cell[axis] + 1 - src[axis]) / dir[axis];
+            tDelta[axis] = 1 / dir[axis];
+        }
+        else if (dir[axis] < 0)
+        {
+            step[axis] = -1;
+            tMax[axis] = (cell[axis] - src[axis]) / dir[axis];
+            tDelta[axis] = -1 / dir[axis];
+        }
+        else
+        {
+            step[axis] = 0;
+            tMax[axis] = std::numeric_limits<double>::max();
+            tDelta[axis] = 0;
+        }
+    }
 
-            if (this->raycastContainer(it, container, newBoxPosition, boxSize))
+    SideEnum side = (enterAxis == -1) ? this->result.side : (dir[enterAxis] > 0 ? negativeSides[enterAxis] : positiveSides[enterAxis]);
+    double squaredLength = this->ray.dir.squaredLength();
+    double t = tEnter;
+    while (true)
+    {
+        if (occupancy.test(static_cast<uint8_t>(cell[0]), static_cast<uint8_t>(cell[1]), static_cast<uint8_t>(cell[2])))
+        {
+            // The next cells are further
+            if (this->maxDistance != -1 && t * t * squaredLength >= this->maxDistance)
+                return false;
+
+            it.x = static_cast<uint8_t>(cell[0]);
+            it.y = static_cast<uint8_t>(cell[1]);
+            it.z = static_cast<uint8_t>(cell[2]);
+            if (this->raycastVoxel(it, container, t, side, predicate))
                 return true;
         }
+
+        int axis = (tMax[0] < tMax[1]) ? (tMax[0] < tMax[2] ? 0 : 2) : (tMax[1] < tMax[2] ? 1 : 2);
+        cell[axis] += step[axis];
+        if (cell[axis] < 0 || cell[axis] >= boxSize)
+            return false;
+        t = tMax[axis];
+        tMax[axis] += tDelta[axis];
+        side = (step[axis] > 0) ? negativeSides[axis] : positiveSides[axis];
     }
-    return false;
 }
 
 template <class T_Container>
-template <typename T>
-bool Raycast<T_Container>::raycastContainer(iterator& it, T const& container, Vector3I const& boxPosition, int boxSize)
+template <typename T, typename T_Predicate>
+bool Raycast<T_Container>::raycastContainer(iterator& it, T const& container, Vector3I const& boxPosition, int boxSize, T_Predicate const& predicate)
 {
     boxSize >>= 1;
     for (int i = 0; i < 8; ++i)
@@ -205,17 +203,16 @@ bool Raycast<T_Container>::raycastContainer(iterator& it, T const& container, Ve
                                           boxSize))
                 continue;
 
-            _cache.hasVoxel(*it.node, boxPosition, boxSize);
 
             it.containerPosition[T::SUPERCONTAINER_ID].x = sx;
             it.containerPosition[T::SUPERCONTAINER_ID].y = sy;
             it.containerPosition[T::SUPERCONTAINER_ID].z = sz;
-            if (this->raycastContainer(it, *sub_container, newBoxPosition, boxSize))
+            if (this->raycastContainer(it, *sub_container, newBoxPosition, boxSize, predicate))
                 return true;
         }
         else
         {
-            if (!_cache.empty() && !_cache.hasVoxel(*it.node, newBoxPosition, boxSize))
+            if (_cache && !_cache->hasVoxel(*it.node, newBoxPosition, boxSize, _cacheHint))
                 continue;
 
             if (!this->ray.intersectAABox(it.node->getX() + newBoxPosition.x,
@@ -224,7 +221,7 @@ bool Raycast<T_Container>::raycastContainer(iterator& it, T const& container, Ve
                                           boxSize))
                 continue;
 
-            if (this->raycastContainer(it, container, newBoxPosition, boxSize))
+            if (this->raycastContainer(it, container, newBoxPosition, boxSize, predicate))
                 return true;
         }
     }
@@ -232,7 +229,8 @@ bool Raycast<T_Container>::raycastContainer(iterator& it, T const& container, Ve
 }
 
 template <class T_Container>
-bool Raycast<T_Container>::raycast(T_Node const& node)
+template <typename T_Predicate>
+bool Raycast<T_Container>::raycast(T_Node const& node, T_Predicate const& predicate)
 {
     if (node.getVoxelContainer())
     {
@@ -240,7 +238,7 @@ bool Raycast<T_Container>::raycast(T_Node const& node)
             return false;
         iterator it;
         it.node = const_cast<T_Node*>(&node);
-        return this->raycastContainer(it, *node.getVoxelContainer(), Vector3I(0, 0, 0), T_Container::NB_VOXELS);
+        return this->raycastContainer(it, *node.getVoxelContainer(), Vector3I(0, 0, 0), T_Container::NB_VOXELS, predicate);
     }
     else
     {
@@ -249,7 +247,7 @@ bool Raycast<T_Container>::raycast(T_Node const& node)
             auto child = node.getChildren()[gl_raycast_index[_sortingIndex][i]];
             if (child)
             {
-                if (this->ray.intersectAABox(child->getX(), child->getY(), child->getZ(), child->getSize()) && this->raycast(*child))
+                if (this->ray.intersectAABox(child->getX(), child->getY(), child->getZ(), child->getSize()) && this->raycast(*child, predicate))
                     return true;
             }
         }
@@ -257,23 +255,75 @@ bool Raycast<T_Container>::raycast(T_Node const& node)
     return false;
 }
 
+template <class T_Container>
+template <typename T_Predicate>
+bool Raycast<T_Container>::raycast(T_FrozenOctree const& octree, uint32_t nodeIndex, T_Predicate const& predicate)
+{
+    auto const& node = octree.getNodes()[nodeIndex];
+    if (node.leaf != T_FrozenOctree::NO_INDEX)
+    {
+        // Temporary node of the leaf, the result keeps the node of the frozen octree
+        T_Node leafNode(node.x, node.y, node.z, node.size);
+        octree.initLeafNode(node.leaf, leafNode);
+        bool found = this->raycast(leafNode, predicate);
+        if (this->result.it.node == &leafNode)
+            this->result.it.node = const_cast<T_Node*>(&octree.getLeafNode(node.leaf));
+        return found;
+    }
+
+    for (int i = 0; i < 8; ++i)
+    {
+        uint32_t childIndex = node.getChild(gl_raycast_index[_sortingIndex][i]);
+        if (childIndex != T_FrozenOctree::NO_INDEX)
+        {
+            auto const& child = octree.getNodes()[childIndex];
+            if (this->ray.intersectAABox(child.x, child.y, child.z, child.size) && this->raycast(octree, childIndex, predicate))
+                return true;
+        }
+    }
+    return false;
+}
+
 template <class T_Container>
 inline bool Raycast<T_Container>::execute(T_Node const& node)
 {
+    return this->execute(node, this->predicate);
+}
+
+template <class T_Container>
+inline bool Raycast<T_Container>::execute(T_FrozenOctree const& octree)
+{
+    return this->execute(octree, this->predicate);
+}
+
+template <class T_Container>
+template <typename T_Predicate>
+inline bool Raycast<T_Container>::execute(T_Node const& node, T_Predicate const& predicate)
+{
+    _sortingIndex = orderId(this->ray.dir);
+    return isValidPredicate(predicate) ? this->raycast(node, predicate) : this->raycast(node, nullptr);
+}
+
+template <class T_Container>
+template <typename T_Predicate>
+inline bool Raycast<T_Container>::execute(T_FrozenOctree const& octree, T_Predicate const& predicate)
+{
+    if (octree.getNodes().empty())
+        return false;
     _sortingIndex = orderId(this->ray.dir);
-    _sideToCheck = static_cast<SideEnum>(gl_raycast_index[_sortingIndex][8]);
-    return this->raycast(node);
+    return isValidPredicate(predicate) ? this->raycast(octree, 0, predicate) : this->raycast(octree, 0, nullptr);
 }
 
 template <class T_Container>
-inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const& ray, T_Node const& node, Predicate const& predicate, double maxDistance)
+template <typename T_Predicate>
+inline typename std::enable_if<Raycast<T_Container>::template IsPredicate<T_Predicate>::value, typename Raycast<T_Container>::Result>::type
+Raycast<T_Container>::get(Ray const& ray, T_Node const& node, T_Predicate const& predicate, double maxDistance)
 {
     Raycast raycast;
 
     raycast.ray = ray;
-    raycast.predicate = predicate;
     raycast.maxDistance = (maxDistance > 0) ? maxDistance * maxDistance : -1;
-    raycast.execute(node);
+    raycast.execute(node, predicate);
     return raycast.result;
 }
 
@@ -284,7 +334,9 @@ inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const
 }
 
 template <class T_Container>
-inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const& ray, T_Octree const& octree, Predicate const& predicate, double maxDistance)
+template <typename T_Predicate>
+inline typename std::enable_if<Raycast<T_Container>::template IsPredicate<T_Predicate>::value, typename Raycast<T_Container>::Result>::type
+Raycast<T_Container>::get(Ray const& ray, T_Octree const& octree, T_Predicate const& predicate, double maxDistance)
 {
     if (octree.getRootNode())
         return Raycast::get(ray, *octree.getRootNode(), predicate, maxDistance);
@@ -300,26 +352,48 @@ inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const
 }
 
 template <class T_Container>
-inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const& ray, T_Node const& node, Cache& cache, Predicate const& predicate, double maxDistance)
+template <typename T_Predicate>
+inline typename std::enable_if<Raycast<T_Container>::template IsPredicate<T_Predicate>::value, typename Raycast<T_Container>::Result>::type
+Raycast<T_Container>::get(Ray const& ray, T_FrozenOctree const& octree, T_Predicate const& predicate, double maxDistance)
+{
+    Raycast raycast;
+
+    raycast.ray = ray;
+    raycast.maxDistance = (maxDistance > 0) ? maxDistance * maxDistance : -1;
+    raycast.execute(octree, predicate);
+    return raycast.result;
+}
+
+template <class T_Container>
+inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const& ray, T_FrozenOctree const& octree, double maxDistance)
+{
+    return Raycast::get(ray, octree, nullptr, maxDistance);
+}
+
+template <class T_Container>
+template <typename T_Predicate>
+inline typename std::enable_if<Raycast<T_Container>::template IsPredicate<T_Predicate>::value, typename Raycast<T_Container>::Result>::type
+Raycast<T_Container>::get(Ray const& ray, T_Node const& node, Cache const& cache, T_Predicate const& predicate, double maxDistance)
 {
     Raycast raycast;
 
     raycast.ray = ray;
-    raycast.predicate = predicate;
     raycast.maxDistance = (maxDistance > 0) ? maxDistance * maxDistance : -1;
-    raycast._cache = cache;
-    raycast.execute(node);
+    raycast._cache = cache.empty() ? nullptr : &cache;
+    raycast.execute(node, predicate);
     return raycast.result;
 }
 
 template <class T_Container>
-inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const& ray, T_Node const& node, Cache& cache, double maxDistance)
+inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const& ray, T_Node const& node, Cache const& cache, double maxDistance)
 {
     return Raycast::get(ray, node, cache, nullptr, maxDistance);
 }
 
 template <class T_Container>
-inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const& ray, T_Octree const& octree, Cache& cache, Predicate const& predicate, double maxDistance)
+template <typename T_Predicate>
+inline typename std::enable_if<Raycast<T_Container>::template IsPredicate<T_Predicate>::value, typename Raycast<T_Container>::Result>::type
+Raycast<T_Container>::get(Ray const& ray, T_Octree const& octree, Cache const& cache, T_Predicate const& predicate, double maxDistance)
 {
     if (octree.getRootNode())
         return Raycast::get(ray, *octree.getRootNode(), cache, predicate, maxDistance);
@@ -327,7 +401,7 @@ inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const
 }
 
 template <class T_Container>
-inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const& ray, T_Octree const& octree, Cache& cache, double maxDistance)
+inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const& ray, T_Octree const& octree, Cache const& cache, double maxDistance)
 {
     if (octree.getRootNode())
         return Raycast::get(ray, *octree.getRootNode(), cache, maxDistance);
@@ -335,20 +409,173 @@ inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const
 }
 
 template <class T_Container>
-inline typename Raycast<T_Container>::Result Raycast<T_Container>::get(Ray const& ray, T_Node const* const* nodes, size_t nbNode, Cache& cache, Predicate const& predicate, double maxDistance)
+template <typename T_Predicate>
+inline typename std::enable_if<Raycast<T_Container>::template IsPredicate<T_Predicate>::value, typename Raycast<T_Container>::Result>::type
+Raycast<T_Container>::get(Ray const& ray, T_Node const* const* nodes, size_t nbNode, Cache const& cache, T_Predicate const& predicate, double maxDistance)
 {
     Raycast raycast;
 
     raycast.ray = ray;
-    raycast.predicate = predicate;
     raycast.maxDistance = (maxDistance > 0) ? maxDistance * maxDistance : -1;
-    raycast._cache = cache;
+    raycast._cache = cache.empty() ? nullptr : &cache;
     for (size_t i = 0; i < nbNode; ++i)
-        raycast.execute(*nodes[i]);
+        raycast.execute(*nodes[i], predicate);
     return raycast.result;
 }
 
 
+template <class T_Container>
+template <typename T_Predicate>
+typename std::enable_if<Raycast<T_Container>::template IsPredicate<T_Predicate>::value, void>::type
+Raycast<T_Container>::get(Ray const* rays, size_t nbRay, T_Node const& node, Result* results, T_Predicate const& predicate, double maxDistance)
+{
+    std::vector<Raycast> raycasts(PACKET_SIZE);
+    Packet packet;
+    for (uint32_t i = 0; i < PACKET_SIZE; ++i)
+    {
+        raycasts[i].maxDistance = (maxDistance > 0) ? maxDistance * maxDistance : -1;
+        packet.raycasts[i] = &raycasts[i];
+    }
+
+    // The rays are sorted by octant, the rays of a packet visit the children in the same order,
+    // then by direction, the rays of a packet stay together deeper in the tree
+    std::vector<std::pair<uint64_t, size_t>> order(nbRay);
+    for (size_t i = 0; i < nbRay; ++i)
+    {
+        Vector3D const& dir = rays[i].dir;
+        order[i].first = static_cast<uint64_t>(orderId(dir)) << 60 | mortonEncode(static_cast<int>((dir.x + 1.0) * 0x3FFFF),
+                                                                                  static_cast<int>((dir.y + 1.0) * 0x3FFFF),
+                                                                                  static_cast<int>((dir.z + 1.0) * 0x3FFFF));
+        order[i].second = i;
+    }
+    mortonSort(order);
+
+    for (size_t begin = 0; begin < nbRay;)
+    {
+        packet.sortingIndex = static_cast<int>(order[begin].first >> 60);
+        uint32_t nb = 0;
+        while (nb < PACKET_SIZE && begin + nb < nbRay && static_cast<int>(order[begin + nb].first >> 60) == packet.sortingIndex)
+        {
+            Ray const& ray = rays[order[begin + nb].second];
+            Raycast& raycast = raycasts[nb];
+            raycast.ray = ray;
+            raycast.result = Result();
+            raycast._sortingIndex = packet.sortingIndex;
+            packet.srcX[nb] = ray.src.x;
+            packet.srcY[nb] = ray.src.y;
+            packet.srcZ[nb] = ray.src.z;
+            packet.invX[nb] = ray.inv_dir.x;
+            packet.invY[nb] = ray.inv_dir.y;
+            packet.invZ[nb] = ray.inv_dir.z;
+            ++nb;
+        }
+        // The unused lanes are tested like the others, and ignored
+        for (uint32_t i = nb; i < PACKET_SIZE; ++i)
+        {
+            packet.srcX[i] = packet.srcX[0];
+            packet.srcY[i] = packet.srcY[0];
+            packet.srcZ[i] = packet.srcZ[0];
+            packet.invX[i] = packet.invX[0];
+            packet.invY[i] = packet.invY[0];
+            packet.invZ[i] = packet.invZ[0];
+        }
+
+        uint32_t active = static_cast<uint32_t>((uint64_t(1) << nb) - 1);
+        if (isValidPredicate(predicate))
+            raycastPacket(packet, node, active, predicate);
+        else
+            raycastPacket(packet, node, active, nullptr);
+        for (uint32_t i = 0; i < nb; ++i)
+            results[order[begin + i].second] = raycasts[i].result;
+        begin += nb;
+    }
+}
+
+template <class T_Container>
+inline void Raycast<T_Container>::get(Ray const* rays, size_t nbRay, T_Node const& node, Result* results, double maxDistance)
+{
+    Raycast::get(rays, nbRay, node, results, nullptr, maxDistance);
+}
+
+template <class T_Container>
+template <typename T_Predicate>
+inline typename std::enable_if<Raycast<T_Container>::template IsPredicate<T_Predicate>::value, void>::type
+Raycast<T_Container>::get(Ray const* rays, size_t nbRay, T_Octree const& octree, Result* results, T_Predicate const& predicate, double maxDistance)
+{
+    if (octree.getRootNode())
+        Raycast::get(rays, nbRay, *octree.getRootNode(), results, predicate, maxDistance);
+    else
+        std::fill(results, results + nbRay, Result());
+}
+
+template <class T_Container>
+inline void Raycast<T_Container>::get(Ray const* rays, size_t nbRay, T_Octree const& octree, Result* results, double maxDistance)
+{
+    Raycast::get(rays, nbRay, octree, results, nullptr, maxDistance);
+}
+
+template <class T_Container>
+template <typename T_Predicate>
+uint32_t Raycast<T_Container>::raycastPacket(Packet& packet, T_Node const& node, uint32_t active, T_Predicate const& predicate)
+{
+    uint32_t hits = 0;
+
+    // Inside a voxel container, or when the packet has diverged to one ray, each ray continues alone
+    if (node.getVoxelContainer() || (active & (active - 1)) == 0)
+    {
+        for (uint32_t i = 0; i < PACKET_SIZE; ++i)
+        {
+            if ((active >> i & 1) && packet.raycasts[i]->raycast(node, predicate))
+                hits |= uint32_t(1) << i;
+        }
+        return hits;
+    }
+
+    for (int i = 0; i < 8 && hits != active; ++i)
+    {
+        auto child = node.getChildren()[gl_raycast_index[packet.sortingIndex][i]];
+        if (!child)
+            continue;
+
+        uint32_t childActive = packet.intersectAABox(active & ~hits, child->getX(), child->getY(), child->getZ(), child->getSize());
+        if (childActive)
+            hits |= raycastPacket(packet, *child, childActive, predicate);
+    }
+    return hits;
+}
+
+template <class T_Container>
+uint32_t Raycast<T_Container>::Packet::intersectAABox(uint32_t active, double x, double y, double z, double size) const
+{
+    // Same operations as Ray::intersectAABox, a NaN is handled like std::minmax does
+    bool hit[PACKET_SIZE];
+    for (uint32_t i = 0; i < PACKET_SIZE; ++i)
+    {
+        float t1 = float(x - srcX[i]) * invX[i];
+        float t2 = float(x - srcX[i] + size) * invX[i];
+        float tmin = (t2 < t1) ? t2 : t1;
+        float tmax = (t2 < t1) ? t1 : t2;
+
+        t1 = float(y - srcY[i]) * invY[i];
+        t2 = float(y - srcY[i] + size) * invY[i];
+        tmin = std::max(tmin, (t2 < t1) ? t2 : t1);
+        tmax = std::min(tmax, (t2 < t1) ? t1 : t2);
+
+        t1 = float(z - srcZ[i]) * invZ[i];
+        t2 = float(z - srcZ[i] + size) * invZ[i];
+        tmin = std::max(tmin, (t2 < t1) ? t2 : t1);
+        tmax = std::min(tmax, (t2 < t1) ? t1 : t2);
+
+        hit[i] = tmax >= 0 && tmax >= tmin;
+    }
+
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < PACKET_SIZE; ++i)
+        mask |= uint32_t(hit[i]) << i;
+    return mask & active;
+}
+
+
 // Cache
 template <class T_Container>
 Raycast<T_Container>::Cache::Cache()
@@ -358,7 +585,7 @@ Raycast<T_Container>::Cache::Cache()
 
 template <class T_Container>
 Raycast<T_Container>::Cache::Cache(Cache const& other)
-    : _nodeCache(other._nodeCache)
+    : T_Octree::Listener(other), _nodeCache(other._nodeCache)
 {
 }
 
@@ -369,7 +596,25 @@ inline bool Raycast<T_Container>::Cache::empty() const
 }
 
 template <class T_Container>
-bool Raycast<T_Container>::Cache::PresenceCache::hasVoxel(Cache& cache, Vector3I const& boxPosition, int boxSize) const
+inline bool Raycast<T_Container>::Cache::PresenceCache::hasVoxel() const
+{
+    uint64_t value;
+    std::memcpy(&value, presence, sizeof(value));
+    return value != 0;
+}
+
+template <class T_Container>
+inline void Raycast<T_Container>::Cache::PresenceCache::setPresence(uint8_t x, uint8_t y, uint8_t z, bool present)
+{
+    uint8_t bit = static_cast<uint8_t>(1 << ((x >> 1 & 1) | (y & 2) | ((z & 2) << 1)));
+    if (present)
+        this->presence[(x >> 2) | (y >> 1 & 2) | (z & 4)] |= bit;
+    else
+        this->presence[(x >> 2) | (y >> 1 & 2) | (z & 4)] &= ~bit;
+}
+
+template <class T_Container>
+bool Raycast<T_Container>::Cache::PresenceCache::hasVoxel(Vector3I const& boxPosition, int boxSize) const
 {
     assert(boxSize > 1 && boxSize <= 8);
 
@@ -387,7 +632,7 @@ bool Raycast<T_Container>::Cache::PresenceCache::hasVoxel(Cache& cache, Vector3I
 
 template <class T_Container>
 template <class T_SubContainer>
-bool Raycast<T_Container>::Cache::ContainerPresenceCache<T_SubContainer>::hasVoxel(Cache& cache, Vector3I const& boxPosition, int boxSize) const
+bool Raycast<T_Container>::Cache::ContainerPresenceCache<T_SubContainer>::hasVoxel(Vector3I const& boxPosition, int boxSize) const
 {
     assert(boxSize <= T_SubContainer::NB_VOXELS);
 
@@ -401,13 +646,13 @@ bool Raycast<T_Container>::Cache::ContainerPresenceCache<T_SubContainer>::hasVox
     case 32:
         return this->presence[(boxPosition.x >> 5 & 1) | (boxPosition.y >> 4 & 2) | (boxPosition.z >> 3 & 4)] != 0;
     default:
-        return this->containerPresence[boxPosition.x >> 3 & 7][boxPosition.y >> 3 & 7][boxPosition.z >> 3 & 7].hasVoxel(cache, boxPosition, boxSize);
+        return this->containerPresence[boxPosition.x >> 3 & 7][boxPosition.y >> 3 & 7][boxPosition.z >> 3 & 7].hasVoxel(boxPosition, boxSize);
     }
 }
 
 template <class T_Container>
 template <class T_SubContainer>
-bool Raycast<T_Container>::Cache::SuperContainerPresenceCache<T_SubContainer>::hasVoxel(Cache& cache, Vector3I const& boxPosition, int boxSize) const
+bool Raycast<T_Container>::Cache::SuperContainerPresenceCache<T_SubContainer>::hasVoxel(Vector3I const& boxPosition, int boxSize) const
 {
     assert(boxSize <= T_SubContainer::NB_VOXELS);
 
@@ -425,56 +670,39 @@ bool Raycast<T_Container>::Cache::SuperContainerPresenceCache<T_SubContainer>::h
     case T_SubContainer::NB_VOXELS / 2:
         return this->presence[(boxPosition.x >> bshift2 & 1) | (boxPosition.y >> bshift1 & 2) | (boxPosition.z >> bshift & 4)] != 0;
     default:
-        return this->containerPresence[boxPosition.x >> bshift & 7][boxPosition.y >> bshift & 7][boxPosition.z >> bshift & 7]->hasVoxel(cache, boxPosition, boxSize);
-    }
-}
-
-template <class T_SubContainer>
-static bool hasVoxel(T_SubContainer const& container, uint8_t bx, uint8_t by, uint8_t bz, uint8_t boxSize)
-{
-    for (uint8_t x = 0; x < boxSize; ++x)
-    {
-        for (uint8_t y = 0; y < boxSize; ++y)
-        {
-            for (uint8_t z = 0; z < boxSize; ++z)
-            {
-                if (container.hasVoxel(x + bx, y + by, z + bz))
-                    return true;
-            }
-        }
+        return this->containerPresence[boxPosition.x >> bshift & 7][boxPosition.y >> bshift & 7][boxPosition.z >> bshift & 7]->hasVoxel(boxPosition, boxSize);
     }
-    return false;
 }
 
 template <class T_Container>
-bool Raycast<T_Container>::Cache::hasVoxel(T_Node const& node, Vector3I const& boxPosition, int boxSize)
+bool Raycast<T_Container>::Cache::hasVoxel(T_Node const& node, Vector3I const& boxPosition, int boxSize, Hint& hint) const
 {
-    if (_lastNode == &node)
-        return _lastCache ? _lastCache->hasVoxel(*this, boxPosition, boxSize) : false;
+    if (hint.node == &node)
+        return hint.cache ? hint.cache->hasVoxel(boxPosition, boxSize) : false;
 
-    _lastNode = &node;
+    hint.node = &node;
     auto it = _nodeCache->find(&node);
     if (it == _nodeCache->end())
     {
-        _lastCache = nullptr;
+        hint.cache = nullptr;
         return false;
     }
-    _lastCache = &it->second;
-    return it->second.hasVoxel(*this, boxPosition, boxSize);
+    hint.cache = &it->second;
+    return it->second.hasVoxel(boxPosition, boxSize);
 }
 
 template <class T_Container>
-bool Raycast<T_Container>::Cache::fillHasVoxel(T_Node const& node, Vector3I const& boxPosition, int boxSize)
+bool Raycast<T_Container>::Cache::fillHasVoxel(T_Node const& node, Vector3I const& boxPosition, int boxSize, Hint& hint)
 {
-    if (_lastNode == &node)
-        return _lastCache ? _lastCache->hasVoxel(*this, boxPosition, boxSize) : false;
+    if (hint.node == &node && hint.cache)
+        return hint.cache->hasVoxel(boxPosition, boxSize);
 
-    _lastNode = &node;
+    hint.node = &node;
     auto pair = _nodeCache->emplace(&node, NodeCache{});
-    if (pair.second)
-        this->fillCache(node, pair.first->second);
-    _lastCache = &pair.first->second;
-    return pair.first->second.hasVoxel(*this, boxPosition, boxSize);
+    if (pair.second && node.getVoxelContainer())
+        this->fillCache(*node.getVoxelContainer(), pair.first->second);
+    hint.cache = &pair.first->second;
+    return pair.first->second.hasVoxel(boxPosition, boxSize);
 }
 
 template <class T_Container>
@@ -533,7 +761,7 @@ void Raycast<T_Container>::Cache::fillCache(T_SubContainer const& container, Pre
         {
             for (uint8_t z = 0; z < T_SubContainer::NB_VOXELS; z += 2)
             {
-                if (voxomap::hasVoxel(container, x, y, z, 2))
+                if (container.getOccupancy().testBox(x, y, z, 2))
                 {
                     cache.presence[(x >> 2) | (y >> 1 & 2) | (z & 4)] |=
                         1 << ((x >> 1 & 1) | (y & 2) | ((z & 2) << 1));
@@ -564,7 +792,132 @@ void Raycast<T_Container>::Cache::fillCache(T_Node const& node)
 template <class T_Container>
 void Raycast<T_Container>::Cache::fillCache(T_Octree const& octree)
 {
-    this->fillCache(*octree.getRootNode());
+    if (octree.getRootNode())
+        this->fillCache(*octree.getRootNode());
+}
+
+template <class T_Container>
+template <class T_SubContainer, typename T_Cache>
+void Raycast<T_Container>::Cache::updateCache(T_SubContainer const& container, T_Cache& cache, iterator const& it)
+{
+    auto const& position = it.containerPosition[T_SubContainer::SUPERCONTAINER_ID];
+    auto& subCache = cache.containerPresence[position.x][position.y][position.z];
+    auto subContainer = container.findContainer(position.x, position.y, position.z);
+    if (!subContainer)
+        subCache.reset();
+    else if (!subCache)
+    {
+        subCache.reset(new typename T_Cache::SubCache);
+        this->fillCache(*subContainer, *subCache);
+    }
+    else
+        this->updateCache(*subContainer, *subCache, it);
+
+    cache.setPresence(position.x, position.y, position.z, Cache::hasContainerInBox(container, position.x, position.y, position.z));
+}
+
+template <class T_Container>
+template <class T_SubContainer>
+void Raycast<T_Container>::Cache::updateCache(T_SubContainer const& container, ContainerPresenceCache<T_SubContainer>& cache, iterator const& it)
+{
+    auto const& position = it.containerPosition[T_SubContainer::SUPERCONTAINER_ID];
+    auto& subCache = cache.containerPresence[position.x][position.y][position.z];
+    auto subContainer = container.findContainer(position.x, position.y, position.z);
+    if (subContainer)
+        this->updateCache(*subContainer, subCache, it);
+    else
+        subCache = PresenceCache();
+
+    cache.setPresence(position.x, position.y, position.z, Cache::hasContainerInBox(container, position.x, position.y, position.z));
+}
+
+template <class T_Container>
+template <class T_SubContainer>
+void Raycast<T_Container>::Cache::updateCache(T_SubContainer const& container, PresenceCache& cache, iterator const& it)
+{
+    cache.setPresence(it.x, it.y, it.z, container.getOccupancy().testBox(it.x & ~1, it.y & ~1, it.z & ~1, 2));
+}
+
+template <class T_Container>
+template <class T_SubContainer>
+bool Raycast<T_Container>::Cache::hasContainerInBox(T_SubContainer const& container, uint8_t x, uint8_t y, uint8_t z)
+{
+    x &= ~1;
+    y &= ~1;
+    z &= ~1;
+    for (uint8_t i = 0; i < 8; ++i)
+    {
+        if (container.hasContainer(x + (i & 1), y + (i >> 1 & 1), z + (i >> 2 & 1)))
+            return true;
+    }
+    return false;
+}
+
+template <class T_Container>
+void Raycast<T_Container>::Cache::subscribe(T_Octree& octree)
+{
+    _nodeCache->clear();
+    this->fillCache(octree);
+    octree.addListener(*this);
+}
+
+template <class T_Container>
+void Raycast<T_Container>::Cache::onVoxelModified(iterator const& it)
+{
+    auto container = const_cast<T_Node const*>(it.node)->getVoxelContainer();
+    if (!container)
+    {
+        _nodeCache->erase(it.node);
+        return;
+    }
+
+    auto pair = _nodeCache->emplace(it.node, NodeCache{});
+    if (pair.second)
+        this->fillCache(*container, pair.first->second);
+    else
+        this->updateCache(*container, pair.first->second, it);
+}
+
+template <class T_Container>
+void Raycast<T_Container>::Cache::onLeafModified(T_Node const& node)
+{
+    _nodeCache->erase(&node);
+    if (node.getVoxelContainer())
+        this->fillCache(*node.getVoxelContainer(), (*_nodeCache)[&node]);
+}
+
+template <class T_Container>
+void Raycast<T_Container>::Cache::onLeafRemoving(T_Node const& node)
+{
+    _nodeCache->erase(&node);
+}
+
+template <class T_Container>
+void Raycast<T_Container>::Cache::memoryUsage(MemoryUsage& usage) const
+{
+    // Approximation of the unordered_map memory: the bucket array and one allocated element by entry
+    usage.raycastCaches += sizeof(*this) + _nodeCache->bucket_count() * sizeof(void*);
+    for (auto const& pair : *_nodeCache)
+        usage.raycastCaches += sizeof(void*) + sizeof(pair) + pair.second.getHeapMemory();
+}
+
+template <class T_Container>
+template <typename T_SubContainer>
+size_t Raycast<T_Container>::Cache::SuperContainerPresenceCache<T_SubContainer>::getHeapMemory() const
+{
+    size_t memory = 0;
+    for (auto const& plane : containerPresence)
+    {
+        for (auto const& line : plane)
+        {
+            for (auto const& subCache : line)
+            {
+                if (subCache)
+                    memory += sizeof(SubCache) + subCache->getHeapMemory();
+            }
+        }
+    }
+    return memory;
 }
 
 } // End namespace voxomap
\ No newline at end of file
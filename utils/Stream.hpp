@@ -0,0 +1,127 @@
+#ifndef _VOXOMAP_STREAM_HPP_
+#define _VOXOMAP_STREAM_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace voxomap
+{
+
+/*! \class StreamWriter
+    \ingroup Utility
+    \brief Sink of the streaming serialization
+    \details The data is gathered in a fixed-size buffer, given to the output function each time the buffer is full.
+    The memory used doesn't depend on the size of the serialized data.
+*/
+class StreamWriter
+{
+public:
+    /*!
+        \brief Output function: bool(char const* data, size_t size), returns false on error
+    */
+    using Output = std::function<bool(char const*, size_t)>;
+
+    /*!
+        \brief Constructs a writer on an output function
+        \param output Function called with each full buffer
+        \param bufferSize Size of the buffer
+    */
+    explicit StreamWriter(Output output, size_t bufferSize = 1 << 16);
+    /*!
+        \brief Constructs a writer on a standard stream
+        \param stream The output stream, must outlive the writer
+        \param bufferSize Size of the buffer
+    */
+    explicit StreamWriter(std::ostream& stream, size_t bufferSize = 1 << 16);
+    StreamWriter(StreamWriter const& other) = delete;
+    /*!
+        \brief Destructor, flushes the buffer
+    */
+    ~StreamWriter();
+    StreamWriter& operator=(StreamWriter const& other) = delete;
+
+    /*!
+        \brief Writes \a size bytes
+        \return False if the output failed
+    */
+    bool                write(char const* data, size_t size);
+    /*!
+        \brief Gives the buffered data to the output function
+        \return False if the output failed
+    */
+    bool                flush();
+    /*!
+        \brief Returns false if the output failed
+    */
+    bool                good() const;
+    /*!
+        \brief Returns the number of bytes written, including the buffered ones
+    */
+    size_t              getSize() const;
+
+private:
+    Output              _output;            //!< Output function
+    std::vector<char>   _buffer;            //!< Data not yet given to the output function
+    size_t              _bufferSize = 0;    //!< Number of bytes used in \a _buffer
+    size_t              _size = 0;          //!< Number of bytes written
+    bool                _good = true;       //!< False if the output failed
+};
+
+/*! \class StreamReader
+    \ingroup Utility
+    \brief Source of the streaming unserialization
+    \details The data is read by blocks from the input function. A read returns a contiguous memory area
+    valid until the next read, the buffer only grows to fit the largest area read.
+*/
+class StreamReader
+{
+public:
+    /*!
+        \brief Input function: size_t(char* data, size_t size), returns the number of bytes read, 0 at the end
+    */
+    using Input = std::function<size_t(char*, size_t)>;
+
+    /*!
+        \brief Constructs a reader on an input function
+        \param input Function filling the buffer
+        \param bufferSize Initial size of the buffer
+    */
+    explicit StreamReader(Input input, size_t bufferSize = 1 << 16);
+    /*!
+        \brief Constructs a reader on a standard stream
+        \param stream The input stream, must outlive the reader
+        \param bufferSize Initial size of the buffer
+    */
+    explicit StreamReader(std::istream& stream, size_t bufferSize = 1 << 16);
+
+    /*!
+        \brief Reads \a size bytes
+        \return Pointer on the data, valid until the next read, nullptr if there is not enough data
+    */
+    char const*         read(size_t size);
+    /*!
+        \brief Reads \a size bytes in \a data
+        \return False if there is not enough data
+    */
+    bool                read(char* data, size_t size);
+    /*!
+        \brief Returns the number of bytes read
+    */
+    size_t              getSize() const;
+
+private:
+    Input               _input;             //!< Input function
+    std::vector<char>   _buffer;            //!< Data received from the input function
+    size_t              _begin = 0;         //!< Position of the first unread byte in \a _buffer
+    size_t              _end = 0;           //!< Position after the last received byte in \a _buffer
+    size_t              _size = 0;          //!< Number of bytes read
+};
+
+}
+
+#include "Stream.ipp"
+
+#endif // _VOXOMAP_STREAM_HPP_
@@ -0,0 +1,116 @@
+#include <cstring>
+
+namespace voxomap
+{
+
+// StreamWriter
+inline StreamWriter::StreamWriter(Output output, size_t bufferSize)
+    : _output(std::move(output)), _buffer(bufferSize ? bufferSize : 1)
+{
+}
+
+inline StreamWriter::StreamWriter(std::ostream& stream, size_t bufferSize)
+    : StreamWriter([&stream](char const* data, size_t size) {
+        return static_cast<bool>(stream.write(data, static_cast<std::streamsize>(size)));
+    }, bufferSize)
+{
+}
+
+inline StreamWriter::~StreamWriter()
+{
+    this->flush();
+}
+
+inline bool StreamWriter::write(char const* data, size_t size)
+{
+    if (!_good)
+        return false;
+    _size += size;
+
+    if (_bufferSize + size > _buffer.size())
+    {
+        if (!this->flush())
+            return false;
+        // Data larger than the buffer is given directly
+        if (size >= _buffer.size())
+            return _good = _output(data, size);
+    }
+    std::memcpy(&_buffer[_bufferSize], data, size);
+    _bufferSize += size;
+    return true;
+}
+
+inline bool StreamWriter::flush()
+{
+    if (_good && _bufferSize)
+        _good = _output(_buffer.data(), _bufferSize);
+    _bufferSize = 0;
+    return _good;
+}
+
+inline bool StreamWriter::good() const
+{
+    return _good;
+}
+
+inline size_t StreamWriter::getSize() const
+{
+    return _size;
+}
+
+
+// StreamReader
+inline StreamReader::StreamReader(Input input, size_t bufferSize)
+    : _input(std::move(input)), _buffer(bufferSize ? bufferSize : 1)
+{
+}
+
+inline StreamReader::StreamReader(std::istream& stream, size_t bufferSize)
+    : StreamReader([&stream](char* data, size_t size) {
+        stream.read(data, static_cast<std::streamsize>(size));
+        return static_cast<size_t>(stream.gcount());
+    }, bufferSize)
+{
+}
+
+inline char const* StreamReader::read(size_t size)
+{
+    if (_end - _begin < size)
+    {
+        // Move the unread data at the beginning of the buffer, and grow it if needed
+        std::memmove(_buffer.data(), _buffer.data() + _begin, _end - _begin);
+        _end -= _begin;
+        _begin = 0;
+        if (_buffer.size() < size)
+            _buffer.resize(size);
+
+        while (_end < size)
+        {
+            size_t nb_read = _input(&_buffer[_end], _buffer.size() - _end);
+            if (nb_read == 0)
+                return nullptr;
+            _end += nb_read;
+        }
+    }
+
+    char const* data = _buffer.data() + _begin;
+    _begin += size;
+    _size += size;
+    return data;
+}
+
+inline bool StreamReader::read(char* data, size_t size)
+{
+    auto result = this->read(size);
+    if (!result)
+        return false;
+    std::memcpy(data, result, size);
+    return true;
+}
+
+inline size_t StreamReader::getSize() const
+{
+    return _size;
+}
+
+}
@@ -0,0 +1,77 @@
+#ifndef _VOXOMAP_THREADPOOL_HPP_
+#define _VOXOMAP_THREADPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace voxomap
+{
+
+/*! \class ThreadPool
+    \ingroup Utility
+    \brief Persistent pool of worker threads used by the parallel explore methods
+    \details Threads are created once and wait for jobs, so a pool can be reused
+    for each scan without the cost of creating threads.
+*/
+class ThreadPool
+{
+public:
+    /*!
+        \brief Constructs a pool
+        \param nbThreads Number of threads working on a job, including the calling thread.
+        If 0, std::thread::hardware_concurrency() is used.
+    */
+    explicit ThreadPool(unsigned int nbThreads = 0);
+    ThreadPool(ThreadPool const& other) = delete;
+    /*!
+        \brief Destructor, waits for the workers
+    */
+    ~ThreadPool();
+    ThreadPool& operator=(ThreadPool const& other) = delete;
+
+    /*!
+        \brief Number of threads working on a job, including the calling thread
+    */
+    unsigned int        getNbThreads() const;
+    /*!
+        \brief Calls \a task for each index in [0, nbTasks) and waits the end of all tasks
+        \details The calling thread also executes tasks. Tasks are distributed one at
+        a time, so tasks with unbalanced costs are spread over the threads.
+        Only one job can run at the same time on a pool.
+        \param nbTasks Number of tasks
+        \param task Function called with the index of the task
+    */
+    void                parallelFor(size_t nbTasks, std::function<void(size_t)> const& task);
+
+private:
+    /*!
+        \brief Loop of the worker threads
+    */
+    void                workerLoop();
+    /*!
+        \brief Executes tasks of the current job until there is no more task
+    */
+    void                runTasks();
+
+    std::vector<std::thread>            _threads;                   //!< Worker threads
+    std::mutex                          _mutex;                     //!< Mutex protecting the job state
+    std::condition_variable             _jobCondition;              //!< Notified when a job starts or when the pool stops
+    std::condition_variable             _endCondition;              //!< Notified when a worker finishes the current job
+    std::function<void(size_t)> const*  _task = nullptr;            //!< Task of the current job
+    size_t                              _nbTasks = 0;               //!< Number of tasks of the current job
+    std::atomic<size_t>                 _nextTask;                  //!< Index of the next task to execute
+    size_t                              _nbActiveWorkers = 0;       //!< Number of workers still executing the current job
+    size_t                              _jobId = 0;                 //!< Incremented at each job
+    bool                                _stop = false;              //!< True when the pool is destroyed
+};
+
+}
+
+#include "ThreadPool.ipp"
+
+#endif // _VOXOMAP_THREADPOOL_HPP_
@@ -0,0 +1,85 @@
+namespace voxomap
+{
+
+inline ThreadPool::ThreadPool(unsigned int nbThreads)
+    : _nextTask(0)
+{
+    if (nbThreads == 0)
+        nbThreads = std::thread::hardware_concurrency();
+    // The calling thread is also used, so one thread less is created
+    for (unsigned int i = 1; i < nbThreads; ++i)
+        _threads.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _jobCondition.notify_all();
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+inline unsigned int ThreadPool::getNbThreads() const
+{
+    return static_cast<unsigned int>(_threads.size() + 1);
+}
+
+inline void ThreadPool::parallelFor(size_t nbTasks, std::function<void(size_t)> const& task)
+{
+    if (_threads.empty() || nbTasks <= 1)
+    {
+        for (size_t i = 0; i < nbTasks; ++i)
+            task(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _task = &task;
+        _nbTasks = nbTasks;
+        _nextTask = 0;
+        _nbActiveWorkers = _threads.size();
+        ++_jobId;
+    }
+    _jobCondition.notify_all();
+
+    this->runTasks();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _endCondition.wait(lock, [this]() { return _nbActiveWorkers == 0; });
+    _task = nullptr;
+    _nbTasks = 0;
+}
+
+inline void ThreadPool::workerLoop()
+{
+    size_t lastJobId = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _jobCondition.wait(lock, [this, lastJobId]() { return _stop || _jobId != lastJobId; });
+            if (_stop)
+                return;
+            lastJobId = _jobId;
+        }
+
+        this->runTasks();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_nbActiveWorkers == 0)
+            _endCondition.notify_one();
+    }
+}
+
+inline void ThreadPool::runTasks()
+{
+    for (size_t i = _nextTask++; i < _nbTasks; i = _nextTask++)
+        (*_task)(i);
+}
+
+}
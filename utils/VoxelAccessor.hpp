@@ -0,0 +1,160 @@
+#ifndef _VOXOMAP_VOXELACCESSOR_HPP_
+#define _VOXOMAP_VOXELACCESSOR_HPP_
+
+#include <utility>
+#include "Vector3.hpp"
+
+namespace voxomap
+{
+
+template <class T_Container> class VoxelOctree;
+template <class T_Container> class VoxelNode;
+
+/*! \struct SuperContainerCache
+    \ingroup Utility
+    \brief Last sub-container found at each level of the super container \a T_SuperContainer, used by VoxelAccessor
+    \details The last level, whose sub-containers are the voxel containers, is not cached here:
+    VoxelAccessor keeps the last voxel container found.
+*/
+template <class T_SuperContainer, bool = (T_SuperContainer::NB_SUPERCONTAINER > 1)>
+struct SuperContainerCache
+{
+    using Container = typename T_SuperContainer::Container;
+
+    /*!
+        \brief Find the voxel of \a it inside \a superContainer, from the cached sub-containers if they contain it
+        \param superContainer The super container, the same one on each call until reset
+        \param it Iterator initialized with the position of the voxel
+        \param position Absolute position of the voxel
+        \return The found voxel, nullptr otherwise
+    */
+    template <typename Iterator>
+    typename T_SuperContainer::VoxelData* findVoxel(T_SuperContainer& superContainer, Iterator& it, Vector3I const& position);
+    /*!
+        \brief Forget the cached sub-containers
+    */
+    void reset();
+
+    Container*                      container = nullptr;    //!< Last sub-container found
+    Vector3I                        containerPosition;      //!< Position of \a container
+    SuperContainerCache<Container>  next;                   //!< Cache of the levels inside \a container
+};
+
+template <class T_SuperContainer>
+struct SuperContainerCache<T_SuperContainer, false>
+{
+    template <typename Iterator>
+    typename T_SuperContainer::VoxelData* findVoxel(T_SuperContainer& superContainer, Iterator& it, Vector3I const& position);
+    void reset();
+};
+
+/*! \class VoxelAccessor
+    \ingroup Utility
+    \brief Accessor that keeps the last leaf node and the last voxel container found,
+    to speed up the queries in spatially coherent order
+    \details A query inside the last voxel container doesn't browse the super containers,
+    a query inside the last sub-container of a super container starts from this sub-container,
+    a query inside the last leaf doesn't browse the octree, and a query outside the last leaf
+    only goes up the parents of the leaf until a node containing the voxel, before going down.
+    If the leaf index of the octree is enabled, it is used instead of going up the parents.
+
+    The accessor must be reset if the octree is modified by other means than the accessor,
+    like an iterator it can keep pointers on removed nodes or containers.
+*/
+template <class T_Container>
+class VoxelAccessor
+{
+public:
+    using VoxelData = typename T_Container::VoxelData;
+    using VoxelContainer = typename T_Container::VoxelContainer;
+    using iterator = typename T_Container::iterator;
+
+    /*!
+        \brief Constructor
+        \param octree The octree accessed
+    */
+    VoxelAccessor(VoxelOctree<T_Container>& octree);
+
+    /*!
+        \brief Find voxel
+        \param x X position of the voxel
+        \param y Y position of the voxel
+        \param z Z position of the voxel
+        \return Iterator on the found voxel, invalid iterator otherwise
+    */
+    iterator                findVoxel(int x, int y, int z);
+    /*!
+        \brief Find the node that can contains the voxel
+        \param x X position of the voxel
+        \param y Y position of the voxel
+        \param z Z position of the voxel
+        \return The pointer on the found node, nullptr otherwise
+    */
+    VoxelNode<T_Container>* findVoxelNode(int x, int y, int z);
+    /*!
+        \brief Add the voxel if not exist
+        \param x X position of the voxel
+        \param y Y position of the voxel
+        \param z Z position of the voxel
+        \param args Arguments forward to VoxelData constructor
+        \return Same as VoxelOctree::addVoxel
+    */
+    template <typename... Args>
+    std::pair<iterator, bool> addVoxel(int x, int y, int z, Args&&... args);
+    /*!
+        \brief Update the voxel if already exist
+        \param x X position of the voxel
+        \param y Y position of the voxel
+        \param z Z position of the voxel
+        \param args Arguments forward to VoxelData constructor
+        \return Iterator on the updated voxel, invalid iterator if the voxel doesn't exist
+    */
+    template <typename... Args>
+    iterator                updateVoxel(int x, int y, int z, Args&&... args);
+    /*!
+        \brief Add or update the voxel
+        \param x X position of the voxel
+        \param y Y position of the voxel
+        \param z Z position of the voxel
+        \param args Arguments forward to VoxelData constructor
+        \return Iterator on the voxel
+    */
+    template <typename... Args>
+    iterator                putVoxel(int x, int y, int z, Args&&... args);
+    /*!
+        \brief Removes a voxel
+        \param x X position of the voxel
+        \param y Y position of the voxel
+        \param z Z position of the voxel
+        \param args Arguments forward to removeVoxel area method
+        \return True if success
+    */
+    template <typename... Args>
+    bool                    removeVoxel(int x, int y, int z, Args&&... args);
+
+    /*!
+        \brief Forget the cached leaf and voxel container
+    */
+    void                    reset();
+
+private:
+    /*!
+        \brief Keep the voxel container of \a it after a write
+        \param it Iterator on the written voxel
+        \param container Container of the leaf before the write
+    */
+    void                    keepVoxelContainer(iterator const& it, T_Container const* container);
+
+    VoxelOctree<T_Container>*       _octree = nullptr;          //!< Accessed octree
+    VoxelNode<T_Container>*         _node = nullptr;            //!< Last found leaf node
+    T_Container*                    _container = nullptr;       //!< Container of \a _node browsed by \a _subContainers
+    SuperContainerCache<T_Container> _subContainers;            //!< Last sub-containers found inside \a _container
+    VoxelContainer*                 _voxelContainer = nullptr;  //!< Last found voxel container, inside \a _node
+    Vector3I                        _containerPosition;         //!< Position of \a _voxelContainer
+};
+
+}
+
+#include "VoxelAccessor.ipp"
+
+#endif // _VOXOMAP_VOXELACCESSOR_HPP_
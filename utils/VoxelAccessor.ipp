@@ -0,0 +1,225 @@
+namespace voxomap
+{
+
+template <class T_SuperContainer, bool T_HasSuperContainer>
+template <typename Iterator>
+typename T_SuperContainer::VoxelData* SuperContainerCache<T_SuperContainer, T_HasSuperContainer>::findVoxel(T_SuperContainer& superContainer, Iterator& it, Vector3I const& position)
+{
+    Vector3I subPosition(position.x & Container::COORD_MASK, position.y & Container::COORD_MASK, position.z & Container::COORD_MASK);
+    if (!container || containerPosition != subPosition)
+    {
+        auto const& internalPosition = it.containerPosition[T_SuperContainer::SUPERCONTAINER_ID];
+        container = superContainer.findContainer(internalPosition.x, internalPosition.y, internalPosition.z);
+        containerPosition = subPosition;
+        next.reset();
+        if (!container)
+            return nullptr;
+    }
+    return next.findVoxel(*container, it, position);
+}
+
+template <class T_SuperContainer, bool T_HasSuperContainer>
+inline void SuperContainerCache<T_SuperContainer, T_HasSuperContainer>::reset()
+{
+    container = nullptr;
+    next.reset();
+}
+
+template <class T_SuperContainer>
+template <typename Iterator>
+inline typename T_SuperContainer::VoxelData* SuperContainerCache<T_SuperContainer, false>::findVoxel(T_SuperContainer& superContainer, Iterator& it, Vector3I const&)
+{
+    return superContainer.findVoxel(it);
+}
+
+template <class T_SuperContainer>
+inline void SuperContainerCache<T_SuperContainer, false>::reset()
+{
+}
+
+template <class T_Container>
+VoxelAccessor<T_Container>::VoxelAccessor(VoxelOctree<T_Container>& octree)
+    : _octree(&octree)
+{
+}
+
+template <class T_Container>
+typename VoxelAccessor<T_Container>::iterator VoxelAccessor<T_Container>::findVoxel(int x, int y, int z)
+{
+    iterator it;
+    it.initPosition(x, y, z);
+
+    auto node = this->findVoxelNode(x, y, z);
+    if (!node)
+        return it;
+
+    Vector3I containerPosition(x & VoxelContainer::COORD_MASK, y & VoxelContainer::COORD_MASK, z & VoxelContainer::COORD_MASK);
+    if (_voxelContainer && _containerPosition == containerPosition)
+    {
+        it.node = node;
+        it.voxel = _voxelContainer->findVoxel(it);
+        return it;
+    }
+
+    it.node = node;
+    T_Container* container = node->getVoxelContainer();
+    if (!container)
+        return it;
+    // The container of the leaf is replaced by a copy on write
+    if (container != _container)
+    {
+        _container = container;
+        _subContainers.reset();
+    }
+    it.voxel = _subContainers.findVoxel(*container, it, Vector3I(x, y, z));
+    _voxelContainer = it.voxelContainer;
+    _containerPosition = containerPosition;
+    return it;
+}
+
+template <class T_Container>
+VoxelNode<T_Container>* VoxelAccessor<T_Container>::findVoxelNode(int x, int y, int z)
+{
+    x &= T_Container::COORD_MASK;
+    y &= T_Container::COORD_MASK;
+    z &= T_Container::COORD_MASK;
+
+    if (_node && _node->getX() == x && _node->getY() == y && _node->getZ() == z)
+        return _node;
+
+    VoxelNode<T_Container>* node;
+    if (_node && !_octree->isLeafIndexEnabled())
+    {
+        // Go up the parents of the last leaf only as far as needed
+        node = _node->findNode(x, y, z, T_Container::NB_VOXELS);
+    }
+    else
+    {
+        VoxelNode<T_Container> const* hint = nullptr;
+        node = static_cast<VoxelOctree<T_Container> const*>(_octree)->findVoxelNode(x, y, z, hint);
+    }
+
+    // The last leaf is kept on a miss, the next queries can be near it
+    if (node)
+    {
+        _node = node;
+        _container = nullptr;
+        _voxelContainer = nullptr;
+    }
+    return node;
+}
+
+template <class T_Container>
+template <typename... Args>
+std::pair<typename VoxelAccessor<T_Container>::iterator, bool> VoxelAccessor<T_Container>::addVoxel(int x, int y, int z, Args&&... args)
+{
+    auto it = this->findVoxel(x, y, z);
+    if (it)
+        return std::make_pair(it, false);
+
+    if (!it.node)
+    {
+        auto result = _octree->addVoxel(x, y, z, std::forward<Args>(args)...);
+        _node = result.first.node;
+        this->keepVoxelContainer(result.first, nullptr);
+        return result;
+    }
+    T_Container const* container = it.node->getVoxelContainer();
+    it.node->addVoxel(it, std::forward<Args>(args)...);
+    this->keepVoxelContainer(it, container);
+    return std::make_pair(it, true);
+}
+
+template <class T_Container>
+template <typename... Args>
+typename VoxelAccessor<T_Container>::iterator VoxelAccessor<T_Container>::updateVoxel(int x, int y, int z, Args&&... args)
+{
+    auto it = this->findVoxel(x, y, z);
+    if (!it)
+        return iterator();
+
+    T_Container const* container = it.node->getVoxelContainer();
+    it.node->updateVoxel(it, std::forward<Args>(args)...);
+    this->keepVoxelContainer(it, container);
+    return it;
+}
+
+template <class T_Container>
+template <typename... Args>
+typename VoxelAccessor<T_Container>::iterator VoxelAccessor<T_Container>::putVoxel(int x, int y, int z, Args&&... args)
+{
+    auto it = this->findVoxel(x, y, z);
+
+    if (!it.node)
+    {
+        it = _octree->putVoxel(x, y, z, std::forward<Args>(args)...);
+        _node = it.node;
+        this->keepVoxelContainer(it, nullptr);
+        return it;
+    }
+    T_Container const* container = it.node->getVoxelContainer();
+    it.node->putVoxel(it, std::forward<Args>(args)...);
+    this->keepVoxelContainer(it, container);
+    return it;
+}
+
+template <class T_Container>
+template <typename... Args>
+bool VoxelAccessor<T_Container>::removeVoxel(int x, int y, int z, Args&&... args)
+{
+    auto it = this->findVoxel(x, y, z);
+    if (!it)
+        return false;
+
+    // The leaf is removed with its last voxel, and maybe some of its parents
+    if (it.node->getNbVoxel() == 1)
+    {
+        this->reset();
+        return it.node->removeVoxel(it, std::forward<Args>(args)...);
+    }
+    // The sub-containers are removed with their last voxel
+    if (it.voxelContainer->getNbVoxel() == 1)
+    {
+        _container = nullptr;
+        _voxelContainer = nullptr;
+        return it.node->removeVoxel(it, std::forward<Args>(args)...);
+    }
+    T_Container const* container = it.node->getVoxelContainer();
+    bool result = it.node->removeVoxel(it, std::forward<Args>(args)...);
+    // The voxel container of the iterator is the one before the copy on write
+    if (it.node->getVoxelContainer() != container)
+    {
+        _container = nullptr;
+        _voxelContainer = nullptr;
+    }
+    return result;
+}
+
+template <class T_Container>
+void VoxelAccessor<T_Container>::reset()
+{
+    _node = nullptr;
+    _container = nullptr;
+    _voxelContainer = nullptr;
+}
+
+template <class T_Container>
+void VoxelAccessor<T_Container>::keepVoxelContainer(iterator const& it, T_Container const* container)
+{
+    if (!it.node)
+    {
+        _container = nullptr;
+        _voxelContainer = nullptr;
+        return;
+    }
+    // The container of the leaf is created or copied by the write, the sub-containers found inside the previous one are lost
+    if (it.node->getVoxelContainer() != container)
+        _container = nullptr;
+
+    int x, y, z;
+    it.getVoxelPosition(x, y, z);
+    _voxelContainer = it.voxelContainer;
+    _containerPosition = Vector3I(x & VoxelContainer::COORD_MASK, y & VoxelContainer::COORD_MASK, z & VoxelContainer::COORD_MASK);
+}
+
+}
@@ -0,0 +1,206 @@
+#ifndef _VOXOMAP_FROZENVOXELOCTREE_HPP_
+#define _VOXOMAP_FROZENVOXELOCTREE_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "VoxelOctree.hpp"
+#include "../utils/MemoryUsage.hpp"
+
+namespace voxomap
+{
+
+/*! \class FrozenVoxelOctree
+    \ingroup VoxelOctree
+    \brief Read-only copy of a VoxelOctree with a compact layout
+    \details The nodes are stored in a single array in breadth-first order, without pointers:
+    a node only keeps the index of its first child and a mask of its children.
+    The leaves are stored in a second array as a position and a voxel container, shared with the source octree,
+    the copy on write of VoxelNode keeps the frozen octree unchanged when the source octree is modified.
+    The iterators need a VoxelNode: the explorations and the ray casts use a temporary node for each leaf,
+    the nodes returned by findVoxel and findVoxelNode are created on the first call and kept until the octree is destroyed.
+    The const methods can be called from several threads at the same time.
+*/
+template <class T_Container>
+class FrozenVoxelOctree
+{
+public:
+    using VoxelData = typename T_Container::VoxelData;
+    using iterator = typename T_Container::iterator;
+
+    static const uint32_t NO_INDEX = UINT32_MAX;   //!< Invalid node or leaf index
+
+    /*! \struct Node
+        \brief Node of the frozen octree
+    */
+    struct Node
+    {
+        int         x = 0;                  //!< X coordinate
+        int         y = 0;                  //!< Y coordinate
+        int         z = 0;                  //!< Z coordinate
+        uint32_t    size = 0;               //!< Size of the node
+        uint32_t    firstChild = NO_INDEX;  //!< Index of the first child, the children are consecutive
+        uint32_t    leaf = NO_INDEX;        //!< Index of the leaf, NO_INDEX if the node is not a leaf
+        uint8_t     childMask = 0;          //!< Bit i is set if the child i exists
+
+        /*!
+            \brief Returns the index of the child \a i, NO_INDEX if it doesn't exist
+        */
+        uint32_t    getChild(int i) const;
+        /*!
+            \brief Returns the id of the child that can contain the position
+        */
+        int         getChildPos(int x, int y, int z) const;
+    };
+
+    /*! \struct Leaf
+        \brief Leaf of the frozen octree, its size is T_Container::NB_VOXELS
+    */
+    struct Leaf
+    {
+        int         x = 0;                  //!< X coordinate
+        int         y = 0;                  //!< Y coordinate
+        int         z = 0;                  //!< Z coordinate
+        std::shared_ptr<T_Container> container; //!< Voxel container, shared with the source octree
+    };
+
+    /*!
+        \brief Default constructor, empty octree
+    */
+    FrozenVoxelOctree() = default;
+    /*!
+        \brief Builds the frozen copy of \a octree
+    */
+    explicit FrozenVoxelOctree(VoxelOctree<T_Container> const& octree);
+    /*!
+        \brief Copy constructor, the leaf nodes are not copied
+    */
+    FrozenVoxelOctree(FrozenVoxelOctree const& other);
+    /*!
+        \brief Move constructor
+    */
+    FrozenVoxelOctree(FrozenVoxelOctree&& other) = default;
+    /*!
+        \brief Destructor, releases the leaf nodes
+    */
+    ~FrozenVoxelOctree();
+
+    /*!
+        \brief Assignement operator, the leaf nodes are not copied
+    */
+    FrozenVoxelOctree&      operator=(FrozenVoxelOctree const& other);
+    /*!
+        \brief Move assignement operator
+    */
+    FrozenVoxelOctree&      operator=(FrozenVoxelOctree&& other);
+
+    /*!
+        \brief Replaces the content by the frozen copy of \a octree
+    */
+    void                    freeze(VoxelOctree<T_Container> const& octree);
+    /*!
+        \brief Returns a VoxelOctree with the voxels of the frozen octree
+        \details The containers are shared until they are modified.
+    */
+    VoxelOctree<T_Container> thaw() const;
+
+    /*!
+        \brief Returns a voxel iterator
+        \param x X coordinate
+        \param y Y coordinate
+        \param z Z coordinate
+        \return iterator
+    */
+    template <typename T>
+    iterator                findVoxel(T x, T y, T z) const;
+    /*!
+        \brief Returns the leaf node that contain the voxel, can be NULL
+        \details The node is created on the first call.
+        \param x X coordinate
+        \param y Y coordinate
+        \param z Z coordinate
+    */
+    VoxelNode<T_Container> const* findVoxelNode(int x, int y, int z) const;
+    /*!
+        \brief Browse all voxels
+        \details The node of the iterators is only valid during the call of \a predicate.
+        \param predicate Function called for each voxel: void(iterator const&)
+    */
+    template <typename T_Predicate>
+    void                    exploreVoxel(T_Predicate const& predicate) const;
+    /*!
+        \brief Browse all voxel containers
+        \param predicate Function called for each voxel container: void(VoxelContainer const&)
+    */
+    template <typename T_Predicate>
+    void                    exploreVoxelContainer(T_Predicate const& predicate) const;
+
+    /*!
+        \brief Returns true if there is no voxel
+    */
+    bool                    empty() const;
+    /*!
+        \brief Get the number of voxels
+    */
+    unsigned int            getNbVoxels() const;
+    /*!
+        \brief Returns the nodes, the root node is the first one
+    */
+    std::vector<Node> const& getNodes() const;
+    /*!
+        \brief Returns the leaf \a index
+    */
+    Leaf const&             getLeaf(uint32_t index) const;
+    /*!
+        \brief Returns the node of the leaf \a index, created on the first call
+    */
+    VoxelNode<T_Container> const& getLeafNode(uint32_t index) const;
+    /*!
+        \brief Gives the container of the leaf \a index to \a node, a temporary node at the position of the leaf
+        \details The container is not owned by \a node, it must be destroyed before the frozen octree.
+    */
+    void                    initLeafNode(uint32_t index, VoxelNode<T_Container>& node) const;
+    /*!
+        \brief Returns the memory used by the frozen octree, split by category
+        \details The containers shared with other octrees are in MemoryUsage::sharedContainers.
+    */
+    MemoryUsage             memoryUsage() const;
+    /*!
+        \brief Adds the memory used by the frozen octree to \a usage
+        \details The containers shared with the structures already added to \a usage are not counted again.
+    */
+    void                    memoryUsage(MemoryUsage& usage) const;
+
+private:
+    /*!
+        \brief Method to find voxel (for floating point arguments)
+    */
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, iterator>::type _findVoxel(T x, T y, T z) const;
+    /*!
+        \brief Method to find voxel (for integer arguments)
+    */
+    iterator                _findVoxel(int x, int y, int z) const;
+    /*!
+        \brief Returns the index of the leaf that contain the voxel, NO_INDEX if there is none
+    */
+    uint32_t                findLeaf(int x, int y, int z) const;
+    /*!
+        \brief Releases the leaf nodes
+    */
+    void                    clearLeafNodes();
+
+    using LeafNodePtr = std::atomic<VoxelNode<T_Container>*>;
+
+    std::vector<Node>                   _nodes;         //!< Nodes in breadth-first order
+    std::vector<Leaf>                   _leaves;        //!< Leaves, in the order of their nodes
+    mutable std::unique_ptr<LeafNodePtr[]> _leafNodes;  //!< Node of each leaf, created by getLeafNode
+    unsigned int                        _nbVoxels = 0;  //!< Number of voxels
+};
+
+}
+
+#include "FrozenVoxelOctree.ipp"
+
+#endif // _VOXOMAP_FROZENVOXELOCTREE_HPP_
@@ -0,0 +1,322 @@
+#include <bitset>
+#include <cmath>
+
+namespace voxomap
+{
+
+template <class T_Container>
+const uint32_t FrozenVoxelOctree<T_Container>::NO_INDEX;
+
+template <class T_Container>
+inline uint32_t FrozenVoxelOctree<T_Container>::Node::getChild(int i) const
+{
+    if (!(childMask >> i & 1))
+        return NO_INDEX;
+    // Children are stored in the order of their id
+    return firstChild + static_cast<uint32_t>(std::bitset<8>(childMask & ((1u << i) - 1)).count());
+}
+
+template <class T_Container>
+inline int FrozenVoxelOctree<T_Container>::Node::getChildPos(int px, int py, int pz) const
+{
+    // Same as Node::getChildPos
+    if (x < 0 && static_cast<uint32_t>(-x) < size)
+        return ((px >> 31) & 1) + (((py >> 31) & 1) << 1) + (((pz >> 31) & 1) << 2);
+    int half = size >> 1;
+    return (px & half) / half + (((py & half) / half) << 1) + (((pz & half) / half) << 2);
+}
+
+template <class T_Container>
+FrozenVoxelOctree<T_Container>::FrozenVoxelOctree(VoxelOctree<T_Container> const& octree)
+{
+    this->freeze(octree);
+}
+
+template <class T_Container>
+FrozenVoxelOctree<T_Container>::FrozenVoxelOctree(FrozenVoxelOctree const& other)
+    : _nodes(other._nodes)
+    , _leaves(other._leaves)
+    , _leafNodes(new LeafNodePtr[other._leaves.size()]())
+    , _nbVoxels(other._nbVoxels)
+{
+}
+
+template <class T_Container>
+FrozenVoxelOctree<T_Container>::~FrozenVoxelOctree()
+{
+    this->clearLeafNodes();
+}
+
+template <class T_Container>
+FrozenVoxelOctree<T_Container>& FrozenVoxelOctree<T_Container>::operator=(FrozenVoxelOctree const& other)
+{
+    if (this != &other)
+    {
+        this->clearLeafNodes();
+        _nodes = other._nodes;
+        _leaves = other._leaves;
+        _leafNodes.reset(new LeafNodePtr[_leaves.size()]());
+        _nbVoxels = other._nbVoxels;
+    }
+    return *this;
+}
+
+template <class T_Container>
+FrozenVoxelOctree<T_Container>& FrozenVoxelOctree<T_Container>::operator=(FrozenVoxelOctree&& other)
+{
+    if (this != &other)
+    {
+        this->clearLeafNodes();
+        _nodes = std::move(other._nodes);
+        _leaves = std::move(other._leaves);
+        _leafNodes = std::move(other._leafNodes);
+        _nbVoxels = other._nbVoxels;
+        other._nodes.clear();
+        other._leaves.clear();
+        other._nbVoxels = 0;
+    }
+    return *this;
+}
+
+template <class T_Container>
+void FrozenVoxelOctree<T_Container>::freeze(VoxelOctree<T_Container> const& octree)
+{
+    this->clearLeafNodes();
+    _nodes.clear();
+    _leaves.clear();
+    _nbVoxels = 0;
+    if (!octree.getRootNode())
+        return;
+
+    // Breadth-first browse, the children of a node are pushed consecutively
+    std::vector<VoxelNode<T_Container> const*> sources;
+    size_t nbLeaves = 0;
+    sources.push_back(octree.getRootNode());
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        if (sources[i]->getVoxelContainer())
+            ++nbLeaves;
+        for (auto child : sources[i]->getChildren())
+        {
+            if (child)
+                sources.push_back(child);
+        }
+    }
+
+    _nodes.resize(sources.size());
+    _leaves.reserve(nbLeaves);
+    _leafNodes.reset(new LeafNodePtr[nbLeaves]());
+    uint32_t nextChild = 1;
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        auto const& source = *sources[i];
+        Node& node = _nodes[i];
+        node.x = source.getX();
+        node.y = source.getY();
+        node.z = source.getZ();
+        node.size = source.getSize();
+
+        auto const& children = source.getChildren();
+        for (int c = 0; c < 8; ++c)
+        {
+            if (children[c])
+                node.childMask |= 1 << c;
+        }
+        if (node.childMask)
+        {
+            node.firstChild = nextChild;
+            nextChild += static_cast<uint32_t>(std::bitset<8>(node.childMask).count());
+        }
+
+        if (source.getVoxelContainer())
+        {
+            node.leaf = static_cast<uint32_t>(_leaves.size());
+            _leaves.emplace_back();
+            Leaf& leaf = _leaves.back();
+            leaf.x = node.x;
+            leaf.y = node.y;
+            leaf.z = node.z;
+            leaf.container = source.getSharedVoxelContainer();
+            _nbVoxels += source.getNbVoxel();
+        }
+    }
+}
+
+template <class T_Container>
+VoxelOctree<T_Container> FrozenVoxelOctree<T_Container>::thaw() const
+{
+    VoxelOctree<T_Container> octree;
+    for (auto const& leaf : _leaves)
+    {
+        auto node = octree.createNode(leaf.x, leaf.y, leaf.z, T_Container::NB_VOXELS);
+        node->setVoxelContainer(leaf.container);
+        octree.push(*node);
+    }
+    return octree;
+}
+
+template <class T_Container>
+template <typename T>
+inline typename T_Container::iterator FrozenVoxelOctree<T_Container>::findVoxel(T x, T y, T z) const
+{
+    return this->_findVoxel(x, y, z);
+}
+
+template <class T_Container>
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, typename T_Container::iterator>::type FrozenVoxelOctree<T_Container>::_findVoxel(T x, T y, T z) const
+{
+    return this->_findVoxel(
+        static_cast<int>(std::floor(x)),
+        static_cast<int>(std::floor(y)),
+        static_cast<int>(std::floor(z))
+    );
+}
+
+template <class T_Container>
+typename T_Container::iterator FrozenVoxelOctree<T_Container>::_findVoxel(int x, int y, int z) const
+{
+    iterator it;
+    it.initPosition(x, y, z);
+
+    uint32_t leaf = this->findLeaf(x, y, z);
+    if (leaf != NO_INDEX)
+        const_cast<VoxelNode<T_Container>&>(this->getLeafNode(leaf)).findVoxel(it);
+    return it;
+}
+
+template <class T_Container>
+VoxelNode<T_Container> const* FrozenVoxelOctree<T_Container>::findVoxelNode(int x, int y, int z) const
+{
+    uint32_t leaf = this->findLeaf(x, y, z);
+    return leaf != NO_INDEX ? &this->getLeafNode(leaf) : nullptr;
+}
+
+template <class T_Container>
+uint32_t FrozenVoxelOctree<T_Container>::findLeaf(int x, int y, int z) const
+{
+    if (_nodes.empty())
+        return NO_INDEX;
+
+    x &= T_Container::COORD_MASK;
+    y &= T_Container::COORD_MASK;
+    z &= T_Container::COORD_MASK;
+
+    Node const* node = &_nodes[0];
+    while (node->size > T_Container::NB_VOXELS)
+    {
+        uint32_t child = node->getChild(node->getChildPos(x, y, z));
+        if (child == NO_INDEX)
+            return NO_INDEX;
+        node = &_nodes[child];
+    }
+    if (node->x == x && node->y == y && node->z == z)
+        return node->leaf;
+    return NO_INDEX;
+}
+
+template <class T_Container>
+template <typename T_Predicate>
+void FrozenVoxelOctree<T_Container>::exploreVoxel(T_Predicate const& predicate) const
+{
+    if (!isValidPredicate(predicate))
+        return;
+    for (uint32_t i = 0; i < _leaves.size(); ++i)
+    {
+        VoxelNode<T_Container> node(_leaves[i].x, _leaves[i].y, _leaves[i].z, T_Container::NB_VOXELS);
+        this->initLeafNode(i, node);
+        node.exploreVoxel(predicate);
+    }
+}
+
+template <class T_Container>
+template <typename T_Predicate>
+void FrozenVoxelOctree<T_Container>::exploreVoxelContainer(T_Predicate const& predicate) const
+{
+    if (!isValidPredicate(predicate))
+        return;
+    for (auto const& leaf : _leaves)
+        leaf.container->exploreVoxelContainer(predicate);
+}
+
+template <class T_Container>
+inline bool FrozenVoxelOctree<T_Container>::empty() const
+{
+    return _nbVoxels == 0;
+}
+
+template <class T_Container>
+inline unsigned int FrozenVoxelOctree<T_Container>::getNbVoxels() const
+{
+    return _nbVoxels;
+}
+
+template <class T_Container>
+inline std::vector<typename FrozenVoxelOctree<T_Container>::Node> const& FrozenVoxelOctree<T_Container>::getNodes() const
+{
+    return _nodes;
+}
+
+template <class T_Container>
+inline typename FrozenVoxelOctree<T_Container>::Leaf const& FrozenVoxelOctree<T_Container>::getLeaf(uint32_t index) const
+{
+    return _leaves[index];
+}
+
+template <class T_Container>
+VoxelNode<T_Container> const& FrozenVoxelOctree<T_Container>::getLeafNode(uint32_t index) const
+{
+    VoxelNode<T_Container>* node = _leafNodes[index].load(std::memory_order_acquire);
+    if (node)
+        return *node;
+
+    // Several threads can create the node, the first one is kept
+    Leaf const& leaf = _leaves[index];
+    VoxelNode<T_Container>* newNode = new VoxelNode<T_Container>(leaf.x, leaf.y, leaf.z, T_Container::NB_VOXELS);
+    newNode->setVoxelContainer(leaf.container);
+    if (_leafNodes[index].compare_exchange_strong(node, newNode, std::memory_order_acq_rel, std::memory_order_acquire))
+        return *newNode;
+    delete newNode;
+    return *node;
+}
+
+template <class T_Container>
+inline void FrozenVoxelOctree<T_Container>::initLeafNode(uint32_t index, VoxelNode<T_Container>& node) const
+{
+    // Aliasing constructor without owner: no reference count to update
+    node.setVoxelContainer(std::shared_ptr<T_Container>(std::shared_ptr<T_Container>(), _leaves[index].container.get()));
+}
+
+template <class T_Container>
+void FrozenVoxelOctree<T_Container>::clearLeafNodes()
+{
+    if (!_leafNodes)
+        return;
+    for (size_t i = 0; i < _leaves.size(); ++i)
+        delete _leafNodes[i].load(std::memory_order_relaxed);
+    _leafNodes.reset();
+}
+
+template <class T_Container>
+MemoryUsage FrozenVoxelOctree<T_Container>::memoryUsage() const
+{
+    MemoryUsage usage;
+    this->memoryUsage(usage);
+    return usage;
+}
+
+template <class T_Container>
+void FrozenVoxelOctree<T_Container>::memoryUsage(MemoryUsage& usage) const
+{
+    usage.nodes += containerMemory(_nodes) + containerMemory(_leaves);
+    for (size_t i = 0; _leafNodes && i < _leaves.size(); ++i)
+    {
+        usage.nodes += sizeof(LeafNodePtr);
+        if (_leafNodes[i].load(std::memory_order_acquire))
+            usage.nodes += sizeof(VoxelNode<T_Container>);
+    }
+    for (auto const& leaf : _leaves)
+        addContainerMemory(leaf.container, usage);
+}
+
+}
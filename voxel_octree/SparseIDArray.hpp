@@ -5,6 +5,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include "../utils/MemoryUsage.hpp"
 
 namespace voxomap
 {
@@ -136,13 +137,48 @@ public:
         \return Number of bytes read inside str
     */
     size_t              unserialize(char const* str, size_t size);
+    /*!
+        \brief Unserialize the data of \a str if it was serialized with serializeUniform
+        \param str String that contains data
+        \param size Size of the string
+        \param data Filled with the data of all the positions
+        \return Number of bytes read inside str, 0 if \a str is not a uniform array
+    */
+    size_t              unserializeUniform(char const* str, size_t size, T& data);
+
+    /*!
+        \brief Serialize a full array where all the positions contain \a data, with only one copy of \a data
+        \param str String use for save the serialization
+        \param data The data of all the positions
+    */
+    void                serializeUniform(std::string& str, T const& data) const;
 
     /*!
         \brief Requests the sparse array to reduce its capacity to fit its size.
     */
     void                shrinkToFit();
+    /*!
+        \brief Fills all the positions with a copy of \a data, the previous data are removed
+    */
+    void                fill(T const& data);
+    /*!
+        \brief Removes all the data and releases all the memory, the id table included
+        \details The array can't be used before a call to fill.
+    */
+    void                release();
+
+    /*!
+        \brief Returns the memory used by the id table and the list of freed ids, in bytes
+    */
+    size_t              getIdTableMemory() const;
+    /*!
+        \brief Returns the memory allocated for the data, in bytes
+    */
+    size_t              getDataMemory() const;
 
 protected:
+    static const uint16_t UNIFORM_DATA = 0xFFFF;   //!< Number of data of a serialized uniform array, see serializeUniform
+
     // Serialization structure, use when there is less than 128 voxels inside area
     struct SerializationData
     {
@@ -165,6 +201,8 @@ protected:
     template <typename T_Old, typename T_New>
     void                reallocIds();
     template <typename Type>
+    void                fillIds();
+    template <typename Type>
     void                changeId(uint16_t oldId, uint16_t newId);
     template <typename Type>
     void reset(Type& data);
@@ -16,6 +16,8 @@ AbstractSparseIDArray<T, T_Size, T_Container>::AbstractSparseIDArray(AbstractSpa
 {
     this->copy(other._data);
     _idFreed = other._idFreed;
+    if (!other._ids)
+        return;
     if (_data.size() <= std::numeric_limits<uint8_t>::max())
     {
         _ids.reset(new uint8_t[T_Size * T_Size * T_Size]);
@@ -188,6 +190,17 @@ void AbstractSparseIDArray<T, T_Size, T_Container>::reallocIds()
     _ids.reset(reinterpret_cast<uint8_t*>(newArray));
 }
 
+template <typename T, uint8_t T_Size, template<class...> class T_Container>
+template <typename Type>
+void AbstractSparseIDArray<T, T_Size, T_Container>::fillIds()
+{
+    Type* ids = reinterpret_cast<Type*>(new uint8_t[T_Size * T_Size * T_Size * sizeof(Type)]);
+
+    for (size_t i = 0; i < T_Size * T_Size * T_Size; ++i)
+        ids[i] = static_cast<Type>(i + 1);
+    _ids.reset(reinterpret_cast<uint8_t*>(ids));
+}
+
 template <typename T, uint8_t T_Size, template<class...> class T_Container>
 template <typename Type>
 void AbstractSparseIDArray<T, T_Size, T_Container>::changeId(uint16_t oldId, uint16_t newId)
@@ -239,7 +252,8 @@ void AbstractSparseIDArray<T, T_Size, T_Container>::copy(T_Container<std::unique
     _data.resize(other.size());
     for (size_t i = 0; i < other.size(); ++i)
     {
-        _data[i].reset(new T_Data(*other[i]));
+        // Removed elements leave a null pointer until their id is reused
+        _data[i].reset(other[i] ? new T_Data(*other[i]) : nullptr);
     }
 }
 
@@ -276,6 +290,20 @@ void AbstractSparseIDArray<T, T_Size, T_Container>::serialize(std::string& str)
     std::memcpy(&str[position], &totalSize, sizeof(totalSize));
 }
 
+template <typename T, uint8_t T_Size, template<class...> class T_Container>
+void AbstractSparseIDArray<T, T_Size, T_Container>::serializeUniform(std::string& str, T const& data) const
+{
+    uint32_t totalSize = 0;
+    uint32_t position = static_cast<uint32_t>(str.size());
+    uint16_t nbData = UNIFORM_DATA;
+
+    str.append(reinterpret_cast<char const*>(&totalSize), sizeof(totalSize));
+    str.append(reinterpret_cast<char const*>(&nbData), sizeof(nbData));
+    this->serializeData(str, data);
+    totalSize = static_cast<uint32_t>(str.size()) - position;
+    std::memcpy(&str[position], &totalSize, sizeof(totalSize));
+}
+
 template <typename T, uint8_t T_Size, template<class...> class T_Container>
 template <typename T_Data>
 inline typename std::enable_if<std::is_trivially_copyable<T_Data>::value>::type
@@ -395,6 +423,22 @@ size_t AbstractSparseIDArray<T, T_Size, T_Container>::unserialize(char const* st
     return tmp - str;
 }
 
+template <typename T, uint8_t T_Size, template<class...> class T_Container>
+size_t AbstractSparseIDArray<T, T_Size, T_Container>::unserializeUniform(char const* str, size_t size, T& data)
+{
+    uint32_t totalSize;
+    uint16_t nbData;
+    if (size < sizeof(totalSize) + sizeof(nbData))
+        return 0;
+    std::memcpy(&totalSize, str, sizeof(totalSize));
+    std::memcpy(&nbData, str + sizeof(totalSize), sizeof(nbData));
+    if (nbData != UNIFORM_DATA || totalSize > size)
+        return 0;
+
+    this->unserializeData(str + sizeof(totalSize) + sizeof(nbData), totalSize - sizeof(totalSize) - sizeof(nbData), data);
+    return totalSize;
+}
+
 template <typename T, uint8_t T_Size, template<class...> class T_Container>
 template <typename T_Data>
 inline typename std::enable_if<std::is_trivially_copyable<T_Data>::value, size_t>::type
@@ -509,6 +553,39 @@ void AbstractSparseIDArray<T, T_Size, T_Container>::shrinkToFit()
     _idFreed.clear();
 }
 
+template <typename T, uint8_t T_Size, template<class...> class T_Container>
+void AbstractSparseIDArray<T, T_Size, T_Container>::fill(T const& data)
+{
+    _idFreed.clear();
+    _data.assign(T_Size * T_Size * T_Size, data);
+    if (_data.size() <= std::numeric_limits<uint8_t>::max())
+        this->fillIds<uint8_t>();
+    else
+        this->fillIds<uint16_t>();
+}
+
+template <typename T, uint8_t T_Size, template<class...> class T_Container>
+void AbstractSparseIDArray<T, T_Size, T_Container>::release()
+{
+    T_Container<T>().swap(_data);
+    T_Container<uint16_t>().swap(_idFreed);
+    _ids.reset();
+}
+
+template <typename T, uint8_t T_Size, template<class...> class T_Container>
+size_t AbstractSparseIDArray<T, T_Size, T_Container>::getIdTableMemory() const
+{
+    // Ids are stored on uint16_t when there is more than 255 data, see getNewId
+    size_t idSize = (_data.size() <= std::numeric_limits<uint8_t>::max()) ? sizeof(uint8_t) : sizeof(uint16_t);
+    return T_Size * T_Size * T_Size * idSize + containerMemory(_idFreed);
+}
+
+template <typename T, uint8_t T_Size, template<class...> class T_Container>
+size_t AbstractSparseIDArray<T, T_Size, T_Container>::getDataMemory() const
+{
+    return containerMemory(_data);
+}
+
 
 template <typename T, uint8_t T_Size, template<class...> class T_Container>
 AbstractSparseIDArray<T, T_Size, T_Container>::SerializationData::SerializationData(uint16_t position, uint16_t id)
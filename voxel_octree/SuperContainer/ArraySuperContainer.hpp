@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include "../iterator.hpp"
+#include "../../utils/MemoryUsage.hpp"
 
 namespace voxomap
 {
@@ -41,6 +42,7 @@ struct ArraySuperContainer
     const static uint32_t VOXEL_MASK = Container::VOXEL_MASK;
     const static uint32_t NB_SUPERCONTAINER = 1 + Container::NB_SUPERCONTAINER;
     const static uint32_t SUPERCONTAINER_ID = NB_SUPERCONTAINER - 1;
+    const static bool MAPPABLE = false;
 
     /*!
         \brief Default constructor
@@ -169,12 +171,21 @@ struct ArraySuperContainer
     /*!
         \brief Go through all voxels of the container and call the \a predicate for each
         \param it Begin iterator
-        \param predicate Function called for each voxel found
+        \param predicate Function called for each voxel found: void(Iterator const&)
     */
-    template <typename Iterator>
-    void                exploreVoxel(Iterator& it, std::function<void(Iterator const&)> const& predicate) const;
+    template <typename Iterator, typename T_Predicate>
+    void                exploreVoxel(Iterator& it, T_Predicate const& predicate) const;
+    /*!
+        \brief Go through all voxel containers and call the \a predicate for each
+        \param predicate Function called for each voxel container: void(VoxelContainer const&)
+    */
+    template <typename T_Predicate>
+    void                exploreVoxelContainer(T_Predicate const& predicate) const;
 
-    void                exploreVoxelContainer(std::function<void(typename Container::VoxelContainer const&)> const& predicate) const;
+    /*!
+        \brief Adds the memory used by the container to \a usage
+    */
+    void                memoryUsage(MemoryUsage& usage) const;
 
 private:
     std::unique_ptr<Container> _containerArray[NB_CONTAINERS][NB_CONTAINERS][NB_CONTAINERS] = { 0 };  //!< Array of voxel containers
@@ -233,8 +233,8 @@ size_t ArraySuperContainer<Container>::unserialize(char const* str, size_t size)
 }
 
 template <class Container>
-template <typename Iterator>
-void ArraySuperContainer<Container>::exploreVoxel(Iterator& it, std::function<void(Iterator const&)> const& predicate) const
+template <typename Iterator, typename T_Predicate>
+void ArraySuperContainer<Container>::exploreVoxel(Iterator& it, T_Predicate const& predicate) const
 {
     uint8_t& sx = it.containerPosition[SUPERCONTAINER_ID].x;
     uint8_t& sy = it.containerPosition[SUPERCONTAINER_ID].y;
@@ -260,7 +260,8 @@ void ArraySuperContainer<Container>::exploreVoxel(Iterator& it, std::function<vo
 }
 
 template <class Container>
-void ArraySuperContainer<Container>::exploreVoxelContainer(std::function<void(typename Container::VoxelContainer const&)> const& predicate) const
+template <typename T_Predicate>
+void ArraySuperContainer<Container>::exploreVoxelContainer(T_Predicate const& predicate) const
 {
     for (uint8_t sx = 0; sx < NB_CONTAINERS; ++sx)
     {
@@ -281,4 +282,21 @@ void ArraySuperContainer<Container>::exploreVoxelContainer(std::function<void(ty
     }
 }
 
+template <class Container>
+void ArraySuperContainer<Container>::memoryUsage(MemoryUsage& usage) const
+{
+    usage.superContainers += sizeof(*this);
+    for (uint8_t sx = 0; sx < NB_CONTAINERS; ++sx)
+    {
+        for (uint8_t sy = 0; sy < NB_CONTAINERS; ++sy)
+        {
+            for (uint8_t sz = 0; sz < NB_CONTAINERS; ++sz)
+            {
+                if (_containerArray[sx][sy][sz])
+                    _containerArray[sx][sy][sz]->memoryUsage(usage);
+            }
+        }
+    }
+}
+
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <vector>
 #include <functional>
 #include "../iterator.hpp"
+#include "../../utils/MemoryUsage.hpp"
 #include "../SparseIDArray.hpp"
 
 namespace voxomap
@@ -52,6 +53,7 @@ struct SparseSuperContainer
     const static uint32_t VOXEL_MASK = Container::VOXEL_MASK;
     const static uint32_t NB_SUPERCONTAINER = 1 + Container::NB_SUPERCONTAINER;
     const static uint32_t SUPERCONTAINER_ID = NB_SUPERCONTAINER - 1;
+    const static bool MAPPABLE = false;
 
     /*!
         \brief Default constructor
@@ -180,12 +182,21 @@ struct SparseSuperContainer
     /*!
         \brief Go through all voxels of the container and call the \a predicate for each
         \param it Begin iterator
-        \param predicate Function called for each voxel found
+        \param predicate Function called for each voxel found: void(Iterator const&)
     */
-    template <typename Iterator>
-    void                exploreVoxel(Iterator& it, std::function<void(Iterator const&)> const& predicate) const;
+    template <typename Iterator, typename T_Predicate>
+    void                exploreVoxel(Iterator& it, T_Predicate const& predicate) const;
+    /*!
+        \brief Go through all voxel containers and call the \a predicate for each
+        \param predicate Function called for each voxel container: void(VoxelContainer const&)
+    */
+    template <typename T_Predicate>
+    void                exploreVoxelContainer(T_Predicate const& predicate) const;
 
-    void                exploreVoxelContainer(std::function<void(typename T_Container::VoxelContainer const&)> const& predicate) const;
+    /*!
+        \brief Adds the memory used by the container to \a usage
+    */
+    void                memoryUsage(MemoryUsage& usage) const;
 
 private:
     SparseIDArray<std::unique_ptr<Container>, NB_CONTAINERS, T_InternalContainer> _sparseArray;
@@ -163,8 +163,8 @@ size_t SparseSuperContainer<Container, InternalContainer>::unserialize(char cons
 }
 
 template <class Container, template <class...> class InternalContainer>
-template <typename Iterator>
-void SparseSuperContainer<Container, InternalContainer>::exploreVoxel(Iterator& it, std::function<void(Iterator const&)> const& predicate) const
+template <typename Iterator, typename T_Predicate>
+void SparseSuperContainer<Container, InternalContainer>::exploreVoxel(Iterator& it, T_Predicate const& predicate) const
 {
     uint8_t& sx = it.containerPosition[SUPERCONTAINER_ID].x;
     uint8_t& sy = it.containerPosition[SUPERCONTAINER_ID].y;
@@ -192,7 +192,8 @@ void SparseSuperContainer<Container, InternalContainer>::exploreVoxel(Iterator&
 }
 
 template <class Container, template <class...> class InternalContainer>
-void SparseSuperContainer<Container, InternalContainer>::exploreVoxelContainer(std::function<void(typename Container::VoxelContainer const&)> const& predicate) const
+template <typename T_Predicate>
+void SparseSuperContainer<Container, InternalContainer>::exploreVoxelContainer(T_Predicate const& predicate) const
 {
 	for (uint8_t sx = 0; sx < NB_CONTAINERS; ++sx)
 	{
@@ -216,4 +217,23 @@ void SparseSuperContainer<Container, InternalContainer>::exploreVoxelContainer(s
 	}
 }
 
+template <class Container, template <class...> class InternalContainer>
+void SparseSuperContainer<Container, InternalContainer>::memoryUsage(MemoryUsage& usage) const
+{
+	usage.superContainers += sizeof(*this) + _sparseArray.getDataMemory();
+	usage.idTables += _sparseArray.getIdTableMemory();
+	for (uint8_t sx = 0; sx < NB_CONTAINERS; ++sx)
+	{
+		for (uint8_t sy = 0; sy < NB_CONTAINERS; ++sy)
+		{
+			for (uint8_t sz = 0; sz < NB_CONTAINERS; ++sz)
+			{
+				auto container = _sparseArray.findData(sx, sy, sz);
+				if (container)
+					container->memoryUsage(usage);
+			}
+		}
+	}
+}
+
 }
\ No newline at end of file
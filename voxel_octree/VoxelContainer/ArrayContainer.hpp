@@ -3,6 +3,9 @@
 
 #include <cstdint>
 #include "../iterator.hpp"
+#include "OccupancyMask.hpp"
+#include "../../utils/MemoryUsage.hpp"
+#include "../../utils/MemoryPool.hpp"
 
 namespace voxomap
 {
@@ -37,6 +40,7 @@ struct ArrayContainer
     const static uint32_t COORD_MASK = ~(NB_VOXELS - 1);
     const static uint32_t VOXEL_MASK = NB_VOXELS - 1;
     const static uint32_t NB_SUPERCONTAINER = 0;
+    const static bool MAPPABLE = true;     //!< Usable in place from a mapped file, see VoxelOctree::unserializeMapped
 
     /*!
         \brief Default constructor
@@ -51,6 +55,15 @@ struct ArrayContainer
     */
     ArrayContainer(ArrayContainer&& other) = default;
 
+    /*!
+        \brief Allocates the container inside a MemoryPool
+    */
+    static void*        operator new(size_t size);
+    /*!
+        \brief Releases a container allocated with operator new
+    */
+    static void         operator delete(void* ptr, size_t size);
+
     /*!
         \brief Initialization method, do nothing
     */
@@ -59,6 +72,10 @@ struct ArrayContainer
         \brief Returns number of voxels
     */
     uint16_t            getNbVoxel() const;
+    /*!
+        \brief Returns the occupancy mask, one bit per existing voxel
+    */
+    OccupancyMask const& getOccupancy() const;
     /*!
         \brief Check if there is voxel inside
         \param x X index
@@ -146,15 +163,29 @@ struct ArrayContainer
     /*!
         \brief Go through all voxels of the container and call the \a predicate for each
         \param it Begin iterator
-        \param predicate Function called for each voxel found
+        \param predicate Function called for each voxel found: void(Iterator const&)
     */
-    template <typename Iterator>
-    void                exploreVoxel(Iterator& it, std::function<void(Iterator const&)> const& predicate) const;
+    template <typename Iterator, typename T_Predicate>
+    void                exploreVoxel(Iterator& it, T_Predicate const& predicate) const;
+    /*!
+        \brief Call the \a predicate on the container
+        \param predicate Function called with the container: void(ArrayContainer const&)
+    */
+    template <typename T_Predicate>
+    void                exploreVoxelContainer(T_Predicate const& predicate) const;
+
+    /*!
+        \brief Adds the memory used by the container to \a usage
+    */
+    void                memoryUsage(MemoryUsage& usage) const;
 
-    void                exploreVoxelContainer(std::function<void(ArrayContainer const&)> const& predicate) const;
+    /*!
+        \brief Returns true if the container is full of one identical voxel
+    */
+    bool                isUniform() const;
 
     /*!
-        \brief Serialize the structure
+        \brief Serialize the structure, a container full of one identical voxel is serialized with only one voxel
         \param str String use for save the serialization
     */
     void                serialize(std::string& str) const;
@@ -168,6 +199,7 @@ struct ArrayContainer
 
 
 public:
+    OccupancyMask occupancy;    //!< One bit per existing voxel
     uint16_t nbVoxels = 0;   //!< Number of voxels
     union {
         VoxelData area[NB_VOXELS][NB_VOXELS][NB_VOXELS];  //!< Array of voxels
@@ -186,6 +218,8 @@ private:
     template <typename T>
     typename std::enable_if<!std::is_trivially_constructible<T>::value>::type copy(T const& other);
 
+    static const uint16_t UNIFORM_FLAG = 0x8000;  //!< Set on the serialized number of voxels of a uniform container
+
     /*!
         Used for initialize ArrayContainer::area attribute without call constructor on each VoxelData of array
     */
@@ -4,6 +4,26 @@ namespace voxomap
 template <class T_Voxel>
 const typename ArrayContainer<T_Voxel>::VoxelData ArrayContainer<T_Voxel>::_emptyArea[NB_VOXELS][NB_VOXELS][NB_VOXELS];
 
+template <class T_Voxel>
+const uint16_t ArrayContainer<T_Voxel>::UNIFORM_FLAG;
+
+template <class T_Voxel>
+void* ArrayContainer<T_Voxel>::operator new(size_t size)
+{
+    if (size != sizeof(ArrayContainer<T_Voxel>))
+        return ::operator new(size);
+    return MemoryPool<sizeof(ArrayContainer<T_Voxel>)>::get().allocate();
+}
+
+template <class T_Voxel>
+void ArrayContainer<T_Voxel>::operator delete(void* ptr, size_t size)
+{
+    if (size != sizeof(ArrayContainer<T_Voxel>))
+        ::operator delete(ptr);
+    else
+        MemoryPool<sizeof(ArrayContainer<T_Voxel>)>::deallocate(ptr);
+}
+
 template <class T_Voxel>
 inline ArrayContainer<T_Voxel>::ArrayContainer()
 {
@@ -12,6 +32,8 @@ inline ArrayContainer<T_Voxel>::ArrayContainer()
 
 template <class T_Voxel>
 inline ArrayContainer<T_Voxel>::ArrayContainer(ArrayContainer const& other)
+    : occupancy(other.occupancy)
+    , nbVoxels(other.nbVoxels)
 {
     this->copy(other);
 }
@@ -23,21 +45,27 @@ inline uint16_t ArrayContainer<T_Voxel>::getNbVoxel() const
 }
 
 template <class T_Voxel>
-bool ArrayContainer<T_Voxel>::hasVoxel(uint8_t x) const
+inline OccupancyMask const& ArrayContainer<T_Voxel>::getOccupancy() const
 {
-    return std::memcmp(&this->area[x], _emptyArea, NB_VOXELS * NB_VOXELS * sizeof(T_Voxel)) != 0;
+    return occupancy;
 }
 
 template <class T_Voxel>
-bool ArrayContainer<T_Voxel>::hasVoxel(uint8_t x, uint8_t y) const
+inline bool ArrayContainer<T_Voxel>::hasVoxel(uint8_t x) const
 {
-    return std::memcmp(&this->area[x][y], _emptyArea, NB_VOXELS * sizeof(T_Voxel)) != 0;
+    return occupancy.test(x);
 }
 
 template <class T_Voxel>
-bool ArrayContainer<T_Voxel>::hasVoxel(uint8_t x, uint8_t y, uint8_t z) const
+inline bool ArrayContainer<T_Voxel>::hasVoxel(uint8_t x, uint8_t y) const
 {
-    return std::memcmp(&this->area[x][y][z], _emptyArea, sizeof(T_Voxel)) != 0;
+    return occupancy.test(x, y);
+}
+
+template <class T_Voxel>
+inline bool ArrayContainer<T_Voxel>::hasVoxel(uint8_t x, uint8_t y, uint8_t z) const
+{
+    return occupancy.test(x, y, z);
 }
 
 template <class T_Voxel>
@@ -78,6 +106,7 @@ bool ArrayContainer<T_Voxel>::addVoxel(Iterator& it, Args&&... args)
 
     it.voxel = &this->area[it.x][it.y][it.z];
     new (it.voxel) VoxelData(std::forward<Args>(args)...);
+    occupancy.set(it.x, it.y, it.z);
     ++nbVoxels;
     return true;
 }
@@ -86,6 +115,7 @@ template <class T_Voxel>
 template <typename Iterator, typename... Args>
 bool ArrayContainer<T_Voxel>::updateVoxel(Iterator& it, Args&&... args)
 {
+    it.voxelContainer = static_cast<decltype(it.voxelContainer)>(this);
     it.voxel = this->findVoxel(it.x, it.y, it.z);
     if (!it.voxel)
         return false;
@@ -114,61 +144,83 @@ bool ArrayContainer<T_Voxel>::removeVoxel(Iterator const& it, VoxelData* return_
     if (return_voxel)
         *return_voxel = *voxel;
     --nbVoxels;
+    occupancy.reset(it.x, it.y, it.z);
     new (voxel) VoxelData();
     return true;
 }
 
 template <class T_Voxel>
-template <typename Iterator>
-void ArrayContainer<T_Voxel>::exploreVoxel(Iterator& it, std::function<void(Iterator const&)> const& predicate) const
+template <typename Iterator, typename T_Predicate>
+void ArrayContainer<T_Voxel>::exploreVoxel(Iterator& it, T_Predicate const& predicate) const
 {
-    for (it.x = 0; it.x < NB_VOXELS; ++it.x)
+    for (uint16_t id = occupancy.findNext(0); id < OccupancyMask::NB_BITS; id = occupancy.findNext(id + 1))
     {
-        if (!this->hasVoxel(it.x))
-            continue;
-
-        for (it.y = 0; it.y < NB_VOXELS; ++it.y)
-        {
-            if (!this->hasVoxel(it.x, it.y))
-                continue;
-
-            for (it.z = 0; it.z < NB_VOXELS; ++it.z)
-            {
-                it.voxel = const_cast<T_Voxel*>(this->findVoxel(it.x, it.y, it.z));
-                if (it.voxel)
-                    predicate(it);
-            }
-        }
+        it.x = static_cast<uint8_t>(id >> 6);
+        it.y = static_cast<uint8_t>(id >> 3 & 7);
+        it.z = static_cast<uint8_t>(id & 7);
+        it.voxel = const_cast<T_Voxel*>(&this->area[it.x][it.y][it.z]);
+        predicate(it);
     }
 }
 
 template <class T_Voxel>
-void ArrayContainer<T_Voxel>::exploreVoxelContainer(std::function<void(ArrayContainer const&)> const& predicate) const
+template <typename T_Predicate>
+void ArrayContainer<T_Voxel>::exploreVoxelContainer(T_Predicate const& predicate) const
 {
     predicate(*this);
 }
 
+template <class T_Voxel>
+void ArrayContainer<T_Voxel>::memoryUsage(MemoryUsage& usage) const
+{
+    usage.voxelContainers += sizeof(*this);
+}
+
+
+template <class T_Voxel>
+bool ArrayContainer<T_Voxel>::isUniform() const
+{
+    if (nbVoxels != NB_VOXELS * NB_VOXELS * NB_VOXELS)
+        return false;
+
+    T_Voxel const* voxels = reinterpret_cast<T_Voxel const*>(this->area);
+    for (uint16_t id = 1; id < NB_VOXELS * NB_VOXELS * NB_VOXELS; ++id)
+    {
+        if (std::memcmp(&voxels[id], voxels, sizeof(T_Voxel)) != 0)
+            return false;
+    }
+    return true;
+}
 
 template <class T_Voxel>
 void ArrayContainer<T_Voxel>::serialize(std::string& str) const
 {
+    if (this->isUniform())
+    {
+        uint16_t flags = nbVoxels | UNIFORM_FLAG;
+        str.append(reinterpret_cast<char const*>(&flags), sizeof(flags));
+        str.append(reinterpret_cast<char const*>(this->area), sizeof(T_Voxel));
+        return;
+    }
+
     str.append(reinterpret_cast<char const*>(&nbVoxels), sizeof(nbVoxels));
 
     if (nbVoxels * (sizeof(T_Voxel) + sizeof(uint16_t)) < sizeof(this->area))
     {
         T_Voxel const* voxels = reinterpret_cast<T_Voxel const*>(this->area);
         str.reserve(str.size() + nbVoxels * (sizeof(T_Voxel) + sizeof(uint16_t)));
-        for (uint16_t id = 0; id < NB_VOXELS * NB_VOXELS * NB_VOXELS; ++id)
+        for (uint16_t id = occupancy.findNext(0); id < OccupancyMask::NB_BITS; id = occupancy.findNext(id + 1))
         {
-            if (std::memcmp(&voxels[id], _emptyArea, sizeof(T_Voxel)) == 0)
-                continue;
-
             str.append(reinterpret_cast<char const*>(&id), sizeof(id));
             str.append(reinterpret_cast<char const*>(&voxels[id]), sizeof(T_Voxel));
         }
     }
     else
+    {
+        // The mask is stored with the array, a voxel can have the same bytes as an empty one
         str.append(reinterpret_cast<char const*>(this->area), sizeof(this->area));
+        str.append(reinterpret_cast<char const*>(&occupancy), sizeof(occupancy));
+    }
 }
 
 template <class T_Voxel>
@@ -180,22 +232,46 @@ size_t ArrayContainer<T_Voxel>::unserialize(char const* str, size_t size)
     std::memcpy(&nbVoxels, str, sizeof(nbVoxels));
     uSize += sizeof(nbVoxels);
 
+    if (nbVoxels & UNIFORM_FLAG)
+    {
+        nbVoxels &= ~UNIFORM_FLAG;
+        if (size < uSize + sizeof(T_Voxel))
+            return 0;
+        T_Voxel* voxels = reinterpret_cast<T_Voxel*>(this->area);
+        for (uint16_t id = 0; id < NB_VOXELS * NB_VOXELS * NB_VOXELS; ++id)
+            std::memcpy(&voxels[id], &str[uSize], sizeof(T_Voxel));
+        occupancy.fill();
+        return uSize + sizeof(T_Voxel);
+    }
+
+    occupancy.clear();
     if (nbVoxels * (sizeof(T_Voxel) + sizeof(uint16_t)) < sizeof(this->area))
     {
+        if (size < uSize + nbVoxels * (sizeof(T_Voxel) + sizeof(uint16_t)))
+            return 0;
         uint16_t id;
         T_Voxel* voxels = reinterpret_cast<T_Voxel*>(this->area);
         for (uint16_t i = 0; i < nbVoxels; ++i)
         {
             std::memcpy(&id, &str[uSize], sizeof(id));
             uSize += sizeof(id);
+            if (id >= OccupancyMask::NB_BITS)
+                return 0;
             std::memcpy(&voxels[id], &str[uSize], sizeof(T_Voxel));
             uSize += sizeof(T_Voxel);
+            occupancy.set(static_cast<uint8_t>(id >> 6), static_cast<uint8_t>(id >> 3 & 7), static_cast<uint8_t>(id & 7));
         }
     }
     else
     {
+        if (size < uSize + sizeof(this->area) + sizeof(occupancy))
+            return 0;
         std::memcpy(this->area, &str[uSize], sizeof(this->area));
         uSize += sizeof(this->area);
+        std::memcpy(&occupancy, &str[uSize], sizeof(occupancy));
+        uSize += sizeof(occupancy);
+        if (occupancy.count() != nbVoxels)
+            return 0;
     }
     return uSize;
 }
@@ -0,0 +1,92 @@
+#ifndef _VOXOMAP_OCCUPANCYMASK_HPP_
+#define _VOXOMAP_OCCUPANCYMASK_HPP_
+
+#include <cstdint>
+#include <cstring>
+
+namespace voxomap
+{
+
+/*!
+    \ingroup Utility
+    \brief Returns the number of bits set in \a value
+*/
+inline uint8_t popCount(uint64_t value);
+/*!
+    \ingroup Utility
+    \brief Returns the number of zero bits after the lowest bit set of \a value, \a value must not be 0
+*/
+inline uint8_t countTrailingZeros(uint64_t value);
+
+/*! \class OccupancyMask
+    \ingroup VoxelContainer
+    \brief One bit per voxel of a voxel container, set when the voxel exists.
+    The bit of the voxel (x, y, z) is the bit y * 8 + z of the word x, so a word is a YZ slice
+    and a byte of a word is a Z row. Presence checks, counts and search of the next voxel are bit operations.
+*/
+class OccupancyMask
+{
+public:
+    const static uint32_t NB_VOXELS = 8;
+    const static uint16_t NB_BITS = NB_VOXELS * NB_VOXELS * NB_VOXELS;
+
+    /*!
+        \brief Returns the index of the bit of the voxel (x, y, z)
+    */
+    static uint16_t     getIndex(uint8_t x, uint8_t y, uint8_t z);
+
+    /*!
+        \brief Check if there is a bit set in the slice \a x
+    */
+    bool                test(uint8_t x) const;
+    /*!
+        \brief Check if there is a bit set in the row (\a x, \a y)
+    */
+    bool                test(uint8_t x, uint8_t y) const;
+    /*!
+        \brief Check if the bit of the voxel (x, y, z) is set
+    */
+    bool                test(uint8_t x, uint8_t y, uint8_t z) const;
+    /*!
+        \brief Check if there is a bit set inside a box
+        \param x X index of the box corner
+        \param y Y index of the box corner
+        \param z Z index of the box corner
+        \param size Size of the box, the box must be inside the mask
+    */
+    bool                testBox(uint8_t x, uint8_t y, uint8_t z, uint8_t size) const;
+    /*!
+        \brief Returns the number of bits set
+    */
+    uint16_t            count() const;
+    /*!
+        \brief Returns the index of the first bit set from \a index (included), NB_BITS if there is none
+    */
+    uint16_t            findNext(uint16_t index) const;
+
+    /*!
+        \brief Set the bit of the voxel (x, y, z)
+    */
+    void                set(uint8_t x, uint8_t y, uint8_t z);
+    /*!
+        \brief Unset the bit of the voxel (x, y, z)
+    */
+    void                reset(uint8_t x, uint8_t y, uint8_t z);
+    /*!
+        \brief Set all the bits
+    */
+    void                fill();
+    /*!
+        \brief Unset all the bits
+    */
+    void                clear();
+
+private:
+    uint64_t _words[NB_VOXELS] = {};    //!< One word per X slice
+};
+
+}
+
+#include "OccupancyMask.ipp"
+
+#endif // _VOXOMAP_OCCUPANCYMASK_HPP_
@@ -0,0 +1,112 @@
+#if defined(_MSC_VER) && defined(_M_X64)
+# include <intrin.h>
+#endif
+
+namespace voxomap
+{
+
+inline uint8_t popCount(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint8_t>(__builtin_popcountll(value));
+#else
+    value = value - ((value >> 1) & 0x5555555555555555ull);
+    value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<uint8_t>((value * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+inline uint8_t countTrailingZeros(uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint8_t>(__builtin_ctzll(value));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<uint8_t>(index);
+#else
+    return popCount((value & (~value + 1)) - 1);
+#endif
+}
+
+inline uint16_t OccupancyMask::getIndex(uint8_t x, uint8_t y, uint8_t z)
+{
+    return static_cast<uint16_t>((x * NB_VOXELS + y) * NB_VOXELS + z);
+}
+
+inline bool OccupancyMask::test(uint8_t x) const
+{
+    return _words[x] != 0;
+}
+
+inline bool OccupancyMask::test(uint8_t x, uint8_t y) const
+{
+    return (_words[x] >> (y * NB_VOXELS) & 0xFF) != 0;
+}
+
+inline bool OccupancyMask::test(uint8_t x, uint8_t y, uint8_t z) const
+{
+    return (_words[x] >> (y * NB_VOXELS + z) & 1) != 0;
+}
+
+inline bool OccupancyMask::testBox(uint8_t x, uint8_t y, uint8_t z, uint8_t size) const
+{
+    uint64_t row = ((uint64_t(1) << size) - 1) << z;
+    uint64_t box = 0;
+    for (uint8_t i = 0; i < size; ++i)
+        box |= row << ((y + i) * NB_VOXELS);
+
+    for (uint8_t i = 0; i < size; ++i)
+    {
+        if (_words[x + i] & box)
+            return true;
+    }
+    return false;
+}
+
+inline uint16_t OccupancyMask::count() const
+{
+    uint16_t nb = 0;
+    for (uint64_t word : _words)
+        nb += popCount(word);
+    return nb;
+}
+
+inline uint16_t OccupancyMask::findNext(uint16_t index) const
+{
+    if (index >= NB_BITS)
+        return NB_BITS;
+
+    uint8_t i = static_cast<uint8_t>(index >> 6);
+    uint64_t word = _words[i] & (~uint64_t(0) << (index & 63));
+    while (!word)
+    {
+        if (++i == NB_VOXELS)
+            return NB_BITS;
+        word = _words[i];
+    }
+    return static_cast<uint16_t>(i * 64 + countTrailingZeros(word));
+}
+
+inline void OccupancyMask::set(uint8_t x, uint8_t y, uint8_t z)
+{
+    _words[x] |= uint64_t(1) << (y * NB_VOXELS + z);
+}
+
+inline void OccupancyMask::reset(uint8_t x, uint8_t y, uint8_t z)
+{
+    _words[x] &= ~(uint64_t(1) << (y * NB_VOXELS + z));
+}
+
+inline void OccupancyMask::fill()
+{
+    std::memset(_words, 0xFF, sizeof(_words));
+}
+
+inline void OccupancyMask::clear()
+{
+    std::memset(_words, 0, sizeof(_words));
+}
+
+}
@@ -0,0 +1,254 @@
+#ifndef _VOXOMAP_PALETTECONTAINER_HPP_
+#define _VOXOMAP_PALETTECONTAINER_HPP_
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../iterator.hpp"
+#include "OccupancyMask.hpp"
+#include "../../utils/MemoryUsage.hpp"
+#include "../../utils/MemoryPool.hpp"
+
+namespace voxomap
+{
+
+template <class T_Container> class VoxelNode;
+
+/*! \class PaletteContainer
+    \ingroup VoxelContainer
+    \brief Voxel container used in leaves of the VoxelOctree.
+    Stores each different voxel once in a palette, and for each position the index of its voxel in the palette.
+    The indices use 1, 2, 4, 8 or 16 bits, depending on the size of the palette.
+    Useful when there are few different voxels.
+    - Advantages:
+        - Very small memory footprint with few different voxels, whatever the density
+    - Disadvantages:
+        - Slower access/update than the ArrayContainer
+        - Voxels with the same value share the same memory: a voxel must be modified with
+        updateVoxel or putVoxel, not through the pointer returned by findVoxel
+
+    The index 0 means there is no voxel, and the voxels are compared by their bytes.
+*/
+template <class T_Voxel>
+class PaletteContainer
+{
+    static_assert(std::is_trivially_copyable<T_Voxel>::value, "PaletteContainer only accept trivially copyable object");
+
+public:
+    using VoxelData = T_Voxel;
+    using VoxelContainer = PaletteContainer<T_Voxel>;
+    using iterator = container_iterator<PaletteContainer<T_Voxel>>;
+
+    const static uint32_t NB_VOXELS = 8;
+    const static uint32_t COORD_MASK = ~(NB_VOXELS - 1);
+    const static uint32_t VOXEL_MASK = NB_VOXELS - 1;
+    const static uint32_t NB_SUPERCONTAINER = 0;
+    const static bool MAPPABLE = false;
+
+    /*!
+        \brief Default constructor
+    */
+    PaletteContainer() = default;
+    /*!
+        \brief Default copy constructor
+    */
+    PaletteContainer(PaletteContainer const& other) = default;
+    /*!
+        \brief Default move constructor
+    */
+    PaletteContainer(PaletteContainer&& other) = default;
+
+    /*!
+        \brief Allocates the container inside a MemoryPool
+    */
+    static void*        operator new(size_t size);
+    /*!
+        \brief Releases a container allocated with operator new
+    */
+    static void         operator delete(void* ptr, size_t size);
+
+    /*!
+        \brief Initialization method, do nothing
+    */
+    void                init(VoxelNode<VoxelContainer> const&) {}
+    /*!
+        \brief Returns number of voxels
+    */
+    uint16_t            getNbVoxel() const;
+    /*!
+        \brief Returns the occupancy mask, one bit per existing voxel
+    */
+    OccupancyMask const& getOccupancy() const;
+    /*!
+        \brief Returns the number of bits of an index, 0 if there was never a voxel
+    */
+    uint8_t             getIndexBits() const;
+    /*!
+        \brief Returns the number of different voxels
+    */
+    uint16_t            getPaletteSize() const;
+
+    /*!
+        \brief Check if there is voxel inside
+        \param x X index
+        \return True if there is a voxel
+    */
+    bool                hasVoxel(uint8_t x) const;
+    /*!
+        \brief Check if there is voxel inside
+        \param x X index
+        \param y Y index
+        \return True if there is a voxel
+    */
+    bool                hasVoxel(uint8_t x, uint8_t y) const;
+    /*!
+        \brief Check if voxel exist
+        \param x X index
+        \param y Y index
+        \param z Z index
+        \return True if voxel exist
+    */
+    bool                hasVoxel(uint8_t x, uint8_t y, uint8_t z) const;
+
+    /*!
+        \brief Find voxel
+        \details The voxel is shared with the positions that have the same voxel, don't modify it.
+        \param x X index
+        \param y Y index
+        \param z Z index
+        \return The voxel if exists, otherwise nullptr
+    */
+    VoxelData*          findVoxel(uint8_t x, uint8_t y, uint8_t z);
+    /*!
+        \brief Find voxel
+        \param x X index
+        \param y Y index
+        \param z Z index
+        \return The voxel if exists, otherwise nullptr
+    */
+    VoxelData const*    findVoxel(uint8_t x, uint8_t y, uint8_t z) const;
+    /*!
+        \brief Find voxel
+        \param it The iterator
+        \return The voxel if exists, otherwise nullptr
+    */
+    template <typename Iterator>
+    VoxelData*          findVoxel(Iterator& it);
+    /*!
+        \brief Find voxel
+        \param it The iterator
+        \return The voxel if exists, otherwise nullptr
+    */
+    template <typename Iterator>
+    VoxelData const*    findVoxel(Iterator& it) const;
+
+    /*!
+        \brief Add a voxel, don't update an existing voxel
+        \param it Iterator that contains the informations
+        \param args Arguments to forward to voxel constructor
+        \return True if success and update \a it
+    */
+    template <typename Iterator, typename... Args>
+    bool                addVoxel(Iterator& it, Args&&... args);
+    /*!
+        \brief Update an existing voxel, don't create a new one
+        \param it Iterator that contains the informations
+        \param args Arguments to forward to voxel constructor
+        \return True if success
+    */
+    template <typename Iterator, typename... Args>
+    bool                updateVoxel(Iterator& it, Args&&... args);
+    /*!
+        \brief Add or update a voxel
+        \param it Iterator that contains the informations
+        \param args Arguments to forward to voxel constructor
+    */
+    template <typename Iterator, typename... Args>
+    void                putVoxel(Iterator& it, Args&&... args);
+    /*!
+        \brief Remove an existing voxel
+        \param it Iterator that contains the informations
+        \param voxel Pointer on a voxel structure, filled with the data of the removed voxel
+        \return True if success
+    */
+    template <typename Iterator>
+    bool                removeVoxel(Iterator const& it, VoxelData* voxel = nullptr);
+
+    /*!
+        \brief Go through all voxels of the container and call the \a predicate for each
+        \param it Begin iterator
+        \param predicate Function called for each voxel found: void(Iterator const&)
+    */
+    template <typename Iterator, typename T_Predicate>
+    void                exploreVoxel(Iterator& it, T_Predicate const& predicate) const;
+    /*!
+        \brief Call the \a predicate on the container
+        \param predicate Function called with the container: void(PaletteContainer const&)
+    */
+    template <typename T_Predicate>
+    void                exploreVoxelContainer(T_Predicate const& predicate) const;
+
+    /*!
+        \brief Adds the memory used by the container to \a usage
+    */
+    void                memoryUsage(MemoryUsage& usage) const;
+
+    /*!
+        \brief Serialize the structure, without the unused palette entries
+        \param str String use for save the serialization
+    */
+    void                serialize(std::string& str) const;
+    /*!
+        \brief Unserialize \a str inside \a this
+        \param str String that contains data
+        \param size Size of the string
+        \return Number of bytes read inside str, 0 if the data is invalid
+    */
+    size_t              unserialize(char const* str, size_t size);
+
+private:
+    const static uint32_t NB_CELLS = NB_VOXELS * NB_VOXELS * NB_VOXELS;
+
+    /*!
+        \brief Returns the palette index of the cell \a id
+    */
+    uint16_t            getIndex(uint16_t id) const;
+    /*!
+        \brief Sets the palette index of the cell \a id
+    */
+    void                setIndex(uint16_t id, uint16_t index);
+    /*!
+        \brief Returns the index of \a voxel in the palette, adds it if needed, and increments its counter
+    */
+    uint16_t            acquire(VoxelData const& voxel);
+    /*!
+        \brief Decrements the counter of the palette entry \a index, the entry is reused when unused
+    */
+    void                release(uint16_t index);
+    /*!
+        \brief Changes the number of bits of the indices
+    */
+    void                resize(uint8_t bits);
+    /*!
+        \brief Returns the number of bits needed to store \a nbEntries different indices
+    */
+    static uint8_t      getBitsFor(size_t nbEntries);
+    /*!
+        \brief Constructs a voxel in \a memory with zeroed padding bytes, the voxels are compared by their bytes
+    */
+    template <typename... Args>
+    static VoxelData&   constructVoxel(void* memory, Args&&... args);
+
+    OccupancyMask           _occupancy;     //!< One bit per existing voxel
+    uint8_t                 _bits = 0;      //!< Number of bits of an index
+    std::vector<VoxelData>  _palette;       //!< Different voxels, the entry 0 is unused
+    std::vector<uint16_t>   _counters;      //!< Number of cells using each palette entry
+    std::vector<uint64_t>   _indices;       //!< Palette index of each cell, packed on \a _bits bits
+};
+
+}
+
+#include "PaletteContainer.ipp"
+
+#endif // _VOXOMAP_PALETTECONTAINER_HPP_
@@ -0,0 +1,383 @@
+#include <cstring>
+
+namespace voxomap
+{
+
+template <class T_Voxel>
+const uint32_t PaletteContainer<T_Voxel>::NB_CELLS;
+
+template <class T_Voxel>
+void* PaletteContainer<T_Voxel>::operator new(size_t size)
+{
+    if (size != sizeof(PaletteContainer<T_Voxel>))
+        return ::operator new(size);
+    return MemoryPool<sizeof(PaletteContainer<T_Voxel>)>::get().allocate();
+}
+
+template <class T_Voxel>
+void PaletteContainer<T_Voxel>::operator delete(void* ptr, size_t size)
+{
+    if (size != sizeof(PaletteContainer<T_Voxel>))
+        ::operator delete(ptr);
+    else
+        MemoryPool<sizeof(PaletteContainer<T_Voxel>)>::deallocate(ptr);
+}
+
+template <class T_Voxel>
+inline uint16_t PaletteContainer<T_Voxel>::getNbVoxel() const
+{
+    return _occupancy.count();
+}
+
+template <class T_Voxel>
+inline OccupancyMask const& PaletteContainer<T_Voxel>::getOccupancy() const
+{
+    return _occupancy;
+}
+
+template <class T_Voxel>
+inline uint8_t PaletteContainer<T_Voxel>::getIndexBits() const
+{
+    return _bits;
+}
+
+template <class T_Voxel>
+uint16_t PaletteContainer<T_Voxel>::getPaletteSize() const
+{
+    uint16_t size = 0;
+    for (size_t i = 1; i < _counters.size(); ++i)
+    {
+        if (_counters[i])
+            ++size;
+    }
+    return size;
+}
+
+template <class T_Voxel>
+inline bool PaletteContainer<T_Voxel>::hasVoxel(uint8_t x) const
+{
+    return _occupancy.test(x);
+}
+
+template <class T_Voxel>
+inline bool PaletteContainer<T_Voxel>::hasVoxel(uint8_t x, uint8_t y) const
+{
+    return _occupancy.test(x, y);
+}
+
+template <class T_Voxel>
+inline bool PaletteContainer<T_Voxel>::hasVoxel(uint8_t x, uint8_t y, uint8_t z) const
+{
+    return _occupancy.test(x, y, z);
+}
+
+template <class T_Voxel>
+inline T_Voxel* PaletteContainer<T_Voxel>::findVoxel(uint8_t x, uint8_t y, uint8_t z)
+{
+    uint16_t index = this->getIndex(static_cast<uint16_t>((x * NB_VOXELS + y) * NB_VOXELS + z));
+    return index ? &_palette[index] : nullptr;
+}
+
+template <class T_Voxel>
+inline T_Voxel const* PaletteContainer<T_Voxel>::findVoxel(uint8_t x, uint8_t y, uint8_t z) const
+{
+    uint16_t index = this->getIndex(static_cast<uint16_t>((x * NB_VOXELS + y) * NB_VOXELS + z));
+    return index ? &_palette[index] : nullptr;
+}
+
+template <class T_Voxel>
+template <typename Iterator>
+inline T_Voxel* PaletteContainer<T_Voxel>::findVoxel(Iterator& it)
+{
+    it.voxelContainer = static_cast<decltype(it.voxelContainer)>(this);
+    return this->findVoxel(it.x, it.y, it.z);
+}
+
+template <class T_Voxel>
+template <typename Iterator>
+inline T_Voxel const* PaletteContainer<T_Voxel>::findVoxel(Iterator& it) const
+{
+    it.voxelContainer = static_cast<decltype(it.voxelContainer)>(const_cast<PaletteContainer<T_Voxel>*>(this));
+    return this->findVoxel(it.x, it.y, it.z);
+}
+
+template <class T_Voxel>
+template <typename Iterator, typename... Args>
+bool PaletteContainer<T_Voxel>::addVoxel(Iterator& it, Args&&... args)
+{
+    it.voxelContainer = static_cast<decltype(it.voxelContainer)>(this);
+    uint16_t id = static_cast<uint16_t>((it.x * NB_VOXELS + it.y) * NB_VOXELS + it.z);
+    if (this->getIndex(id))
+        return false;
+
+    typename std::aligned_storage<sizeof(VoxelData), alignof(VoxelData)>::type memory;
+    uint16_t index = this->acquire(constructVoxel(&memory, std::forward<Args>(args)...));
+    this->setIndex(id, index);
+    _occupancy.set(it.x, it.y, it.z);
+    it.voxel = &_palette[index];
+    return true;
+}
+
+template <class T_Voxel>
+template <typename Iterator, typename... Args>
+bool PaletteContainer<T_Voxel>::updateVoxel(Iterator& it, Args&&... args)
+{
+    it.voxelContainer = static_cast<decltype(it.voxelContainer)>(this);
+    uint16_t id = static_cast<uint16_t>((it.x * NB_VOXELS + it.y) * NB_VOXELS + it.z);
+    uint16_t index = this->getIndex(id);
+    if (!index)
+        return false;
+
+    // The voxel is constructed before the release, the arguments can reference the current voxel
+    typename std::aligned_storage<sizeof(VoxelData), alignof(VoxelData)>::type memory;
+    VoxelData& voxel = constructVoxel(&memory, std::forward<Args>(args)...);
+    this->release(index);
+    index = this->acquire(voxel);
+    this->setIndex(id, index);
+    it.voxel = &_palette[index];
+    return true;
+}
+
+template <class T_Voxel>
+template <typename Iterator, typename... Args>
+void PaletteContainer<T_Voxel>::putVoxel(Iterator& it, Args&&... args)
+{
+    if (this->hasVoxel(it.x, it.y, it.z))
+        this->updateVoxel(it, std::forward<Args>(args)...);
+    else
+        this->addVoxel(it, std::forward<Args>(args)...);
+}
+
+template <class T_Voxel>
+template <typename Iterator>
+bool PaletteContainer<T_Voxel>::removeVoxel(Iterator const& it, VoxelData* voxel)
+{
+    uint16_t id = static_cast<uint16_t>((it.x * NB_VOXELS + it.y) * NB_VOXELS + it.z);
+    uint16_t index = this->getIndex(id);
+    if (!index)
+        return false;
+
+    if (voxel)
+        *voxel = _palette[index];
+    this->release(index);
+    this->setIndex(id, 0);
+    _occupancy.reset(it.x, it.y, it.z);
+    return true;
+}
+
+template <class T_Voxel>
+template <typename Iterator, typename T_Predicate>
+void PaletteContainer<T_Voxel>::exploreVoxel(Iterator& it, T_Predicate const& predicate) const
+{
+    for (uint16_t id = _occupancy.findNext(0); id < OccupancyMask::NB_BITS; id = _occupancy.findNext(id + 1))
+    {
+        it.x = static_cast<uint8_t>(id >> 6);
+        it.y = static_cast<uint8_t>(id >> 3 & 7);
+        it.z = static_cast<uint8_t>(id & 7);
+        it.voxel = const_cast<T_Voxel*>(&_palette[this->getIndex(id)]);
+        predicate(it);
+    }
+}
+
+template <class T_Voxel>
+template <typename T_Predicate>
+void PaletteContainer<T_Voxel>::exploreVoxelContainer(T_Predicate const& predicate) const
+{
+    predicate(*this);
+}
+
+template <class T_Voxel>
+void PaletteContainer<T_Voxel>::memoryUsage(MemoryUsage& usage) const
+{
+    usage.voxelContainers += sizeof(*this) + containerMemory(_palette) + containerMemory(_counters) + containerMemory(_indices);
+}
+
+template <class T_Voxel>
+void PaletteContainer<T_Voxel>::serialize(std::string& str) const
+{
+    uint16_t nb_voxel = this->getNbVoxel();
+    str.append(reinterpret_cast<char const*>(&nb_voxel), sizeof(nb_voxel));
+    if (nb_voxel == 0)
+        return;
+
+    // The unused entries are removed, and the indices use the smallest number of bits
+    std::vector<uint16_t> remap(_palette.size(), 0);
+    uint16_t nb_entry = 1;
+    for (size_t i = 1; i < _palette.size(); ++i)
+    {
+        if (_counters[i])
+            remap[i] = nb_entry++;
+    }
+
+    PaletteContainer<T_Voxel> packed;
+    packed.resize(getBitsFor(nb_entry));
+    for (uint16_t id = 0; id < NB_CELLS; ++id)
+        packed.setIndex(id, remap[this->getIndex(id)]);
+
+    str.append(reinterpret_cast<char const*>(&packed._bits), sizeof(packed._bits));
+    str.append(reinterpret_cast<char const*>(&nb_entry), sizeof(nb_entry));
+    for (size_t i = 1; i < _palette.size(); ++i)
+    {
+        if (_counters[i])
+            str.append(reinterpret_cast<char const*>(&_palette[i]), sizeof(VoxelData));
+    }
+    str.append(reinterpret_cast<char const*>(packed._indices.data()), packed._indices.size() * sizeof(uint64_t));
+}
+
+template <class T_Voxel>
+size_t PaletteContainer<T_Voxel>::unserialize(char const* str, size_t size)
+{
+    uint16_t nb_voxel;
+    uint8_t bits;
+    uint16_t nb_entry;
+    size_t pos = 0;
+
+    if (size < sizeof(nb_voxel))
+        return 0;
+    std::memcpy(&nb_voxel, str, sizeof(nb_voxel));
+    pos += sizeof(nb_voxel);
+
+    _occupancy.clear();
+    _bits = 0;
+    _palette.clear();
+    _counters.clear();
+    _indices.clear();
+    if (nb_voxel == 0)
+        return pos;
+
+    if (size < pos + sizeof(bits) + sizeof(nb_entry))
+        return 0;
+    std::memcpy(&bits, &str[pos], sizeof(bits));
+    pos += sizeof(bits);
+    std::memcpy(&nb_entry, &str[pos], sizeof(nb_entry));
+    pos += sizeof(nb_entry);
+    if (bits != getBitsFor(nb_entry) || nb_entry < 2)
+        return 0;
+
+    size_t palette_size = (nb_entry - 1) * sizeof(VoxelData);
+    size_t indices_size = NB_CELLS * bits / 64 * sizeof(uint64_t);
+    if (size < pos + palette_size + indices_size)
+        return 0;
+
+    _palette.resize(nb_entry);
+    std::memcpy(&_palette[1], &str[pos], palette_size);
+    pos += palette_size;
+    _bits = bits;
+    _indices.resize(NB_CELLS * bits / 64);
+    std::memcpy(_indices.data(), &str[pos], indices_size);
+    pos += indices_size;
+
+    _counters.assign(nb_entry, 0);
+    for (uint16_t id = 0; id < NB_CELLS; ++id)
+    {
+        uint16_t index = this->getIndex(id);
+        if (index >= nb_entry)
+            return 0;
+        if (index)
+        {
+            ++_counters[index];
+            _occupancy.set(static_cast<uint8_t>(id >> 6), static_cast<uint8_t>(id >> 3 & 7), static_cast<uint8_t>(id & 7));
+        }
+    }
+    return this->getNbVoxel() == nb_voxel ? pos : 0;
+}
+
+template <class T_Voxel>
+inline uint16_t PaletteContainer<T_Voxel>::getIndex(uint16_t id) const
+{
+    if (!_bits)
+        return 0;
+    uint32_t bit = static_cast<uint32_t>(id) * _bits;
+    return static_cast<uint16_t>(_indices[bit >> 6] >> (bit & 63) & ((uint64_t(1) << _bits) - 1));
+}
+
+template <class T_Voxel>
+inline void PaletteContainer<T_Voxel>::setIndex(uint16_t id, uint16_t index)
+{
+    // The indices never overlap two words: the number of bits divides 64
+    uint32_t bit = static_cast<uint32_t>(id) * _bits;
+    uint64_t mask = ((uint64_t(1) << _bits) - 1) << (bit & 63);
+    uint64_t& word = _indices[bit >> 6];
+    word = (word & ~mask) | (static_cast<uint64_t>(index) << (bit & 63) & mask);
+}
+
+template <class T_Voxel>
+uint16_t PaletteContainer<T_Voxel>::acquire(VoxelData const& voxel)
+{
+    uint16_t free_index = 0;
+    for (size_t i = 1; i < _palette.size(); ++i)
+    {
+        if (!_counters[i])
+        {
+            if (!free_index)
+                free_index = static_cast<uint16_t>(i);
+        }
+        else if (std::memcmp(&_palette[i], &voxel, sizeof(VoxelData)) == 0)
+        {
+            ++_counters[i];
+            return static_cast<uint16_t>(i);
+        }
+    }
+
+    if (!free_index)
+    {
+        if (_palette.empty())
+        {
+            _palette.emplace_back();
+            _counters.push_back(0);
+        }
+        free_index = static_cast<uint16_t>(_palette.size());
+        _palette.emplace_back();
+        _counters.push_back(0);
+        if (free_index >> _bits)
+            this->resize(getBitsFor(_palette.size()));
+    }
+    std::memcpy(&_palette[free_index], &voxel, sizeof(VoxelData));
+    _counters[free_index] = 1;
+    return free_index;
+}
+
+template <class T_Voxel>
+inline void PaletteContainer<T_Voxel>::release(uint16_t index)
+{
+    --_counters[index];
+}
+
+template <class T_Voxel>
+void PaletteContainer<T_Voxel>::resize(uint8_t bits)
+{
+    std::vector<uint64_t> old_indices(NB_CELLS * bits / 64, 0);
+    uint8_t old_bits = _bits;
+
+    old_indices.swap(_indices);
+    _bits = bits;
+    if (!old_bits)
+        return;
+
+    for (uint16_t id = 0; id < NB_CELLS; ++id)
+    {
+        uint32_t bit = static_cast<uint32_t>(id) * old_bits;
+        uint16_t index = static_cast<uint16_t>(old_indices[bit >> 6] >> (bit & 63) & ((uint64_t(1) << old_bits) - 1));
+        if (index)
+            this->setIndex(id, index);
+    }
+}
+
+template <class T_Voxel>
+inline uint8_t PaletteContainer<T_Voxel>::getBitsFor(size_t nbEntries)
+{
+    uint8_t bits = 1;
+    while ((size_t(1) << bits) < nbEntries)
+        bits *= 2;
+    return bits;
+}
+
+template <class T_Voxel>
+template <typename... Args>
+inline T_Voxel& PaletteContainer<T_Voxel>::constructVoxel(void* memory, Args&&... args)
+{
+    std::memset(memory, 0, sizeof(VoxelData));
+    return *new (memory) VoxelData(std::forward<Args>(args)...);
+}
+
+}
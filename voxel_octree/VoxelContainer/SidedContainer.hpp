@@ -6,6 +6,8 @@
 #include <type_traits>
 #include "../VoxelNode.hpp"
 #include "../iterator.hpp"
+#include "../../utils/MemoryUsage.hpp"
+#include "../../utils/MemoryPool.hpp"
 
 namespace voxomap
 {
@@ -162,6 +164,7 @@ struct SidedContainer : public T_Container<SidedVoxel<T_Voxel>>
     const static uint32_t COORD_MASK = ~(NB_VOXELS - 1);
     const static uint32_t VOXEL_MASK = NB_VOXELS - 1;
     const static uint32_t NB_SUPERCONTAINER = 0;
+    const static bool MAPPABLE = false;
 
     /*!
         \brief Default constructor
@@ -176,6 +179,16 @@ struct SidedContainer : public T_Container<SidedVoxel<T_Voxel>>
     */
     SidedContainer(SidedContainer&& other) = default;
 
+    /*!
+        \brief Allocates the container inside a MemoryPool
+        \details Redefined because the operator of the base container only pools its own size
+    */
+    static void*        operator new(size_t size);
+    /*!
+        \brief Releases a container allocated with operator new
+    */
+    static void         operator delete(void* ptr, size_t size);
+
     /*!
         \brief Initialization method, do nothing
     */
@@ -217,7 +230,17 @@ struct SidedContainer : public T_Container<SidedVoxel<T_Voxel>>
     template <typename Iterator>
     bool                removeVoxel(Iterator const& it, VoxelData* voxel = nullptr);
 
-    void                exploreVoxelContainer(std::function<void(SidedContainer const&)> const& predicate) const;
+    /*!
+        \brief Call the \a predicate on the container
+        \param predicate Function called with the container: void(SidedContainer const&)
+    */
+    template <typename T_Predicate>
+    void                exploreVoxelContainer(T_Predicate const& predicate) const;
+
+    /*!
+        \brief Adds the memory used by the container to \a usage
+    */
+    void                memoryUsage(MemoryUsage& usage) const;
 
     /*!
         \brief Serialize the structure
@@ -237,12 +260,19 @@ private:
     template <typename Iterator>
     void addSide(Iterator const& it);
     template <typename Iterator>
-    void removeSide(Iterator const& it);
+    void removeSide(Iterator& it);
+    template <typename Iterator>
+    void updateSide(Iterator& it);
+    /*!
+        \brief Replaces the side of the voxel of \a it, \a it is updated
+        \details The voxel is written through the base container and not through its pointer,
+        a container can share a voxel between several positions (PaletteContainer).
+    */
     template <typename Iterator>
-    void updateSide(Iterator const& it);
+    void setSide(Iterator& it, uint8_t side);
     template <class Iterator> friend void addSide(Iterator const& otherIt, SideEnum side);
-    template <class Iterator> friend void removeSide(Iterator const& currentIt, Iterator const& otherIt, SideEnum s1, SideEnum s2);
-    template <class Iterator> friend void updateSide(Iterator const& currentIt, Iterator const& otherIt, SideEnum s1, SideEnum s2);
+    template <class Iterator> friend void removeSide(Iterator& currentIt, Iterator otherIt, SideEnum s1, SideEnum s2);
+    template <class Iterator> friend void updateSide(Iterator& currentIt, Iterator otherIt, SideEnum s1, SideEnum s2);
 
     uint16_t _nbSides = 0;
 };
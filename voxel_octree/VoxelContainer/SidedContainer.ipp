@@ -116,6 +116,23 @@ inline uint8_t SidedVoxel<T_Voxel>::getSide() const
 
 
 // SidedContainer
+template <template <class...> class T_Container, class T_Voxel>
+void* SidedContainer<T_Container, T_Voxel>::operator new(size_t size)
+{
+    if (size != sizeof(SidedContainer<T_Container, T_Voxel>))
+        return ::operator new(size);
+    return MemoryPool<sizeof(SidedContainer<T_Container, T_Voxel>)>::get().allocate();
+}
+
+template <template <class...> class T_Container, class T_Voxel>
+void SidedContainer<T_Container, T_Voxel>::operator delete(void* ptr, size_t size)
+{
+    if (size != sizeof(SidedContainer<T_Container, T_Voxel>))
+        ::operator delete(ptr);
+    else
+        MemoryPool<sizeof(SidedContainer<T_Container, T_Voxel>)>::deallocate(ptr);
+}
+
 template <template <class...> class T_Container, class T_Voxel>
 inline uint16_t SidedContainer<T_Container, T_Voxel>::getNbSide() const
 {
@@ -169,11 +186,19 @@ bool SidedContainer<T_Container, T_Voxel>::removeVoxel(Iterator const& it, Voxel
 }
 
 template <template <class...> class T_Container, class T_Voxel>
-void SidedContainer<T_Container, T_Voxel>::exploreVoxelContainer(std::function<void(SidedContainer const&)> const& predicate) const
+template <typename T_Predicate>
+void SidedContainer<T_Container, T_Voxel>::exploreVoxelContainer(T_Predicate const& predicate) const
 {
     predicate(*this);
 }
 
+template <template <class...> class T_Container, class T_Voxel>
+void SidedContainer<T_Container, T_Voxel>::memoryUsage(MemoryUsage& usage) const
+{
+    T_Container<VoxelData>::memoryUsage(usage);
+    usage.voxelContainers += sizeof(*this) - sizeof(T_Container<VoxelData>);
+}
+
 
 template <template <class...> class T_Container, class T_Voxel>
 void SidedContainer<T_Container, T_Voxel>::serialize(std::string& str) const
@@ -194,37 +219,47 @@ size_t SidedContainer<T_Container, T_Voxel>::unserialize(char const* str, size_t
 
 
 // Side management
+template <class Iterator>
+inline static void refreshVoxel(Iterator& it)
+{
+    // The voxel can move when a voxel of the same container is written
+    it.voxel = it.voxelContainer->findVoxel(it.x, it.y, it.z);
+}
+
 template <class Iterator>
 inline static void addSide(Iterator const& otherIt, SideEnum side)
 {
     if (otherIt.voxel)
     {
-        *otherIt.voxel &= ~side;
-        ++otherIt.voxelContainer->_nbSides;
+        Iterator other = otherIt;
+        other.voxelContainer->setSide(other, *other.voxel & static_cast<uint8_t>(~side));
+        ++other.voxelContainer->_nbSides;
     }
 }
 
 template <class Iterator>
-inline static void removeSide(Iterator const& currentIt, Iterator const& otherIt, SideEnum f1, SideEnum f2)
+inline static void removeSide(Iterator& currentIt, Iterator otherIt, SideEnum f1, SideEnum f2)
 {
     if (!currentIt.voxel || !otherIt.voxel)
         return;
 
     if (currentIt.voxel->mergeSide(*otherIt.voxel))
     {
-        *currentIt.voxel |= f1;
+        currentIt.voxelContainer->setSide(currentIt, *currentIt.voxel | f1);
         --currentIt.voxelContainer->_nbSides;
+        refreshVoxel(otherIt);
     }
 
     if (otherIt.voxel->mergeSide(*currentIt.voxel))
     {
-        *otherIt.voxel |= f2;
+        otherIt.voxelContainer->setSide(otherIt, *otherIt.voxel | f2);
         --otherIt.voxelContainer->_nbSides;
+        refreshVoxel(currentIt);
     }
 }
 
 template <class Iterator>
-inline static void updateSide(Iterator const& currentIt, Iterator const& otherIt, SideEnum f1, SideEnum f2)
+inline static void updateSide(Iterator& currentIt, Iterator otherIt, SideEnum f1, SideEnum f2)
 {
     if (!otherIt.voxel)
         return;
@@ -233,28 +268,32 @@ inline static void updateSide(Iterator const& currentIt, Iterator const& otherIt
     {
         if ((*currentIt.voxel & f1) == 0)
         {
-            *currentIt.voxel |= f1;
+            currentIt.voxelContainer->setSide(currentIt, *currentIt.voxel | f1);
             --currentIt.voxelContainer->_nbSides;
+            refreshVoxel(otherIt);
         }
     }
     else if (*currentIt.voxel & f1)
     {
-        *currentIt.voxel &= ~f1;
+        currentIt.voxelContainer->setSide(currentIt, *currentIt.voxel & static_cast<uint8_t>(~f1));
         ++currentIt.voxelContainer->_nbSides;
+        refreshVoxel(otherIt);
     }
 
     if (otherIt.voxel->mergeSide(*currentIt.voxel))
     {
         if ((*otherIt.voxel & f2) == 0)
         {
-            *otherIt.voxel |= f2;
+            otherIt.voxelContainer->setSide(otherIt, *otherIt.voxel | f2);
             --otherIt.voxelContainer->_nbSides;
+            refreshVoxel(currentIt);
         }
     }
     else if (*otherIt.voxel & f2)
     {
-        *otherIt.voxel &= ~f2;
+        otherIt.voxelContainer->setSide(otherIt, *otherIt.voxel & static_cast<uint8_t>(~f2));
         ++otherIt.voxelContainer-> _nbSides;
+        refreshVoxel(currentIt);
     }
 }
 
@@ -278,7 +317,7 @@ void SidedContainer<T_Container, T_Voxel>::addSide(Iterator const& it)
 
 template <template <class...> class T_Container, class T_Voxel>
 template <typename Iterator>
-void SidedContainer<T_Container, T_Voxel>::removeSide(Iterator const& it)
+void SidedContainer<T_Container, T_Voxel>::removeSide(Iterator& it)
 {
     int x, y, z;
     it.getVoxelPosition(x, y, z);
@@ -296,7 +335,7 @@ void SidedContainer<T_Container, T_Voxel>::removeSide(Iterator const& it)
 
 template <template <class...> class T_Container, class T_Voxel>
 template <typename Iterator>
-void SidedContainer<T_Container, T_Voxel>::updateSide(Iterator const& it)
+void SidedContainer<T_Container, T_Voxel>::updateSide(Iterator& it)
 {
     int x, y, z;
     it.getVoxelPosition(x, y, z);
@@ -312,4 +351,14 @@ void SidedContainer<T_Container, T_Voxel>::updateSide(Iterator const& it)
     voxomap::updateSide(it, it.node->findRelativeVoxel(x, y, z + 1), SideEnum::ZPOS, SideEnum::ZNEG);
 }
 
-}
\ No newline at end of file
+template <template <class...> class T_Container, class T_Voxel>
+template <typename Iterator>
+void SidedContainer<T_Container, T_Voxel>::setSide(Iterator& it, uint8_t side)
+{
+    VoxelData voxel = *it.voxel;
+    voxel &= 0;
+    voxel |= side;
+    T_Container<VoxelData>::updateVoxel(it, voxel);
+}
+
+}
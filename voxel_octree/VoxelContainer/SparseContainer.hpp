@@ -2,9 +2,15 @@
 #define _VOXOMAP_SPARSECONTAINER_HPP_
 
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
 #include <vector>
 #include "../iterator.hpp"
+#include "../../utils/MemoryUsage.hpp"
 #include "../SparseIDArray.hpp"
+#include "OccupancyMask.hpp"
+#include "../../utils/MemoryPool.hpp"
 
 namespace voxomap
 {
@@ -27,6 +33,11 @@ template <typename T_Area> class VoxelNode;
     - A dynamic vector that contains the voxels
     - A fixed size array (like ArrayContainer) that contains the voxel id inside the above vector, 0 if there is no voxel
     - A dynamic vector that contains the unused voxel inside the first vector. Due to performance issue, the removed voxel are not removed from the first vector.
+
+    A container full of one identical voxel is collapsed: the arrays are released and only one voxel is stored.
+    The container is expanded on the first write of a different voxel or on a removal.
+    The voxel of a collapsed container is shared by all the positions: it must be modified with
+    updateVoxel or putVoxel, not through the pointer returned by findVoxel.
 */
 template <class T_Voxel, template<class...> class T_Container = std::vector>
 class SparseContainer
@@ -40,15 +51,25 @@ public:
     const static uint32_t COORD_MASK = ~(NB_VOXELS - 1);
     const static uint32_t VOXEL_MASK = NB_VOXELS - 1;
     const static uint32_t NB_SUPERCONTAINER = 0;
+    const static bool MAPPABLE = false;
 
     /*!
         \brief Default constructor
     */
     SparseContainer() = default;
     /*!
-        \brief Default copy constructor
+        \brief Copy constructor
+    */
+    SparseContainer(SparseContainer const& other);
+
+    /*!
+        \brief Allocates the container inside a MemoryPool
+    */
+    static void*        operator new(size_t size);
+    /*!
+        \brief Releases a container allocated with operator new
     */
-    SparseContainer(SparseContainer const& other) = default;
+    static void         operator delete(void* ptr, size_t size);
 
     /*!
         \brief Initialization method, do nothing
@@ -58,6 +79,14 @@ public:
         \brief Returns number of voxels
     */
     uint16_t            getNbVoxel() const;
+    /*!
+        \brief Returns the occupancy mask, one bit per existing voxel
+    */
+    OccupancyMask const& getOccupancy() const;
+    /*!
+        \brief Returns the voxel of all the positions if the container is collapsed, otherwise nullptr
+    */
+    VoxelData const*    getUniformVoxel() const;
 
     /*!
         \brief Check if there is voxel inside
@@ -147,12 +176,21 @@ public:
     /*!
         \brief Go through all voxels of the container and call the \a predicate for each
         \param it Begin iterator
-        \param predicate Function called for each voxel found
+        \param predicate Function called for each voxel found: void(Iterator const&)
     */
-    template <typename Iterator>
-    void                exploreVoxel(Iterator& it, std::function<void(Iterator const&)> const& predicate) const;
+    template <typename Iterator, typename T_Predicate>
+    void                exploreVoxel(Iterator& it, T_Predicate const& predicate) const;
+    /*!
+        \brief Call the \a predicate on the container
+        \param predicate Function called with the container: void(SparseContainer const&)
+    */
+    template <typename T_Predicate>
+    void                exploreVoxelContainer(T_Predicate const& predicate) const;
 
-    void                exploreVoxelContainer(std::function<void(SparseContainer const&)> const& predicate) const;
+    /*!
+        \brief Adds the memory used by the container to \a usage
+    */
+    void                memoryUsage(MemoryUsage& usage) const;
 
     /*!
         \brief Serialize the structure
@@ -168,7 +206,28 @@ public:
     size_t              unserialize(char const* str, size_t size);
 
 private:
+    /*!
+        \brief Collapses the container if it is full of one identical voxel
+    */
+    void                collapse();
+    /*!
+        \brief Collapses the container after the write of the voxel at (\a x, \a y, \a z)
+        The container is browsed only if the written voxel and the last different voxel found are now identical to the first one
+    */
+    void                collapse(uint8_t x, uint8_t y, uint8_t z);
+    /*!
+        \brief Collapses the container, all the positions contain \a voxel
+    */
+    void                setUniformVoxel(VoxelData const& voxel);
+    /*!
+        \brief Expands a collapsed container, all the positions contain a copy of the uniform voxel
+    */
+    void                expand();
+
     SparseIDArray<T_Voxel, NB_VOXELS, T_Container> _sparseArray;
+    std::unique_ptr<VoxelData> _uniformVoxel;   //!< Voxel of all the positions when the container is collapsed
+    OccupancyMask _occupancy;                   //!< One bit per existing voxel
+    uint16_t _collapseHint = 0;                 //!< Index of the last voxel found different from the first one
 };
 
 }
@@ -1,40 +1,82 @@
 namespace voxomap
 {
 
+template <class T_Voxel, template<class...> class T_Container>
+void* SparseContainer<T_Voxel, T_Container>::operator new(size_t size)
+{
+    if (size != sizeof(SparseContainer<T_Voxel, T_Container>))
+        return ::operator new(size);
+    return MemoryPool<sizeof(SparseContainer<T_Voxel, T_Container>)>::get().allocate();
+}
+
+template <class T_Voxel, template<class...> class T_Container>
+void SparseContainer<T_Voxel, T_Container>::operator delete(void* ptr, size_t size)
+{
+    if (size != sizeof(SparseContainer<T_Voxel, T_Container>))
+        ::operator delete(ptr);
+    else
+        MemoryPool<sizeof(SparseContainer<T_Voxel, T_Container>)>::deallocate(ptr);
+}
+
+template <class T_Voxel, template<class...> class T_Container>
+SparseContainer<T_Voxel, T_Container>::SparseContainer(SparseContainer const& other)
+    : _sparseArray(other._sparseArray)
+    , _uniformVoxel(other._uniformVoxel ? new VoxelData(*other._uniformVoxel) : nullptr)
+    , _occupancy(other._occupancy)
+    , _collapseHint(other._collapseHint)
+{
+}
+
 template <class T_Voxel, template<class...> class T_Container>
 inline uint16_t SparseContainer<T_Voxel, T_Container>::getNbVoxel() const
 {
-    return _sparseArray.getNbData();
+    return _uniformVoxel ? NB_VOXELS * NB_VOXELS * NB_VOXELS : _sparseArray.getNbData();
+}
+
+template <class T_Voxel, template<class...> class T_Container>
+inline OccupancyMask const& SparseContainer<T_Voxel, T_Container>::getOccupancy() const
+{
+    return _occupancy;
+}
+
+template <class T_Voxel, template<class...> class T_Container>
+inline T_Voxel const* SparseContainer<T_Voxel, T_Container>::getUniformVoxel() const
+{
+    return _uniformVoxel.get();
 }
 
 template <class T_Voxel, template<class...> class T_Container>
 inline bool SparseContainer<T_Voxel, T_Container>::hasVoxel(uint8_t x) const
 {
-    return _sparseArray.hasData(x);
+    return _occupancy.test(x);
 }
 
 template <class T_Voxel, template<class...> class T_Container>
 inline bool SparseContainer<T_Voxel, T_Container>::hasVoxel(uint8_t x, uint8_t y) const
 {
-    return _sparseArray.hasData(x, y);
+    return _occupancy.test(x, y);
 }
 
 template <class T_Voxel, template<class...> class T_Container>
 inline bool SparseContainer<T_Voxel, T_Container>::hasVoxel(uint8_t x, uint8_t y, uint8_t z) const
 {
-    return _sparseArray.hasData(x, y, z);
+    return _occupancy.test(x, y, z);
 }
 
 template <class T_Voxel, template<class...> class T_Container>
 inline T_Voxel* SparseContainer<T_Voxel, T_Container>::findVoxel(uint8_t x, uint8_t y, uint8_t z)
 {
-    return _sparseArray.findData(x, y, z);
+    if (!_occupancy.test(x, y, z))
+        return nullptr;
+    return _uniformVoxel ? _uniformVoxel.get() : _sparseArray.findData(x, y, z);
 }
 
 template <class T_Voxel, template<class...> class T_Container>
 inline T_Voxel const* SparseContainer<T_Voxel, T_Container>::findVoxel(uint8_t x, uint8_t y, uint8_t z) const
 {
-    return _sparseArray.findData(x, y, z);
+    if (!_occupancy.test(x, y, z))
+        return nullptr;
+    return _uniformVoxel ? _uniformVoxel.get() : _sparseArray.findData(x, y, z);
 }
 
 template <class T_Voxel, template<class...> class T_Container>
@@ -58,7 +100,19 @@ template <typename Iterator, typename... Args>
 inline bool SparseContainer<T_Voxel, T_Container>::addVoxel(Iterator& it, Args&&... args)
 {
     it.voxelContainer = static_cast<decltype(it.voxelContainer)>(const_cast<SparseContainer<T_Voxel>*>(this));
-    return _sparseArray.addData(it.x, it.y, it.z, it.voxel, std::forward<Args>(args)...);
+    if (_uniformVoxel)
+    {
+        it.voxel = _uniformVoxel.get();
+        return false;
+    }
+    if (!_sparseArray.addData(it.x, it.y, it.z, it.voxel, std::forward<Args>(args)...))
+        return false;
+
+    _occupancy.set(it.x, it.y, it.z);
+    this->collapse(it.x, it.y, it.z);
+    if (_uniformVoxel)
+        it.voxel = _uniformVoxel.get();
+    return true;
 }
 
 template <class T_Voxel, template<class...> class T_Container>
@@ -66,64 +120,183 @@ template <typename Iterator, typename... Args>
 inline bool SparseContainer<T_Voxel, T_Container>::updateVoxel(Iterator& it, Args&&... args)
 {
     it.voxelContainer = static_cast<decltype(it.voxelContainer)>(const_cast<SparseContainer<T_Voxel>*>(this));
-    return _sparseArray.updateData(it.x, it.y, it.z, it.voxel, std::forward<Args>(args)...);
+    if (_uniformVoxel)
+    {
+        // The padding bytes are zeroed, the voxels are compared by their bytes
+        typename std::aligned_storage<sizeof(VoxelData), alignof(VoxelData)>::type memory;
+        std::memset(&memory, 0, sizeof(VoxelData));
+        VoxelData& voxel = *new (&memory) VoxelData(std::forward<Args>(args)...);
+        if (std::memcmp(&voxel, _uniformVoxel.get(), sizeof(VoxelData)) == 0)
+        {
+            it.voxel = _uniformVoxel.get();
+            return true;
+        }
+        this->expand();
+        return _sparseArray.updateData(it.x, it.y, it.z, it.voxel, voxel);
+    }
+    if (!_sparseArray.updateData(it.x, it.y, it.z, it.voxel, std::forward<Args>(args)...))
+        return false;
+
+    this->collapse(it.x, it.y, it.z);
+    if (_uniformVoxel)
+        it.voxel = _uniformVoxel.get();
+    return true;
 }
 
 template <class T_Voxel, template<class...> class T_Container>
 template <typename Iterator, typename... Args>
 inline void SparseContainer<T_Voxel, T_Container>::putVoxel(Iterator& it, Args&&... args)
 {
+    if (_uniformVoxel)
+    {
+        this->updateVoxel(it, std::forward<Args>(args)...);
+        return;
+    }
     it.voxelContainer = static_cast<decltype(it.voxelContainer)>(const_cast<SparseContainer<T_Voxel>*>(this));
     _sparseArray.putData(it.x, it.y, it.z, it.voxel, std::forward<Args>(args)...);
+    _occupancy.set(it.x, it.y, it.z);
+    this->collapse(it.x, it.y, it.z);
+    if (_uniformVoxel)
+        it.voxel = _uniformVoxel.get();
 }
 
 template <class T_Voxel, template<class...> class T_Container>
 template <typename Iterator>
 inline bool SparseContainer<T_Voxel, T_Container>::removeVoxel(Iterator const& it, VoxelData* voxel)
 {
-    return _sparseArray.removeData(it.x, it.y, it.z, voxel);
+    if (_uniformVoxel)
+        this->expand();
+    if (!_sparseArray.removeData(it.x, it.y, it.z, voxel))
+        return false;
+    _occupancy.reset(it.x, it.y, it.z);
+    return true;
 }
 
 template <class T_Voxel, template<class...> class T_Container>
-template <typename Iterator>
-void SparseContainer<T_Voxel, T_Container>::exploreVoxel(Iterator& it, std::function<void(Iterator const&)> const& predicate) const
+template <typename Iterator, typename T_Predicate>
+void SparseContainer<T_Voxel, T_Container>::exploreVoxel(Iterator& it, T_Predicate const& predicate) const
 {
-    for (it.x = 0; it.x < NB_VOXELS; ++it.x)
+    for (uint16_t id = _occupancy.findNext(0); id < OccupancyMask::NB_BITS; id = _occupancy.findNext(id + 1))
     {
-        if (!this->hasVoxel(it.x))
-            continue;
+        it.x = static_cast<uint8_t>(id >> 6);
+        it.y = static_cast<uint8_t>(id >> 3 & 7);
+        it.z = static_cast<uint8_t>(id & 7);
+        it.voxel = _uniformVoxel ? _uniformVoxel.get() : const_cast<T_Voxel*>(_sparseArray.findData(it.x, it.y, it.z));
+        predicate(it);
+    }
+}
 
-        for (it.y = 0; it.y < NB_VOXELS; ++it.y)
-        {
-            if (!this->hasVoxel(it.x, it.y))
-                continue;
+template <class T_Voxel, template<class...> class T_Container>
+template <typename T_Predicate>
+void SparseContainer<T_Voxel, T_Container>::exploreVoxelContainer(T_Predicate const& predicate) const
+{
+    predicate(*this);
+}
+
+template <class T_Voxel, template<class...> class T_Container>
+void SparseContainer<T_Voxel, T_Container>::memoryUsage(MemoryUsage& usage) const
+{
+    if (_uniformVoxel)
+    {
+        usage.voxelContainers += sizeof(*this) + sizeof(VoxelData);
+        return;
+    }
+    usage.voxelContainers += sizeof(*this) + _sparseArray.getDataMemory();
+    usage.idTables += _sparseArray.getIdTableMemory();
+}
+
+template <class T_Voxel, template<class...> class T_Container>
+inline void SparseContainer<T_Voxel, T_Container>::serialize(std::string& str) const
+{
+    if (_uniformVoxel)
+        _sparseArray.serializeUniform(str, *_uniformVoxel);
+    else
+        _sparseArray.serialize(str);
+}
+
+template <class T_Voxel, template<class...> class T_Container>
+inline size_t SparseContainer<T_Voxel, T_Container>::unserialize(char const* str, size_t size)
+{
+    VoxelData voxel;
+    size_t uSize = _sparseArray.unserializeUniform(str, size, voxel);
+    if (uSize)
+    {
+        this->setUniformVoxel(voxel);
+        return uSize;
+    }
 
-            for (it.z = 0; it.z < NB_VOXELS; ++it.z)
+    if (_uniformVoxel)
+        this->expand();
+    uSize = _sparseArray.unserialize(str, size);
+    _occupancy.clear();
+    for (uint8_t x = 0; x < NB_VOXELS; ++x)
+    {
+        if (!_sparseArray.hasData(x))
+            continue;
+        for (uint8_t y = 0; y < NB_VOXELS; ++y)
+        {
+            for (uint8_t z = 0; z < NB_VOXELS; ++z)
             {
-                it.voxel = const_cast<T_Voxel*>(this->findVoxel(it.x, it.y, it.z));
-                if (it.voxel)
-                    predicate(it);
+                if (_sparseArray.hasData(x, y, z))
+                    _occupancy.set(x, y, z);
             }
         }
     }
+    this->collapse();
+    return uSize;
 }
 
 template <class T_Voxel, template<class...> class T_Container>
-void SparseContainer<T_Voxel, T_Container>::exploreVoxelContainer(std::function<void(SparseContainer const&)> const& predicate) const
+void SparseContainer<T_Voxel, T_Container>::collapse()
 {
-    predicate(*this);
+    if (!std::is_trivially_copyable<T_Voxel>::value || _sparseArray.getNbData() != NB_VOXELS * NB_VOXELS * NB_VOXELS)
+        return;
+
+    T_Voxel const* first = _sparseArray.findData(0, 0, 0);
+    for (uint16_t id = 1; id < OccupancyMask::NB_BITS; ++id)
+    {
+        T_Voxel const* voxel = _sparseArray.findData(static_cast<uint8_t>(id >> 6), static_cast<uint8_t>(id >> 3 & 7), static_cast<uint8_t>(id & 7));
+        if (std::memcmp(voxel, first, sizeof(T_Voxel)) != 0)
+        {
+            _collapseHint = id;
+            return;
+        }
+    }
+
+    this->setUniformVoxel(*first);
 }
 
 template <class T_Voxel, template<class...> class T_Container>
-inline void SparseContainer<T_Voxel, T_Container>::serialize(std::string& str) const
+inline void SparseContainer<T_Voxel, T_Container>::collapse(uint8_t x, uint8_t y, uint8_t z)
 {
-    _sparseArray.serialize(str);
+    if (!std::is_trivially_copyable<T_Voxel>::value || _sparseArray.getNbData() != NB_VOXELS * NB_VOXELS * NB_VOXELS)
+        return;
+
+    // A different voxel is often found again at the same position, the container is browsed only if it changed
+    T_Voxel const* first = _sparseArray.findData(0, 0, 0);
+    T_Voxel const* hint = _sparseArray.findData(static_cast<uint8_t>(_collapseHint >> 6), static_cast<uint8_t>(_collapseHint >> 3 & 7), static_cast<uint8_t>(_collapseHint & 7));
+    if (std::memcmp(_sparseArray.findData(x, y, z), first, sizeof(T_Voxel)) != 0 ||
+        std::memcmp(hint, first, sizeof(T_Voxel)) != 0)
+        return;
+    this->collapse();
 }
 
 template <class T_Voxel, template<class...> class T_Container>
-inline size_t SparseContainer<T_Voxel, T_Container>::unserialize(char const* str, size_t size)
+void SparseContainer<T_Voxel, T_Container>::setUniformVoxel(VoxelData const& voxel)
 {
-    return _sparseArray.unserialize(str, size);
+    // The padding bytes are zeroed, like the voxels compared in updateVoxel
+    void* memory = ::operator new(sizeof(VoxelData));
+    std::memset(memory, 0, sizeof(VoxelData));
+    _uniformVoxel.reset(new (memory) VoxelData(voxel));
+    _sparseArray.release();
+    _occupancy.fill();
 }
 
-}
\ No newline at end of file
+template <class T_Voxel, template<class...> class T_Container>
+void SparseContainer<T_Voxel, T_Container>::expand()
+{
+    _sparseArray.fill(*_uniformVoxel);
+    _uniformVoxel.reset();
+}
+
+}
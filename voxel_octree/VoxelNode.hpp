@@ -7,6 +7,8 @@
 #include <functional>
 #include "../octree/Node.hpp"
 #include "../utils/BoundingBox.hpp"
+#include "../utils/MemoryUsage.hpp"
+#include "../utils/Stream.hpp"
 
 namespace voxomap
 {
@@ -52,6 +54,10 @@ public:
         \brief Copy constructor
     */
     VoxelNode(VoxelNode const& other);
+    /*!
+        \brief Copies \a other and its children inside the node pool of \a octree
+    */
+    VoxelNode(VoxelNode const& other, Octree<VoxelNode>& octree);
     /*!
         \brief Default destructor
     */
@@ -86,6 +92,10 @@ public:
         \brief Returns a shared pointer to the voxel container
     */
     std::shared_ptr<T_Container>	getSharedVoxelContainer();
+    /*!
+        \brief Returns the shared pointer to the voxel container
+    */
+    std::shared_ptr<T_Container> const& getSharedVoxelContainer() const;
     /*!
         \brief Sets the voxel container
     */
@@ -156,35 +166,40 @@ public:
 
     /*!
         \brief Browse all voxels and call \a predicate on each
-        \param predicate Function called for each voxel
+        \param predicate Function called for each voxel: void(iterator const&)
     */
-    void                    exploreVoxel(std::function<void(iterator const&)> const& predicate) const;
+    template <typename T_Predicate>
+    void                    exploreVoxel(T_Predicate const& predicate) const;
 
     /*!
         \brief Browse all voxel containers and call \a predicate on each
-        \param predicate Function called for each voxel container
+        \param predicate Function called for each voxel container: void(VoxelContainer const&)
     */
-    void                    exploreVoxelContainer(std::function<void(typename T_Container::VoxelContainer const&)> const& predicate) const;
+    template <typename T_Predicate>
+    void                    exploreVoxelContainer(T_Predicate const& predicate) const;
 
     /*!
         \brief Browse all voxel nodes and call \a predicate on each
-        \param predicate Function called for each voxel node
+        \param predicate Function called for each voxel node: void(VoxelNode const&)
     */
-    void                    exploreVoxelNode(std::function<void(VoxelNode const&)> const& predicate) const;
+    template <typename T_Predicate>
+    void                    exploreVoxelNode(T_Predicate const& predicate) const;
     /*!
         \brief Browse all voxel containers and call \a predicate on each
-        \param predicate Function called for each voxel area
+        \param predicate Function called for each voxel area: void(VoxelNode&)
     */
-    void                    exploreVoxelNode(std::function<void(VoxelNode&)> const& predicate);
+    template <typename T_Predicate>
+    void                    exploreVoxelNode(T_Predicate const& predicate);
     /*!
         \brief Browse all voxel containers
         \param bounding_box The aligned axis bounding box
-        \param in_predicate Function called for each voxel container inside the bounding box
-        \param out_predicate Function called for each voxel container outside the bounding box
+        \param in_predicate Function called for each voxel container inside the bounding box: void(VoxelNode&), can be nullptr
+        \param out_predicate Function called for each voxel container outside the bounding box: void(VoxelNode&), can be nullptr
     */
+    template <typename T_InPredicate, typename T_OutPredicate>
     void                    exploreBoundingBox(BoundingBox<int> const& bounding_box,
-                                               std::function<void(VoxelNode&)> const& in_predicate,
-                                               std::function<void(VoxelNode&)> const& out_predicate);
+                                               T_InPredicate const& in_predicate,
+                                               T_OutPredicate const& out_predicate);
 
     /*!
         \brief Copy the voxel container if a modification occured (add/remove/update voxel)
@@ -200,11 +215,28 @@ public:
         \brief Returns true if there is no voxel
     */
     bool                    empty() const;
+    /*!
+        \brief Adds the memory used by the node, its container and its children to \a usage
+        \details A container shared with another structure is counted once in MemoryUsage::sharedContainers.
+    */
+    void                    memoryUsage(MemoryUsage& usage) const;
     /*!
         \brief Serialize the structure
         \param str String use for save the serialization
     */
     void                    serialize(std::string& str) const;
+    /*!
+        \brief Serialize the voxel containers of the subtree modified after \a checkpoint
+        \details The subtrees not modified after the checkpoint are skipped.
+        \param str String use for save the serialization
+        \param checkpoint Edit epoch, see VoxelOctree::checkpoint
+        \return Number of voxel containers serialized
+    */
+    uint32_t                serializeDelta(std::string& str, uint64_t checkpoint) const;
+    /*!
+        \brief Returns the last edit epoch of the node or of its subtree
+    */
+    uint64_t                getEpoch() const;
     /*!
         \brief Unserialize \a str
         \param octree Octree where to push unserialized node
@@ -213,15 +245,54 @@ public:
         \return Number of bytes read inside str
     */
     static size_t           unserialize(VoxelOctree<T_Container>& octree, char const* str, size_t strsize);
+    /*!
+        \brief Serialize the structure in \a writer, one voxel container at a time
+        \details The format is not the same as serialize(std::string&): the size of each container
+        is written before it, so the reader doesn't need the whole data.
+        \param writer The sink, not flushed
+        \return False if the writer failed
+    */
+    bool                    serialize(StreamWriter& writer) const;
+    /*!
+        \brief Unserialize the data of \a reader written by serialize(StreamWriter&)
+        \param octree Octree where to push unserialized node
+        \param reader The source
+        \return False if the data is invalid or incomplete
+    */
+    static bool             unserialize(VoxelOctree<T_Container>& octree, StreamReader& reader);
 
 private:
     /*!
         \brief Serialize \a node in \a str
     */
     uint32_t                serializeNode(std::string& str) const;
-    
+    /*!
+        \brief Serialize the position of the node and its voxel container in \a str
+    */
+    void                    serializeContainer(std::string& str) const;
+    /*!
+        \brief Serialize the voxel containers of the subtree in \a writer
+        \param writer The sink
+        \param buffer Buffer reused for the serialization of each container
+    */
+    void                    serializeNode(StreamWriter& writer, std::string& buffer) const;
+    /*!
+        \brief Returns the number of non-empty voxel containers in the subtree
+    */
+    uint32_t                getNbContainers() const;
+    /*!
+        \brief Notify the octree that the voxels of the node are modified
+    */
+    void                    markModified();
+    /*!
+        \brief Notify the listeners of the octree that the voxel \a it is modified
+    */
+    void                    notifyVoxelModified(iterator const& it);
+
     std::shared_ptr<T_Container> _container;  //!< Voxel container
+    uint64_t                _epoch = 0;     //!< Last edit epoch of the node or of its subtree
     friend T_Container;
+    friend VoxelOctree<T_Container>;
 
 public:
 	/*!
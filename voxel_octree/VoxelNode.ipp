@@ -1,6 +1,46 @@
 namespace voxomap
 {
 
+/*!
+    \brief Returns false if \a predicate is empty
+*/
+template <typename T_Predicate>
+inline static bool isValidPredicate(T_Predicate const&)
+{
+    return true;
+}
+
+template <typename T_Signature>
+inline static bool isValidPredicate(std::function<T_Signature> const& predicate)
+{
+    return static_cast<bool>(predicate);
+}
+
+template <typename T_Return, typename... T_Args>
+inline static bool isValidPredicate(T_Return (*predicate)(T_Args...))
+{
+    return predicate != nullptr;
+}
+
+inline static bool isValidPredicate(std::nullptr_t)
+{
+    return false;
+}
+
+/*!
+    \brief Calls \a predicate with \a args, does nothing for nullptr
+*/
+template <typename T_Predicate, typename... T_Args>
+inline static void callPredicate(T_Predicate const& predicate, T_Args&&... args)
+{
+    predicate(std::forward<T_Args>(args)...);
+}
+
+template <typename... T_Args>
+inline static void callPredicate(std::nullptr_t, T_Args&&...)
+{
+}
+
 template <class T_Container>
 VoxelNode<T_Container>::VoxelNode(int x, int y, int z, uint32_t size)
   : P_Node(x, y, z, size)
@@ -15,6 +55,14 @@ VoxelNode<T_Container>::VoxelNode(VoxelNode<T_Container> const& other)
         _container.reset(new T_Container(*other._container));
 }
 
+template <class T_Container>
+VoxelNode<T_Container>::VoxelNode(VoxelNode<T_Container> const& other, Octree<VoxelNode>& octree)
+  : P_Node(other, octree)
+{
+    if (other._container)
+        _container.reset(new T_Container(*other._container));
+}
+
 template <class T_Container>
 typename T_Container::iterator VoxelNode<T_Container>::begin()
 {
@@ -61,11 +109,20 @@ inline std::shared_ptr<T_Container> VoxelNode<T_Container>::getSharedVoxelContai
     return _container;
 }
 
+template <class T_Container>
+inline std::shared_ptr<T_Container> const& VoxelNode<T_Container>::getSharedVoxelContainer() const
+{
+    return _container;
+}
+
 template <class T_Container>
 inline void VoxelNode<T_Container>::setVoxelContainer(std::shared_ptr<T_Container> area)
 {
     _container = area;
     _container->init(*this);
+    this->markModified();
+    if (this->_octree)
+        static_cast<VoxelOctree<T_Container>*>(this->_octree)->notifyLeaves(*this, false);
 }
 
 template <class T_Container>
@@ -196,7 +253,11 @@ bool VoxelNode<T_Container>::addVoxel(iterator& it, Args&&... args)
     else
         this->copyOnWrite();
 
-    return _container->addVoxel(it, std::forward<Args>(args)...);
+    this->markModified();
+    bool return_value = _container->addVoxel(it, std::forward<Args>(args)...);
+    if (return_value)
+        this->notifyVoxelModified(it);
+    return return_value;
 }
 
 template <class T_Container>
@@ -207,7 +268,11 @@ bool VoxelNode<T_Container>::updateVoxel(iterator& it, Args&&... args)
         return false;
 
     this->copyOnWrite();
-    return _container->updateVoxel(it, std::forward<Args>(args)...);
+    this->markModified();
+    bool return_value = _container->updateVoxel(it, std::forward<Args>(args)...);
+    if (return_value)
+        this->notifyVoxelModified(it);
+    return return_value;
 }
 
 template <class T_Container>
@@ -222,7 +287,9 @@ void VoxelNode<T_Container>::putVoxel(iterator& it, Args&&... args)
     else
         this->copyOnWrite();
 
+    this->markModified();
     _container->putVoxel(it, std::forward<Args>(args)...);
+    this->notifyVoxelModified(it);
 }
 
 template <class T_Container>
@@ -233,7 +300,10 @@ bool VoxelNode<T_Container>::removeVoxel(iterator const& it, Args&&... args)
         return false;
 
     this->copyOnWrite();
+    this->markModified();
     bool return_value = _container->removeVoxel(it, std::forward<Args>(args)...);
+    if (return_value)
+        this->notifyVoxelModified(it);
     if (_container->getNbVoxel() == 0)
     {
         _container.reset();
@@ -243,7 +313,8 @@ bool VoxelNode<T_Container>::removeVoxel(iterator const& it, Args&&... args)
 }
 
 template <class T_Container>
-void VoxelNode<T_Container>::exploreVoxel(std::function<void(iterator const&)> const& predicate) const
+template <typename T_Predicate>
+void VoxelNode<T_Container>::exploreVoxel(T_Predicate const& predicate) const
 {
     if (_container)
     {
@@ -262,7 +333,8 @@ void VoxelNode<T_Container>::exploreVoxel(std::function<void(iterator const&)> c
 }
 
 template <class T_Container>
-void VoxelNode<T_Container>::exploreVoxelContainer(std::function<void(typename T_Container::VoxelContainer const&)> const& predicate) const
+template <typename T_Predicate>
+void VoxelNode<T_Container>::exploreVoxelContainer(T_Predicate const& predicate) const
 {
     if (_container)
     {
@@ -279,7 +351,8 @@ void VoxelNode<T_Container>::exploreVoxelContainer(std::function<void(typename T
 }
 
 template <class T_Container>
-void VoxelNode<T_Container>::exploreVoxelNode(std::function<void(VoxelNode<T_Container> const&)> const& predicate) const
+template <typename T_Predicate>
+void VoxelNode<T_Container>::exploreVoxelNode(T_Predicate const& predicate) const
 {
     if (_container)
         predicate(*this);
@@ -294,7 +367,8 @@ void VoxelNode<T_Container>::exploreVoxelNode(std::function<void(VoxelNode<T_Con
 }
 
 template <class T_Container>
-void VoxelNode<T_Container>::exploreVoxelNode(std::function<void(VoxelNode<T_Container>&)> const& predicate)
+template <typename T_Predicate>
+void VoxelNode<T_Container>::exploreVoxelNode(T_Predicate const& predicate)
 {
     if (_container)
         predicate(*this);
@@ -309,18 +383,19 @@ void VoxelNode<T_Container>::exploreVoxelNode(std::function<void(VoxelNode<T_Con
 }
 
 template <class T_Container>
+template <typename T_InPredicate, typename T_OutPredicate>
 void VoxelNode<T_Container>::exploreBoundingBox(
   BoundingBox<int> const& bounding_box,
-  std::function<void(VoxelNode<T_Container>&)> const& in_predicate,
-  std::function<void(VoxelNode<T_Container>&)> const& out_predicate)
+  T_InPredicate const& in_predicate,
+  T_OutPredicate const& out_predicate)
 {
     BoundingBox<int> box(this->_x, this->_y, this->_z, this->_size, this->_size, this->_size);
 
     if (bounding_box.intersect(box))
     {
-        if (_container && in_predicate)
+        if (_container && isValidPredicate(in_predicate))
         {
-            in_predicate(*this);
+            callPredicate(in_predicate, *this);
         }
 
         for (auto child : this->_children)
@@ -331,9 +406,11 @@ void VoxelNode<T_Container>::exploreBoundingBox(
             }
         }
     }
-    else if (out_predicate)
+    else if (isValidPredicate(out_predicate))
     {
-        this->exploreVoxelNode(out_predicate);
+        this->exploreVoxelNode([&out_predicate](VoxelNode<T_Container>& node) {
+            callPredicate(out_predicate, node);
+        });
     }
 }
 
@@ -380,6 +457,33 @@ inline bool VoxelNode<T_Container>::empty() const
     return this->P_Node::empty() && (_container == nullptr || _container->getNbVoxel() == 0);
 }
 
+template <class T_Container>
+void VoxelNode<T_Container>::memoryUsage(MemoryUsage& usage) const
+{
+    usage.nodes += sizeof(*this);
+    addContainerMemory(_container, usage);
+
+    for (auto const child : this->_children)
+    {
+        if (child)
+            static_cast<VoxelNode<T_Container> const*>(child)->memoryUsage(usage);
+    }
+}
+
+template <class T_Container>
+inline void VoxelNode<T_Container>::markModified()
+{
+    if (this->_octree)
+        static_cast<VoxelOctree<T_Container>*>(this->_octree)->markModified(*this);
+}
+
+template <class T_Container>
+inline void VoxelNode<T_Container>::notifyVoxelModified(iterator const& it)
+{
+    if (this->_octree)
+        static_cast<VoxelOctree<T_Container>*>(this->_octree)->notifyVoxelModified(it);
+}
+
 template <class T_Container>
 void VoxelNode<T_Container>::copyOnWrite()
 {
@@ -396,6 +500,34 @@ uint32_t VoxelNode<T_Container>::serializeNode(std::string& str) const
 {
     uint32_t nb_container = 0;
 
+    if (_container && _container->getNbVoxel() > 0)
+    {
+        this->serializeContainer(str);
+        ++nb_container;
+    }
+
+    for (auto child : this->_children)
+    {
+        if (child)
+            nb_container += child->serializeNode(str);
+    }
+    return nb_container;
+}
+
+template <class T_Container>
+bool VoxelNode<T_Container>::serialize(StreamWriter& writer) const
+{
+    uint32_t nb_container = this->getNbContainers();
+    std::string buffer;
+
+    writer.write(reinterpret_cast<char const*>(&nb_container), sizeof(nb_container));
+    this->serializeNode(writer, buffer);
+    return writer.good();
+}
+
+template <class T_Container>
+void VoxelNode<T_Container>::serializeNode(StreamWriter& writer, std::string& buffer) const
+{
     if (_container && _container->getNbVoxel() > 0)
     {
         int pos[4];
@@ -403,19 +535,75 @@ uint32_t VoxelNode<T_Container>::serializeNode(std::string& str) const
         pos[1] = this->getY();
         pos[2] = this->getZ();
         pos[3] = this->getSize();
-        str.append(reinterpret_cast<char const*>(&pos), sizeof(pos));
-        _container->serialize(str);
+        buffer.clear();
+        _container->serialize(buffer);
+        uint32_t size = static_cast<uint32_t>(buffer.size());
+        writer.write(reinterpret_cast<char const*>(&pos), sizeof(pos));
+        writer.write(reinterpret_cast<char const*>(&size), sizeof(size));
+        writer.write(buffer.data(), buffer.size());
+    }
+
+    for (auto child : this->_children)
+    {
+        if (child && writer.good())
+            child->serializeNode(writer, buffer);
+    }
+}
+
+template <class T_Container>
+uint32_t VoxelNode<T_Container>::getNbContainers() const
+{
+    uint32_t nb_container = (_container && _container->getNbVoxel() > 0) ? 1 : 0;
+
+    for (auto child : this->_children)
+    {
+        if (child)
+            nb_container += child->getNbContainers();
+    }
+    return nb_container;
+}
+
+template <class T_Container>
+uint32_t VoxelNode<T_Container>::serializeDelta(std::string& str, uint64_t checkpoint) const
+{
+    uint32_t nb_container = 0;
+
+    // The epoch of a node is the last epoch of its subtree
+    if (_epoch <= checkpoint)
+        return nb_container;
+
+    if (_container && _container->getNbVoxel() > 0)
+    {
+        this->serializeContainer(str);
         ++nb_container;
     }
 
     for (auto child : this->_children)
     {
         if (child)
-            nb_container += child->serializeNode(str);
+            nb_container += child->serializeDelta(str, checkpoint);
     }
     return nb_container;
 }
 
+template <class T_Container>
+void VoxelNode<T_Container>::serializeContainer(std::string& str) const
+{
+    int pos[4];
+    pos[0] = this->getX();
+    pos[1] = this->getY();
+    pos[2] = this->getZ();
+    pos[3] = this->getSize();
+    str.append(reinterpret_cast<char const*>(&pos), sizeof(pos));
+    _container->serialize(str);
+}
+
+template <class T_Container>
+inline uint64_t VoxelNode<T_Container>::getEpoch() const
+{
+    return _epoch;
+}
+
 template <class T_Container>
 inline void VoxelNode<T_Container>::serialize(std::string& str) const
 {
@@ -455,7 +643,7 @@ size_t VoxelNode<T_Container>::unserialize(VoxelOctree<T_Container>& octree, cha
     {
         std::memcpy(position, &str[pos], sizeof(position));
         pos += sizeof(position);
-        auto node = new VoxelNode<T_Container>(position[0], position[1], position[2], position[3]);
+        auto node = octree.createNode(position[0], position[1], position[2], position[3]);
         node->_container = std::make_shared<T_Container>();
         pos += node->_container->unserialize(&str[pos], size - pos);
         octree.push(*node);
@@ -463,6 +651,36 @@ size_t VoxelNode<T_Container>::unserialize(VoxelOctree<T_Container>& octree, cha
     return pos;
 }
 
+template <class T_Container>
+bool VoxelNode<T_Container>::unserialize(VoxelOctree<T_Container>& octree, StreamReader& reader)
+{
+    uint32_t nb_container;
+    if (!reader.read(reinterpret_cast<char*>(&nb_container), sizeof(nb_container)))
+        return false;
+
+    for (uint32_t i = 0; i < nb_container; ++i)
+    {
+        int position[4];
+        uint32_t size;
+        if (!reader.read(reinterpret_cast<char*>(position), sizeof(position)) ||
+            !reader.read(reinterpret_cast<char*>(&size), sizeof(size)))
+            return false;
+        auto data = reader.read(size);
+        if (!data)
+            return false;
+
+        auto node = octree.createNode(position[0], position[1], position[2], position[3]);
+        node->_container = std::make_shared<T_Container>();
+        if (node->_container->unserialize(data, size) != size)
+        {
+            delete node;
+            return false;
+        }
+        octree.push(*node);
+    }
+    return true;
+}
+
 template <class T_Container>
 inline int VoxelNode<T_Container>::findContainerPosition(int src, int container_id)
 {
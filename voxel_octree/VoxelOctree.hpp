@@ -1,10 +1,19 @@
 #ifndef _VOXOMAP_VOXELOCTREE_HPP_
 #define _VOXOMAP_VOXELOCTREE_HPP_
 
+#include <algorithm>
+#include <memory>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 #include "../octree/Octree.hpp"
 #include "VoxelNode.hpp"
 #include "../utils/BoundingBox.hpp"
+#include "../utils/Vector3.hpp"
+#include "../utils/ThreadPool.hpp"
+#include "../utils/MemoryPool.hpp"
+#include "../utils/MemoryUsage.hpp"
+#include "../utils/MappedFile.hpp"
 
 namespace voxomap
 {
@@ -15,10 +24,17 @@ namespace voxomap
 */
 
 template <class T_Container> class VoxelNode;
+template <class T_Container> class FrozenVoxelOctree;
 
 /*! \class VoxelOctree
     \ingroup VoxelOctree
     \brief Octree optimized for voxel
+    \details Concurrency: the const methods only read the octree, they can be called
+    from several threads at the same time as long as no thread modifies the octree.
+    The non-const methods, including the non-const findVoxel and findVoxelNode that
+    update the internal node cache, require an exclusive access. To share an octree
+    between reader threads, call the lookups through a const reference, with a
+    per-thread hint to keep the benefit of the node cache.
 */
 template <class T_Container>
 class VoxelOctree : public Octree<VoxelNode<T_Container>>
@@ -27,6 +43,52 @@ public:
     using VoxelData = typename T_Container::VoxelData;
     using iterator = typename T_Container::iterator;
 
+    /*! \class Listener
+        \brief Receives the modifications of the voxels of an octree, see addListener
+        \details The notifications are sent by the thread that modifies the octree.
+        The modifications made directly through the non-const getVoxelContainer are not notified.
+        A copy of a listener is not added to the octree of the original.
+    */
+    class Listener
+    {
+    public:
+        /*!
+            \brief Default constructor
+        */
+        Listener() = default;
+        /*!
+            \brief Copy constructor, the copy is not added to an octree
+        */
+        Listener(Listener const& other);
+        /*!
+            \brief Removes the listener from its octree
+        */
+        virtual ~Listener();
+        /*!
+            \brief Assignment operator, the listener stays in its octree
+        */
+        Listener& operator=(Listener const& other);
+
+        /*!
+            \brief Called after the voxel \a it is added, updated or removed
+            \param it Iterator on the voxel, only its node and position are valid
+        */
+        virtual void onVoxelModified(iterator const& it) = 0;
+        /*!
+            \brief Called after the leaf \a node is added to the octree or its voxel container is replaced
+        */
+        virtual void onLeafModified(VoxelNode<T_Container> const& node) = 0;
+        /*!
+            \brief Called before the leaf \a node is removed from the octree
+        */
+        virtual void onLeafRemoving(VoxelNode<T_Container> const& node) = 0;
+
+    private:
+        VoxelOctree* _octree = nullptr; //!< Octree where the listener is added
+
+        friend VoxelOctree;
+    };
+
     /*!
         \brief Default constructor
     */
@@ -40,9 +102,9 @@ public:
     */
     VoxelOctree(VoxelOctree<T_Container>&& other);
     /*!
-        \brief Default destructor
+        \brief Destructor, notifies the removal of the leaves to the listeners
     */
-    virtual ~VoxelOctree() = default;
+    virtual ~VoxelOctree();
     /*!
         \brief Assignement operator
     */
@@ -58,6 +120,12 @@ public:
         \return Pointer to the added node, can be different of \a node if it is already present in the octree
     */
     VoxelNode<T_Container>*                  push(VoxelNode<T_Container>& node) override;
+    /*!
+        \brief Removes \a node from the octree
+        \param node Node to remove
+        \return The removed node and its children
+    */
+    std::unique_ptr<VoxelNode<T_Container>>  pop(VoxelNode<T_Container>& node) override;
     /*!
         \brief Clear the octree
         Removes all nodes and all elements.
@@ -72,6 +140,35 @@ public:
     */
     template <typename T>
     iterator                findVoxel(T x, T y, T z);
+    /*!
+        \brief Returns a voxel iterator, doesn't use the internal node cache so it can be called concurrently
+        \param x X coordinate
+        \param y Y coordinate
+        \param z Z coordinate
+        \return iterator
+    */
+    template <typename T>
+    iterator                findVoxel(T x, T y, T z) const;
+    /*!
+        \brief Returns a voxel iterator, use \a hint instead of the internal node cache so it can be called concurrently
+        \param x X coordinate
+        \param y Y coordinate
+        \param z Z coordinate
+        \param hint Node cache owned by the caller (one by thread), updated with the found node.
+        Must be nullptr or a node of this octree.
+        \return iterator
+    */
+    template <typename T>
+    iterator                findVoxel(T x, T y, T z, VoxelNode<T_Container> const*& hint) const;
+    /*!
+        \brief Find several voxels
+        \details The positions are browsed in Morton order, so consecutive lookups share the path from the root
+        and each search starts from the previous found node.
+        \param positions Array of voxel positions
+        \param results Array of iterators, filled with the result of the search of each position
+        \param nbVoxels Number of voxels inside \a positions and \a results
+    */
+    void                    findVoxels(Vector3I const* positions, iterator* results, size_t nbVoxels) const;
     /*!
         \brief Returns a node, can be NULL
         \param x X coordinate
@@ -80,7 +177,27 @@ public:
         \return The node which contain the voxel, can be NULL
     */
     template <typename T>
+    VoxelNode<T_Container>*	findVoxelNode(T x, T y, T z);
+    /*!
+        \brief Returns a node, can be NULL. Doesn't use the internal node cache so it can be called concurrently
+        \param x X coordinate
+        \param y Y coordinate
+        \param z Z coordinate
+        \return The node which contain the voxel, can be NULL
+    */
+    template <typename T>
     VoxelNode<T_Container>*	findVoxelNode(T x, T y, T z) const;
+    /*!
+        \brief Returns a node, can be NULL. Use \a hint instead of the internal node cache so it can be called concurrently
+        \param x X coordinate
+        \param y Y coordinate
+        \param z Z coordinate
+        \param hint Node cache owned by the caller (one by thread), updated with the found node.
+        Must be nullptr or a node of this octree.
+        \return The node which contain the voxel, can be NULL
+    */
+    template <typename T>
+    VoxelNode<T_Container>*	findVoxelNode(T x, T y, T z, VoxelNode<T_Container> const*& hint) const;
     
     /*!
         \brief Add the voxel if not exist
@@ -120,6 +237,27 @@ public:
     */
     template <typename T, typename... Args>
     iterator                putVoxel(T x, T y, T z, Args&&... args);
+    /*!
+        \brief Add voxels if not exist
+        \details The voxels are grouped by voxel container before insertion, so each node and each container is visited only once.
+        If a position is present several times, the first voxel is kept.
+        \param positions Array of voxel positions
+        \param voxels Array of arguments forward to VoxelData constructor, one for each position
+        \param nbVoxels Number of voxels inside \a positions and \a voxels
+        \return Number of inserted voxels
+    */
+    template <typename T_Data>
+    size_t                  addVoxels(Vector3I const* positions, T_Data const* voxels, size_t nbVoxels);
+    /*!
+        \brief Add or update voxels
+        \details The voxels are grouped by voxel container before insertion, so each node and each container is visited only once.
+        If a position is present several times, the last voxel is kept.
+        \param positions Array of voxel positions
+        \param voxels Array of arguments forward to VoxelData constructor, one for each position
+        \param nbVoxels Number of voxels inside \a positions and \a voxels
+    */
+    template <typename T_Data>
+    void                    putVoxels(Vector3I const* positions, T_Data const* voxels, size_t nbVoxels);
 
     /*!
         \brief Removes a voxel
@@ -153,28 +291,77 @@ public:
 
     /*!
         \brief Browse all voxels
-        \param predicate Function called for each voxel
+        \param predicate Function called for each voxel: void(iterator const&)
     */
-    void                    exploreVoxel(std::function<void(iterator const&)> const& predicate) const;
+    template <typename T_Predicate>
+    void                    exploreVoxel(T_Predicate const& predicate) const;
     /*!
         \brief Browse all voxel containers
-        \param predicate Function called for each voxel container
+        \param predicate Function called for each voxel container: void(VoxelContainer const&)
     */
-    void                    exploreVoxelContainer(std::function<void(typename T_Container::VoxelContainer const&)> const& predicate) const;
+    template <typename T_Predicate>
+    void                    exploreVoxelContainer(T_Predicate const& predicate) const;
     /*!
         \brief Browse all voxel nodes
-        \param predicate Function called for each voxel node
+        \param predicate Function called for each voxel node: void(VoxelNode const&)
     */
-    void                    exploreVoxelNode(std::function<void(VoxelNode<T_Container> const&)> const& predicate) const;
+    template <typename T_Predicate>
+    void                    exploreVoxelNode(T_Predicate const& predicate) const;
     /*!
         \brief Browse all voxel containers
         \param bounding_box The aligned axis bounding box
-        \param in_predicate Function called for each voxel container inside the bounding box
-        \param out_predicate Function called for each voxel container outside the bounding box
+        \param in_predicate Function called for each voxel container inside the bounding box: void(VoxelNode&), can be nullptr
+        \param out_predicate Function called for each voxel container outside the bounding box: void(VoxelNode&), can be nullptr
     */
+    template <typename T_InPredicate, typename T_OutPredicate>
     void                    exploreBoundingBox(BoundingBox<int> const& bounding_box,
-                                               std::function<void(VoxelNode<T_Container>&)> const& in_predicate,
-                                               std::function<void(VoxelNode<T_Container>&)> const& out_predicate);
+                                               T_InPredicate const& in_predicate,
+                                               T_OutPredicate const& out_predicate);
+    /*!
+        \brief Browse all voxels with the threads of \a pool
+        \details The octree is split into the subtrees whose roots are \a depth levels under the root node,
+        each subtree is explored by one task of the pool. \a predicate is called concurrently,
+        the octree must not be modified during the call.
+        \param pool Thread pool executing the tasks
+        \param predicate Function called for each voxel
+        \param depth Depth of the subtree roots, a higher depth gives more and smaller tasks
+    */
+    template <typename T_Predicate>
+    void                    parallelExploreVoxel(ThreadPool& pool, T_Predicate const& predicate, unsigned int depth = 3) const;
+    /*!
+        \brief Browse all voxels with the threads of \a pool and aggregate a result
+        \details Each task has its own result, initialized with \a identity and passed to \a predicate.
+        The results of the tasks are merged with \a reduce on the calling thread, in the order of the subtrees.
+        \param pool Thread pool executing the tasks
+        \param identity Initial value of the results, neutral element of \a reduce
+        \param predicate Function called for each voxel: void(iterator const&, T_Result&)
+        \param reduce Function merging a task result into the final result: void(T_Result&, T_Result const&)
+        \param depth Depth of the subtree roots, a higher depth gives more and smaller tasks
+        \return The aggregated result
+    */
+    template <typename T_Result, typename T_Predicate, typename T_Reduce>
+    T_Result                parallelExploreVoxel(ThreadPool& pool, T_Result const& identity, T_Predicate const& predicate, T_Reduce const& reduce, unsigned int depth = 3) const;
+    /*!
+        \brief Browse all voxel containers with the threads of \a pool
+        \details See parallelExploreVoxel
+        \param pool Thread pool executing the tasks
+        \param predicate Function called for each voxel container
+        \param depth Depth of the subtree roots, a higher depth gives more and smaller tasks
+    */
+    template <typename T_Predicate>
+    void                    parallelExploreVoxelContainer(ThreadPool& pool, T_Predicate const& predicate, unsigned int depth = 3) const;
+    /*!
+        \brief Browse all voxel containers with the threads of \a pool and aggregate a result
+        \details See parallelExploreVoxel
+        \param pool Thread pool executing the tasks
+        \param identity Initial value of the results, neutral element of \a reduce
+        \param predicate Function called for each voxel container: void(VoxelContainer const&, T_Result&)
+        \param reduce Function merging a task result into the final result: void(T_Result&, T_Result const&)
+        \param depth Depth of the subtree roots, a higher depth gives more and smaller tasks
+        \return The aggregated result
+    */
+    template <typename T_Result, typename T_Predicate, typename T_Reduce>
+    T_Result                parallelExploreVoxelContainer(ThreadPool& pool, T_Result const& identity, T_Predicate const& predicate, T_Reduce const& reduce, unsigned int depth = 3) const;
 
     /*!
         \brief Get the number of voxels
@@ -185,6 +372,59 @@ public:
         \param nbVoxels Number of voxels
     */
     void                    setNbVoxels(unsigned int nbVoxels);
+    /*!
+        \brief Enables or disables the leaf index
+        \details The leaf index is a hash map from the position of the voxel containers to their leaf node.
+        When enabled, a lookup that misses the node cache costs one hash probe instead of a descent from the root.
+        It is disabled by default, it uses memory and slows down the creation and the removal of leaves,
+        and it mostly helps deep octrees with many small leaves.
+        \param enable True to build the index, false to release it
+    */
+    void                    enableLeafIndex(bool enable = true);
+    /*!
+        \brief Returns true if the leaf index is enabled
+    */
+    bool                    isLeafIndexEnabled() const;
+    /*!
+        \brief Returns the memory used by the octree, split by category
+        \details The free memory of the node pool belongs to the octree, the free memory of the container pool
+        is shared by all the octrees with the same container type, it is in MemoryUsage::sharedPoolFreeMemory.
+    */
+    MemoryUsage             memoryUsage() const;
+    /*!
+        \brief Adds the memory used by the octree to \a usage
+        \details The containers shared with the structures already added to \a usage are not counted again.
+    */
+    void                    memoryUsage(MemoryUsage& usage) const;
+    /*!
+        \brief Returns a read-only copy of the octree with a compact layout
+        \details The voxel containers are shared with the octree until one of them is modified.
+    */
+    FrozenVoxelOctree<T_Container> freeze() const;
+    /*!
+        \brief Returns a read-only snapshot of the octree, safe to read from other threads while the octree is modified
+        \details The snapshot is a frozen octree sharing the voxel containers with the octree,
+        a container is copied only when the octree modifies it while the snapshot is alive.
+        No voxel is copied when taking the snapshot, only the node structure.
+        The last snapshot is returned again while it is alive and the octree has not been modified since,
+        so taking a snapshot of an unchanged octree costs nothing.
+        The modifications made directly through the non-const getVoxelContainer are not detected.
+    */
+    std::shared_ptr<FrozenVoxelOctree<T_Container> const> snapshot();
+    /*!
+        \brief Returns the version of the octree, incremented by each modification of its voxels or nodes
+    */
+    uint64_t                getVersion() const;
+    /*!
+        \brief Adds \a listener to the listeners notified of the modifications of the octree
+        \details A listener is in one octree at a time, it is removed from its previous octree.
+        The listener is removed from the octree when it is destroyed.
+    */
+    void                    addListener(Listener& listener);
+    /*!
+        \brief Removes \a listener from the listeners of the octree
+    */
+    void                    removeListener(Listener& listener);
 
     /*!
      * \brief Returns an iterator to the first voxel of the octree
@@ -207,6 +447,66 @@ public:
         \return Number of bytes read inside str
     */
     size_t                  unserialize(char const* str, size_t strsize);
+    /*!
+        \brief Serialize the structure in \a writer, without keeping the whole serialization in memory
+        \details See VoxelNode::serialize(StreamWriter&) for the format.
+        \param writer The sink, not flushed
+        \return False if the writer failed
+    */
+    bool                    serialize(StreamWriter& writer) const;
+    /*!
+        \brief Unserialize the data of \a reader written by serialize(StreamWriter&)
+        \param reader The source
+        \return False if the data is invalid or incomplete
+    */
+    bool                    unserialize(StreamReader& reader);
+    /*!
+        \brief Serialize the structure in a format that can be loaded from a mapped file
+        \details The voxel containers are aligned. If T_Container::MAPPABLE, a container is written
+        as its memory image, used in place by unserializeMapped. The data can only be loaded
+        with the same voxel container type on the same platform.
+        \param str String use for save the serialization, must be written at the beginning of the file
+    */
+    void                    serializeMapped(std::string& str) const;
+    /*!
+        \brief Unserialize a file written by serializeMapped
+        \details If T_Container::MAPPABLE, the voxel containers are not copied: they stay in the
+        mapped memory, and are copied when modified. The file is kept mapped until the last container
+        using it is released.
+        \param file The mapped file
+        \return False if the file is invalid
+    */
+    bool                    unserializeMapped(std::shared_ptr<MappedFile> const& file);
+    /*!
+        \brief Starts a new edit epoch
+        \details The nodes are stamped with the epoch of their last modification, and the removed leaves
+        are kept with the epoch of their removal once this method has been called.
+        \return The checkpoint to give to serializeDelta to get the modifications made after this call
+    */
+    uint64_t                checkpoint();
+    /*!
+        \brief Serialize the voxel containers modified and the leaves removed after \a checkpoint
+        \details Only the subtrees modified after the checkpoint are browsed.
+        The modifications made directly through the non-const getVoxelContainer are not detected.
+        \param str String use for save the serialization
+        \param checkpoint Value returned by checkpoint, 0 to serialize all the voxel containers
+    */
+    void                    serializeDelta(std::string& str, uint64_t checkpoint) const;
+    /*!
+        \brief Apply a delta made by serializeDelta
+        \details The voxel containers of the delta replace the existing ones.
+        \param str String that contains data
+        \param strsize Size of the string
+        \return Number of bytes read inside str, 0 if the delta is invalid
+    */
+    size_t                  applyDelta(char const* str, size_t strsize);
+    /*!
+        \brief Forget the leaves removed before or at \a checkpoint
+        \details Call it when the deltas from \a checkpoint or older are no longer needed,
+        the removed leaves are kept until then.
+        \param checkpoint Value returned by checkpoint
+    */
+    void                    discardRemovedLeaves(uint64_t checkpoint);
 
 private:
     /*!
@@ -226,6 +526,25 @@ private:
     */
     template <typename T>
     typename std::enable_if<std::is_floating_point<T>::value, iterator>::type _findVoxel(T x, T y, T z);
+    /*!
+        \brief Method to find voxel with a node cache owned by the caller (for integer arguments)
+        \param x X coordinate of the voxel
+        \param y Y coordinate of the voxel
+        \param z Z coordinate of the voxel
+        \param hint Node cache
+        \return iterator on the voxel
+    */
+    iterator                _findVoxel(int x, int y, int z, VoxelNode<T_Container> const*& hint) const;
+    /*!
+        \brief Method to find voxel with a node cache owned by the caller (for floating point arguments)
+        \param x X coordinate of the voxel
+        \param y Y coordinate of the voxel
+        \param z Z coordinate of the voxel
+        \param hint Node cache
+        \return iterator on the voxel
+    */
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, iterator>::type _findVoxel(T x, T y, T z, VoxelNode<T_Container> const*& hint) const;
 
     /*!
         \brief Method to find node that contain voxel (for integer arguments)
@@ -234,7 +553,7 @@ private:
         \param z Z coordinate of the voxel
         \return The found node
     */
-    VoxelNode<T_Container>* _findVoxelNode(int x, int y, int z) const;
+    VoxelNode<T_Container>* _findVoxelNode(int x, int y, int z);
     /*!
         \brief Method to find node that contain voxel (for floating point arguments)
         \param x X coordinate of the voxel
@@ -243,7 +562,26 @@ private:
         \return The found node
     */
     template <typename T>
-    typename std::enable_if<std::is_floating_point<T>::value, VoxelNode<T_Container>*>::type _findVoxelNode(T x, T y, T z) const;
+    typename std::enable_if<std::is_floating_point<T>::value, VoxelNode<T_Container>*>::type _findVoxelNode(T x, T y, T z);
+    /*!
+        \brief Method to find node that contain voxel with a node cache owned by the caller (for integer arguments)
+        \param x X coordinate of the voxel
+        \param y Y coordinate of the voxel
+        \param z Z coordinate of the voxel
+        \param hint Node cache
+        \return The found node
+    */
+    VoxelNode<T_Container>* _findVoxelNode(int x, int y, int z, VoxelNode<T_Container> const*& hint) const;
+    /*!
+        \brief Method to find node that contain voxel with a node cache owned by the caller (for floating point arguments)
+        \param x X coordinate of the voxel
+        \param y Y coordinate of the voxel
+        \param z Z coordinate of the voxel
+        \param hint Node cache
+        \return The found node
+    */
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, VoxelNode<T_Container>*>::type _findVoxelNode(T x, T y, T z, VoxelNode<T_Container> const*& hint) const;
 
 protected:
     /*!
@@ -263,18 +601,117 @@ protected:
     */
     template <typename T>
     typename std::enable_if<std::is_floating_point<T>::value, VoxelNode<T_Container>*>::type pushContainerNode(T x, T y, T z);
+    /*!
+        \brief Call \a predicate for each position, grouped by voxel container
+        \details Positions are sorted with sortByContainer, so the positions of a same node and of a same container are consecutive.
+        The leaf nodes are found or created once per group.
+        \param positions Array of voxel positions
+        \param nbVoxels Number of positions
+        \param predicate Function called with an iterator initialized on the position and the index of the position
+    */
+    template <typename T_Predicate>
+    void                    pushVoxels(Vector3I const* positions, size_t nbVoxels, T_Predicate&& predicate);
+    /*!
+        \brief Sort positions by Morton code of their voxel container
+        \details Positions with the same code keep their order.
+        \param positions Array of voxel positions
+        \param nbVoxels Number of positions
+        \param order Filled with the pairs (code, index of the position) sorted by code
+        \return False if the positions are already grouped by container, \a order is left empty
+    */
+    static bool             sortByContainer(Vector3I const* positions, size_t nbVoxels, std::vector<std::pair<uint64_t, size_t>>& order);
+
+    /*!
+        \brief Get the roots of the subtrees \a depth levels under the root node
+        \details Leaf nodes above \a depth are also returned.
+        \param depth Depth of the subtree roots
+        \param nodes Filled with the subtree roots
+    */
+    void                    getSubtrees(unsigned int depth, std::vector<VoxelNode<T_Container> const*>& nodes) const;
+    /*!
+        \brief Call \a explore on each subtree with the threads of \a pool and aggregate the results
+        \param pool Thread pool executing the tasks
+        \param identity Initial value of the results, neutral element of \a reduce
+        \param explore Function called for each subtree: void(VoxelNode const&, T_Result&)
+        \param reduce Function merging a task result into the final result
+        \param depth Depth of the subtree roots
+        \return The aggregated result
+    */
+    template <typename T_Result, typename T_Explore, typename T_Reduce>
+    T_Result                parallelExplore(ThreadPool& pool, T_Result const& identity, T_Explore const& explore, T_Reduce const& reduce, unsigned int depth) const;
 
     /*!
         \brief Called when \a node is remove from the octree, used to remove from cache
     */
     void                    notifyNodeRemoving(VoxelNode<T_Container>& node) override;
+    /*!
+        \brief Adds or removes the leaves of the subtree \a node in the leaf index
+        \param node Root of the subtree
+        \param add True to add the leaves, false to remove them
+    */
+    void                    indexLeaves(VoxelNode<T_Container> const& node, bool add);
+    /*!
+        \brief Increments the version
+    */
+    void                    markModified();
+    /*!
+        \brief Increments the version and stamps \a node and its parents with the current epoch,
+        called by the nodes when their voxels are modified
+    */
+    void                    markModified(VoxelNode<T_Container>& node);
+    /*!
+        \brief Stamps the subtree \a node and its parents with the current epoch
+        \details Called when the subtree is added, its leaves are no longer removed.
+    */
+    void                    markSubtreeModified(VoxelNode<T_Container>& node);
+    /*!
+        \brief Keeps the position of the leaves of the subtree \a node with the current epoch
+        \details Used by serializeDelta, only once checkpoint has been called.
+    */
+    void                    recordRemovedLeaves(VoxelNode<T_Container> const& node);
+    /*!
+        \brief Notifies the listeners that the voxel \a it is modified, called by the nodes
+    */
+    void                    notifyVoxelModified(iterator const& it);
+    /*!
+        \brief Notifies the listeners of the leaves of the subtree \a node
+        \param node Root of the subtree
+        \param removing True if the leaves are removed, false if they are added or modified
+    */
+    void                    notifyLeaves(VoxelNode<T_Container> const& node, bool removing);
+
+    /*!
+        \brief Hash of the position of a leaf
+    */
+    struct LeafHash
+    {
+        size_t operator()(Vector3I const& position) const
+        {
+            return static_cast<size_t>(position.x) * 73856093u ^ static_cast<size_t>(position.y) * 19349663u ^ static_cast<size_t>(position.z) * 83492791u;
+        }
+    };
 
-    mutable VoxelNode<T_Container>*	_nodeCache = nullptr;   //!< Cache for improve performance
+    VoxelNode<T_Container> const*	_nodeCache = nullptr;   //!< Cache for improve performance, only used by non-const methods
     unsigned int					_nbVoxels = 0;          //!< Number of voxels
+    bool                            _leafIndexEnabled = false;  //!< True if _leafIndex is maintained
+    std::unordered_map<Vector3I, VoxelNode<T_Container>*, LeafHash> _leafIndex;  //!< Leaf nodes by position, see enableLeafIndex
+    uint64_t                        _version = 0;           //!< Incremented by each modification
+    uint64_t                        _snapshotVersion = 0;   //!< Version of \a _snapshot
+    std::weak_ptr<FrozenVoxelOctree<T_Container> const> _snapshot;  //!< Last snapshot, not kept alive to avoid useless copies on write
+    uint64_t                        _epoch = 1;             //!< Current edit epoch, see checkpoint
+    uint64_t                        _clearEpoch = 0;        //!< Epoch of the last clear or assignment
+    std::unordered_map<Vector3I, uint64_t, LeafHash> _removedLeaves;  //!< Epoch of removal of the leaves, see serializeDelta
+    std::vector<Listener*>          _listeners;             //!< Listeners of the modifications, see addListener
+
+    static const uint32_t DELTA_CLEAR = 1;  //!< Flag of a delta: the octree was cleared
+    static const uint32_t MAPPED_MAGIC = 0x4D584F56;    //!< First bytes of serializeMapped data
+
+    friend VoxelNode<T_Container>;
 };
 
 }
 
 #include "VoxelOctree.ipp"
+#include "FrozenVoxelOctree.hpp"
 
 #endif // _VOXOMAP_VOXELOCTREE_HPP_
@@ -1,36 +1,123 @@
+#include <algorithm>
+#include <cstring>
+#include "../utils/Morton.hpp"
+
 namespace voxomap
 {
 
+template <class T_Container>
+const uint32_t VoxelOctree<T_Container>::DELTA_CLEAR;
+
+template <class T_Container>
+const uint32_t VoxelOctree<T_Container>::MAPPED_MAGIC;
+
+template <class T_Container>
+VoxelOctree<T_Container>::Listener::Listener(Listener const&)
+{
+}
+
+template <class T_Container>
+VoxelOctree<T_Container>::Listener::~Listener()
+{
+    if (_octree)
+        _octree->removeListener(*this);
+}
+
+template <class T_Container>
+typename VoxelOctree<T_Container>::Listener& VoxelOctree<T_Container>::Listener::operator=(Listener const&)
+{
+    return *this;
+}
+
 template <class T_Container>
 VoxelOctree<T_Container>::VoxelOctree()
 {
 }
 
+template <class T_Container>
+VoxelOctree<T_Container>::~VoxelOctree()
+{
+    if (this->getRootNode())
+        this->notifyLeaves(*this->getRootNode(), true);
+    for (auto listener : _listeners)
+        listener->_octree = nullptr;
+}
+
 template <class T_Container>
 VoxelOctree<T_Container>::VoxelOctree(VoxelOctree<T_Container> const& other)
     : Octree<VoxelNode<T_Container>>(other), _nbVoxels(other._nbVoxels)
 {
+    this->enableLeafIndex(other._leafIndexEnabled);
+    // The copied nodes are new for the deltas of this octree
+    _clearEpoch = _epoch;
+    if (this->getRootNode())
+        this->markSubtreeModified(*this->getRootNode());
 }
 
 template <class T_Container>
 VoxelOctree<T_Container>::VoxelOctree(VoxelOctree<T_Container>&& other)
-    : Octree<VoxelNode<T_Container>>(std::move(other)), _nbVoxels(other._nbVoxels)
+    : Octree<VoxelNode<T_Container>>(std::move(other)), _nbVoxels(other._nbVoxels),
+    _leafIndexEnabled(other._leafIndexEnabled), _leafIndex(std::move(other._leafIndex)),
+    _version(other._version), _snapshotVersion(other._snapshotVersion), _snapshot(std::move(other._snapshot)),
+    _epoch(other._epoch), _clearEpoch(other._clearEpoch), _removedLeaves(std::move(other._removedLeaves))
 {
+    other._nodeCache = nullptr;
+    other._leafIndex.clear();
+    other._removedLeaves.clear();
+    other._clearEpoch = other._epoch;
+    other.markModified();
+    // The listeners stay on the other octree, its leaves are moved out of it
+    if (this->getRootNode())
+        other.notifyLeaves(*this->getRootNode(), true);
 }
 
 template <class T_Container>
 VoxelOctree<T_Container>& VoxelOctree<T_Container>::operator=(VoxelOctree<T_Container> const& other)
 {
+    if (this->getRootNode())
+        this->notifyLeaves(*this->getRootNode(), true);
     this->Octree<VoxelNode<T_Container>>::operator=(other);
     _nbVoxels = other._nbVoxels;
+    _nodeCache = nullptr;
+    _leafIndexEnabled = false;
+    _leafIndex.clear();
+    this->enableLeafIndex(other._leafIndexEnabled);
+    this->markModified();
+    _removedLeaves.clear();
+    _clearEpoch = _epoch;
+    if (this->getRootNode())
+    {
+        this->markSubtreeModified(*this->getRootNode());
+        this->notifyLeaves(*this->getRootNode(), false);
+    }
     return *this;
 }
 
 template <class T_Container>
 VoxelOctree<T_Container>& VoxelOctree<T_Container>::operator=(VoxelOctree<T_Container>&& other)
 {
+    if (this->getRootNode())
+        this->notifyLeaves(*this->getRootNode(), true);
     this->Octree<VoxelNode<T_Container>>::operator=(std::move(other));
     _nbVoxels = other._nbVoxels;
+    _nodeCache = nullptr;
+    _leafIndexEnabled = other._leafIndexEnabled;
+    _leafIndex = std::move(other._leafIndex);
+    other._nodeCache = nullptr;
+    other._leafIndex.clear();
+    this->markModified();
+    other.markModified();
+    // The epochs of the moved nodes come from the other octree
+    _removedLeaves.clear();
+    _clearEpoch = _epoch;
+    if (this->getRootNode())
+    {
+        this->markSubtreeModified(*this->getRootNode());
+        other.notifyLeaves(*this->getRootNode(), true);
+        this->notifyLeaves(*this->getRootNode(), false);
+    }
+    other._removedLeaves.clear();
+    other._clearEpoch = other._epoch;
     return *this;
 }
 
@@ -39,19 +126,47 @@ VoxelNode<T_Container>* VoxelOctree<T_Container>::push(VoxelNode<T_Container>& n
 {
     int nbVoxel = n.getNbVoxel();
     auto node = this->Octree<VoxelNode<T_Container>>::push(n);
+    this->markModified();
+    if (node)
+        this->markSubtreeModified(*node);
 
     // update voxel number in voxel octree
     if (node == &n)
         _nbVoxels += nbVoxel;
+    // The leaves of n can be merged anywhere in the subtree of node
+    if (_leafIndexEnabled && node)
+        this->indexLeaves(*node, true);
+    if (node)
+        this->notifyLeaves(*node, false);
     return node;
 }
 
+template <class T_Container>
+std::unique_ptr<VoxelNode<T_Container>> VoxelOctree<T_Container>::pop(VoxelNode<T_Container>& node)
+{
+    auto result = this->Octree<VoxelNode<T_Container>>::pop(node);
+    this->markModified();
+    if (result && _epoch > 1)
+        this->recordRemovedLeaves(*result);
+    if (_leafIndexEnabled && result)
+        this->indexLeaves(*result, false);
+    if (result)
+        this->notifyLeaves(*result, true);
+    return result;
+}
+
 template <class T_Container>
 void VoxelOctree<T_Container>::clear()
 {
     _nbVoxels = 0;
     _nodeCache = nullptr;
+    _leafIndex.clear();
+    _removedLeaves.clear();
+    _clearEpoch = _epoch;
+    if (this->getRootNode())
+        this->notifyLeaves(*this->getRootNode(), true);
     this->Octree<VoxelNode<T_Container>>::clear();
+    this->markModified();
 }
 
 template <class T_Container>
@@ -61,16 +176,45 @@ inline typename T_Container::iterator VoxelOctree<T_Container>::findVoxel(T x, T
     return this->_findVoxel(x, y, z);
 }
 
+template <class T_Container>
+template <typename T>
+inline typename T_Container::iterator VoxelOctree<T_Container>::findVoxel(T x, T y, T z) const
+{
+    VoxelNode<T_Container> const* hint = nullptr;
+    return this->_findVoxel(x, y, z, hint);
+}
+
+template <class T_Container>
+template <typename T>
+inline typename T_Container::iterator VoxelOctree<T_Container>::findVoxel(T x, T y, T z, VoxelNode<T_Container> const*& hint) const
+{
+    return this->_findVoxel(x, y, z, hint);
+}
+
 template <class T_Container>
 typename T_Container::iterator VoxelOctree<T_Container>::_findVoxel(int x, int y, int z)
 {
-    auto node = this->_findVoxelNode(x, y, z);
+    return static_cast<VoxelOctree<T_Container> const*>(this)->_findVoxel(x, y, z, _nodeCache);
+}
+
+template <class T_Container>
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, typename T_Container::iterator>::type VoxelOctree<T_Container>::_findVoxel(T x, T y, T z)
+{
+    return this->_findVoxel(
+        static_cast<int>(std::floor(x)),
+        static_cast<int>(std::floor(y)),
+        static_cast<int>(std::floor(z))
+    );
+}
+
+template <class T_Container>
+typename T_Container::iterator VoxelOctree<T_Container>::_findVoxel(int x, int y, int z, VoxelNode<T_Container> const*& hint) const
+{
+    auto node = this->_findVoxelNode(x, y, z, hint);
 
     iterator it;
     it.initPosition(x, y, z);
-
-    //if (x == -118 && y == 11 && z == 25)
-    //std::cout << x << " " << y << " " << z << std::endl;
     if (node)
         node->findVoxel(it);
     return it;
@@ -78,46 +222,123 @@ typename T_Container::iterator VoxelOctree<T_Container>::_findVoxel(int x, int y
 
 template <class T_Container>
 template <typename T>
-typename std::enable_if<std::is_floating_point<T>::value, typename T_Container::iterator>::type VoxelOctree<T_Container>::_findVoxel(T x, T y, T z)
+typename std::enable_if<std::is_floating_point<T>::value, typename T_Container::iterator>::type VoxelOctree<T_Container>::_findVoxel(T x, T y, T z, VoxelNode<T_Container> const*& hint) const
 {
     return this->_findVoxel(
         static_cast<int>(std::floor(x)),
         static_cast<int>(std::floor(y)),
-        static_cast<int>(std::floor(z))
+        static_cast<int>(std::floor(z)),
+        hint
     );
 }
 
+template <class T_Container>
+void VoxelOctree<T_Container>::findVoxels(Vector3I const* positions, iterator* results, size_t nbVoxels) const
+{
+    VoxelNode<T_Container>* node = nullptr;
+    auto findVoxel = [&](size_t i) {
+        Vector3I const& position = positions[i];
+        int x = position.x & T_Container::COORD_MASK;
+        int y = position.y & T_Container::COORD_MASK;
+        int z = position.z & T_Container::COORD_MASK;
+        iterator& it = results[i];
+
+        it = iterator();
+        it.initPosition(position.x, position.y, position.z);
+        if (!node || node->getX() != x || node->getY() != y || node->getZ() != z)
+        {
+            // Start from the previous leaf, only the end of the path from the root is browsed
+            auto tmp = node ? node->findNode(x, y, z, T_Container::NB_VOXELS) : this->findNode(x, y, z, T_Container::NB_VOXELS);
+            if (!tmp)
+                return;
+            node = tmp;
+        }
+        node->findVoxel(it);
+    };
+
+    std::vector<std::pair<uint64_t, size_t>> order;
+    if (!sortByContainer(positions, nbVoxels, order))
+    {
+        for (size_t i = 0; i < nbVoxels; ++i)
+            findVoxel(i);
+        return;
+    }
+
+    for (auto const& pair : order)
+        findVoxel(pair.second);
+}
+
 template <class T_Container>
 template <typename T>
-inline VoxelNode<T_Container>* VoxelOctree<T_Container>::findVoxelNode(T x, T y, T z) const
+inline VoxelNode<T_Container>* VoxelOctree<T_Container>::findVoxelNode(T x, T y, T z)
 {
     return this->_findVoxelNode(x, y, z);
 }
 
 template <class T_Container>
-VoxelNode<T_Container>* VoxelOctree<T_Container>::_findVoxelNode(int x, int y, int z) const
+template <typename T>
+inline VoxelNode<T_Container>* VoxelOctree<T_Container>::findVoxelNode(T x, T y, T z) const
+{
+    VoxelNode<T_Container> const* hint = nullptr;
+    return this->_findVoxelNode(x, y, z, hint);
+}
+
+template <class T_Container>
+template <typename T>
+inline VoxelNode<T_Container>* VoxelOctree<T_Container>::findVoxelNode(T x, T y, T z, VoxelNode<T_Container> const*& hint) const
+{
+    return this->_findVoxelNode(x, y, z, hint);
+}
+
+template <class T_Container>
+VoxelNode<T_Container>* VoxelOctree<T_Container>::_findVoxelNode(int x, int y, int z)
+{
+    return static_cast<VoxelOctree<T_Container> const*>(this)->_findVoxelNode(x, y, z, _nodeCache);
+}
+
+template <class T_Container>
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, VoxelNode<T_Container>*>::type VoxelOctree<T_Container>::_findVoxelNode(T x, T y, T z)
+{
+    return this->_findVoxelNode(
+        static_cast<int>(std::floor(x)),
+        static_cast<int>(std::floor(y)),
+        static_cast<int>(std::floor(z))
+    );
+}
+
+template <class T_Container>
+VoxelNode<T_Container>* VoxelOctree<T_Container>::_findVoxelNode(int x, int y, int z, VoxelNode<T_Container> const*& hint) const
 {
     x &= T_Container::COORD_MASK;
     y &= T_Container::COORD_MASK;
     z &= T_Container::COORD_MASK;
 
-    if (_nodeCache && _nodeCache->getX() == x && _nodeCache->getY() == y && _nodeCache->getZ() == z)
-        return _nodeCache;
+    if (hint && hint->getX() == x && hint->getY() == y && hint->getZ() == z)
+        return const_cast<VoxelNode<T_Container>*>(hint);
 
-    auto node = this->findNode(x, y, z, T_Container::NB_VOXELS);
+    VoxelNode<T_Container>* node;
+    if (_leafIndexEnabled)
+    {
+        auto it = _leafIndex.find(Vector3I(x, y, z));
+        node = (it != _leafIndex.end()) ? it->second : nullptr;
+    }
+    else
+        node = this->findNode(x, y, z, T_Container::NB_VOXELS);
     if (node)
-        _nodeCache = node;
+        hint = node;
     return node;
 }
 
 template <class T_Container>
 template <typename T>
-typename std::enable_if<std::is_floating_point<T>::value, VoxelNode<T_Container>*>::type VoxelOctree<T_Container>::_findVoxelNode(T x, T y, T z) const
+typename std::enable_if<std::is_floating_point<T>::value, VoxelNode<T_Container>*>::type VoxelOctree<T_Container>::_findVoxelNode(T x, T y, T z, VoxelNode<T_Container> const*& hint) const
 {
     return this->_findVoxelNode(
         static_cast<int>(std::floor(x)),
         static_cast<int>(std::floor(y)),
-        static_cast<int>(std::floor(z))
+        static_cast<int>(std::floor(z)),
+        hint
     );
 }
 
@@ -166,6 +387,27 @@ typename T_Container::iterator VoxelOctree<T_Container>::putVoxel(T x, T y, T z,
     return it;
 }
 
+template <class T_Container>
+template <typename T_Data>
+size_t VoxelOctree<T_Container>::addVoxels(Vector3I const* positions, T_Data const* voxels, size_t nbVoxels)
+{
+    size_t nbAdded = 0;
+    this->pushVoxels(positions, nbVoxels, [&](iterator& it, size_t i) {
+        if (it.node->addVoxel(it, voxels[i]))
+            ++nbAdded;
+    });
+    return nbAdded;
+}
+
+template <class T_Container>
+template <typename T_Data>
+void VoxelOctree<T_Container>::putVoxels(Vector3I const* positions, T_Data const* voxels, size_t nbVoxels)
+{
+    this->pushVoxels(positions, nbVoxels, [&](iterator& it, size_t i) {
+        it.node->putVoxel(it, voxels[i]);
+    });
+}
+
 template <class T_Container>
 template <typename T, typename... Args>
 bool VoxelOctree<T_Container>::removeVoxel(T x, T y, T z, Args&&... args)
@@ -199,30 +441,34 @@ void VoxelOctree<T_Container>::removeOfCache(VoxelNode<T_Container> const& node)
 }
 
 template <class T_Container>
-void VoxelOctree<T_Container>::exploreVoxel(std::function<void(iterator const&)> const& predicate) const
+template <typename T_Predicate>
+void VoxelOctree<T_Container>::exploreVoxel(T_Predicate const& predicate) const
 {
     if (this->getRootNode())
         this->getRootNode()->exploreVoxel(predicate);
 }
 
 template <class T_Container>
-void VoxelOctree<T_Container>::exploreVoxelContainer(std::function<void(typename T_Container::VoxelContainer const&)> const& predicate) const
+template <typename T_Predicate>
+void VoxelOctree<T_Container>::exploreVoxelContainer(T_Predicate const& predicate) const
 {
     if (this->getRootNode())
         const_cast<VoxelNode<T_Container> const*>(this->getRootNode())->exploreVoxelContainer(predicate);
 }
 
 template <class T_Container>
-void VoxelOctree<T_Container>::exploreVoxelNode(std::function<void(VoxelNode<T_Container> const&)> const& predicate) const
+template <typename T_Predicate>
+void VoxelOctree<T_Container>::exploreVoxelNode(T_Predicate const& predicate) const
 {
     if (this->getRootNode())
         const_cast<VoxelNode<T_Container> const*>(this->getRootNode())->exploreVoxelNode(predicate);
 }
 
 template <class T_Container>
+template <typename T_InPredicate, typename T_OutPredicate>
 void VoxelOctree<T_Container>::exploreBoundingBox(BoundingBox<int> const& bounding_box,
-                                             std::function<void(VoxelNode<T_Container>&)> const& in_predicate,
-                                             std::function<void(VoxelNode<T_Container>&)> const& out_predicate)
+                                             T_InPredicate const& in_predicate,
+                                             T_OutPredicate const& out_predicate)
 {
     if (!this->getRootNode())
         return;
@@ -236,6 +482,103 @@ void VoxelOctree<T_Container>::exploreBoundingBox(BoundingBox<int> const& boundi
     }
 }
 
+template <class T_Container>
+template <typename T_Predicate>
+void VoxelOctree<T_Container>::parallelExploreVoxel(ThreadPool& pool, T_Predicate const& predicate, unsigned int depth) const
+{
+    std::vector<VoxelNode<T_Container> const*> subtrees;
+    this->getSubtrees(depth, subtrees);
+    pool.parallelFor(subtrees.size(), [&subtrees, &predicate](size_t i) {
+        subtrees[i]->exploreVoxel(predicate);
+    });
+}
+
+template <class T_Container>
+template <typename T_Result, typename T_Predicate, typename T_Reduce>
+T_Result VoxelOctree<T_Container>::parallelExploreVoxel(ThreadPool& pool, T_Result const& identity, T_Predicate const& predicate, T_Reduce const& reduce, unsigned int depth) const
+{
+    return this->parallelExplore(pool, identity, [&predicate](VoxelNode<T_Container> const& node, T_Result& result) {
+        node.exploreVoxel([&predicate, &result](iterator const& it) {
+            predicate(it, result);
+        });
+    }, reduce, depth);
+}
+
+template <class T_Container>
+template <typename T_Predicate>
+void VoxelOctree<T_Container>::parallelExploreVoxelContainer(ThreadPool& pool, T_Predicate const& predicate, unsigned int depth) const
+{
+    std::vector<VoxelNode<T_Container> const*> subtrees;
+    this->getSubtrees(depth, subtrees);
+    pool.parallelFor(subtrees.size(), [&subtrees, &predicate](size_t i) {
+        subtrees[i]->exploreVoxelContainer(predicate);
+    });
+}
+
+template <class T_Container>
+template <typename T_Result, typename T_Predicate, typename T_Reduce>
+T_Result VoxelOctree<T_Container>::parallelExploreVoxelContainer(ThreadPool& pool, T_Result const& identity, T_Predicate const& predicate, T_Reduce const& reduce, unsigned int depth) const
+{
+    return this->parallelExplore(pool, identity, [&predicate](VoxelNode<T_Container> const& node, T_Result& result) {
+        node.exploreVoxelContainer([&predicate, &result](typename T_Container::VoxelContainer const& container) {
+            predicate(container, result);
+        });
+    }, reduce, depth);
+}
+
+template <class T_Container>
+void VoxelOctree<T_Container>::getSubtrees(unsigned int depth, std::vector<VoxelNode<T_Container> const*>& nodes) const
+{
+    nodes.clear();
+    if (!this->getRootNode())
+        return;
+
+    std::vector<VoxelNode<T_Container> const*> nextNodes;
+    nodes.push_back(this->getRootNode());
+    for (unsigned int i = 0; i < depth; ++i)
+    {
+        nextNodes.clear();
+        for (auto node : nodes)
+        {
+            if (node->getVoxelContainer())
+            {
+                nextNodes.push_back(node);
+                continue;
+            }
+            for (auto child : node->getChildren())
+            {
+                if (child)
+                    nextNodes.push_back(child);
+            }
+        }
+        nodes.swap(nextNodes);
+    }
+}
+
+template <class T_Container>
+template <typename T_Result, typename T_Explore, typename T_Reduce>
+T_Result VoxelOctree<T_Container>::parallelExplore(ThreadPool& pool, T_Result const& identity, T_Explore const& explore, T_Reduce const& reduce, unsigned int depth) const
+{
+    // Wrapper to avoid the std::vector<bool> specialization, its elements can't be written concurrently
+    struct TaskResult
+    {
+        T_Result value;
+    };
+
+    std::vector<VoxelNode<T_Container> const*> subtrees;
+    this->getSubtrees(depth, subtrees);
+
+    std::vector<TaskResult> results(subtrees.size(), TaskResult{identity});
+    pool.parallelFor(subtrees.size(), [&subtrees, &results, &explore](size_t i) {
+        explore(*subtrees[i], results[i].value);
+    });
+
+    T_Result result = identity;
+    for (auto const& taskResult : results)
+        reduce(result, taskResult.value);
+    return result;
+}
+
 template <class T_Container>
 unsigned int VoxelOctree<T_Container>::getNbVoxels() const
 {
@@ -248,6 +591,109 @@ void VoxelOctree<T_Container>::setNbVoxels(unsigned int nbVoxels)
     _nbVoxels = nbVoxels;
 }
 
+template <class T_Container>
+void VoxelOctree<T_Container>::enableLeafIndex(bool enable)
+{
+    if (enable == _leafIndexEnabled)
+        return;
+
+    _leafIndexEnabled = enable;
+    _leafIndex.clear();
+    if (enable && this->getRootNode())
+        this->indexLeaves(*this->getRootNode(), true);
+    else if (!enable)
+        std::unordered_map<Vector3I, VoxelNode<T_Container>*, LeafHash>().swap(_leafIndex);
+}
+
+template <class T_Container>
+bool VoxelOctree<T_Container>::isLeafIndexEnabled() const
+{
+    return _leafIndexEnabled;
+}
+
+template <class T_Container>
+void VoxelOctree<T_Container>::addListener(Listener& listener)
+{
+    if (listener._octree == this)
+        return;
+    if (listener._octree)
+        listener._octree->removeListener(listener);
+    listener._octree = this;
+    _listeners.push_back(&listener);
+}
+
+template <class T_Container>
+void VoxelOctree<T_Container>::removeListener(Listener& listener)
+{
+    auto it = std::find(_listeners.begin(), _listeners.end(), &listener);
+    if (it == _listeners.end())
+        return;
+    _listeners.erase(it);
+    listener._octree = nullptr;
+}
+
+template <class T_Container>
+FrozenVoxelOctree<T_Container> VoxelOctree<T_Container>::freeze() const
+{
+    return FrozenVoxelOctree<T_Container>(*this);
+}
+
+template <class T_Container>
+std::shared_ptr<FrozenVoxelOctree<T_Container> const> VoxelOctree<T_Container>::snapshot()
+{
+    auto result = _snapshot.lock();
+    if (!result || _snapshotVersion != _version)
+    {
+        result = std::make_shared<FrozenVoxelOctree<T_Container> const>(*this);
+        _snapshot = result;
+        _snapshotVersion = _version;
+    }
+    return result;
+}
+
+template <class T_Container>
+inline uint64_t VoxelOctree<T_Container>::getVersion() const
+{
+    return _version;
+}
+
+template <class T_Container>
+inline void VoxelOctree<T_Container>::markModified()
+{
+    ++_version;
+}
+
+template <class T_Container>
+inline void VoxelOctree<T_Container>::markModified(VoxelNode<T_Container>& node)
+{
+    ++_version;
+    // The parents of a node stamped with the current epoch are already stamped
+    for (auto current = &node; current && current->_epoch != _epoch; current = current->getParent())
+        current->_epoch = _epoch;
+}
+
+template <class T_Container>
+MemoryUsage VoxelOctree<T_Container>::memoryUsage() const
+{
+    MemoryUsage usage;
+    this->memoryUsage(usage);
+    return usage;
+}
+
+template <class T_Container>
+void VoxelOctree<T_Container>::memoryUsage(MemoryUsage& usage) const
+{
+    if (this->getRootNode())
+        this->getRootNode()->memoryUsage(usage);
+    // Estimation of the hash map: one allocation by element and the bucket array
+    if (_leafIndexEnabled)
+        usage.leafIndex += _leafIndex.size() * (sizeof(typename decltype(_leafIndex)::value_type) + 2 * sizeof(void*))
+                        + _leafIndex.bucket_count() * sizeof(void*);
+
+    usage.poolFreeMemory += this->getNodePool().getFreeMemory();
+    usage.sharedPoolFreeMemory = MemoryPool<sizeof(typename T_Container::VoxelContainer)>::get().getFreeMemory();
+}
+
 template <class T_Container>
 typename T_Container::iterator VoxelOctree<T_Container>::begin()
 {
@@ -275,11 +721,269 @@ size_t VoxelOctree<T_Container>::unserialize(char const* str, size_t strsize)
     return VoxelNode<T_Container>::unserialize(*this, str, strsize);
 }
 
+template <class T_Container>
+bool VoxelOctree<T_Container>::serialize(StreamWriter& writer) const
+{
+    if (this->getRootNode())
+        return this->getRootNode()->serialize(writer);
+
+    uint32_t nb_container = 0;
+    return writer.write(reinterpret_cast<char const*>(&nb_container), sizeof(nb_container));
+}
+
+template <class T_Container>
+bool VoxelOctree<T_Container>::unserialize(StreamReader& reader)
+{
+    return VoxelNode<T_Container>::unserialize(*this, reader);
+}
+
+template <class T_Container>
+void VoxelOctree<T_Container>::serializeMapped(std::string& str) const
+{
+    // Header, table of the voxel containers, then the voxel containers
+    std::vector<VoxelNode<T_Container> const*> leaves;
+    std::vector<VoxelNode<T_Container> const*> nodes;
+    if (this->getRootNode())
+        nodes.push_back(this->getRootNode());
+    while (!nodes.empty())
+    {
+        auto node = nodes.back();
+        nodes.pop_back();
+        if (node->getVoxelContainer() && node->getNbVoxel() > 0)
+            leaves.push_back(node);
+        for (auto child : node->getChildren())
+        {
+            if (child)
+                nodes.push_back(child);
+        }
+    }
+
+    uint32_t header[4] = {
+        MAPPED_MAGIC,
+        static_cast<uint32_t>(sizeof(T_Container)),
+        T_Container::MAPPABLE ? 1u : 0u,
+        static_cast<uint32_t>(leaves.size())
+    };
+    size_t begin = str.size();
+    size_t table_pos = begin + sizeof(header);
+    str.append(reinterpret_cast<char const*>(header), sizeof(header));
+    str.resize(table_pos + leaves.size() * (4 * sizeof(int) + 2 * sizeof(uint64_t)));
+
+    for (auto leaf : leaves)
+    {
+        size_t alignment = alignof(T_Container);
+        str.resize(str.size() + (alignment - (str.size() - begin) % alignment) % alignment);
+
+        uint64_t range[2] = { str.size() - begin, 0 };
+        if (T_Container::MAPPABLE)
+            str.append(reinterpret_cast<char const*>(leaf->getVoxelContainer()), sizeof(T_Container));
+        else
+            leaf->getVoxelContainer()->serialize(str);
+        range[1] = str.size() - begin - range[0];
+
+        int position[4] = { leaf->getX(), leaf->getY(), leaf->getZ(), static_cast<int>(leaf->getSize()) };
+        std::memcpy(&str[table_pos], position, sizeof(position));
+        table_pos += sizeof(position);
+        std::memcpy(&str[table_pos], range, sizeof(range));
+        table_pos += sizeof(range);
+    }
+}
+
+template <class T_Container>
+bool VoxelOctree<T_Container>::unserializeMapped(std::shared_ptr<MappedFile> const& file)
+{
+    if (!file)
+        return false;
+    char* data = file->getData();
+    size_t size = file->getSize();
+
+    uint32_t header[4];
+    if (size < sizeof(header))
+        return false;
+    std::memcpy(header, data, sizeof(header));
+    if (header[0] != MAPPED_MAGIC || header[1] != sizeof(T_Container) || header[2] != (T_Container::MAPPABLE ? 1u : 0u))
+        return false;
+
+    size_t table_pos = sizeof(header);
+    size_t record_size = 4 * sizeof(int) + 2 * sizeof(uint64_t);
+    if (header[3] > (size - table_pos) / record_size)
+        return false;
+
+    for (uint32_t i = 0; i < header[3]; ++i)
+    {
+        int position[4];
+        uint64_t range[2];
+        std::memcpy(position, &data[table_pos], sizeof(position));
+        table_pos += sizeof(position);
+        std::memcpy(range, &data[table_pos], sizeof(range));
+        table_pos += sizeof(range);
+        if (range[0] > size || range[1] > size - range[0])
+            return false;
+        // Each record must be a leaf of the octree
+        if (position[3] != static_cast<int>(T_Container::NB_VOXELS) ||
+            (position[0] & static_cast<int>(T_Container::COORD_MASK)) != position[0] ||
+            (position[1] & static_cast<int>(T_Container::COORD_MASK)) != position[1] ||
+            (position[2] & static_cast<int>(T_Container::COORD_MASK)) != position[2])
+            return false;
+
+        std::shared_ptr<T_Container> container;
+        if (T_Container::MAPPABLE)
+        {
+            if (range[1] != sizeof(T_Container) || range[0] % alignof(T_Container) != 0)
+                return false;
+            // The container stays in the mapped memory and shares the ownership of the file,
+            // VoxelNode::copyOnWrite copies it when it is modified while the file is shared
+            container = std::shared_ptr<T_Container>(file, reinterpret_cast<T_Container*>(&data[range[0]]));
+        }
+        else
+        {
+            container = std::make_shared<T_Container>();
+            if (container->unserialize(&data[range[0]], static_cast<size_t>(range[1])) != range[1])
+                return false;
+        }
+
+        auto node = this->createNode(position[0], position[1], position[2], position[3]);
+        node->setVoxelContainer(container);
+        this->push(*node);
+    }
+    return true;
+}
+
+template <class T_Container>
+inline uint64_t VoxelOctree<T_Container>::checkpoint()
+{
+    return _epoch++;
+}
+
+template <class T_Container>
+void VoxelOctree<T_Container>::serializeDelta(std::string& str, uint64_t checkpoint) const
+{
+    uint32_t total_size = 0;
+    uint32_t flags = (checkpoint < _clearEpoch) ? DELTA_CLEAR : 0;
+    uint32_t nb_removed = 0;
+    uint32_t nb_container = 0;
+    size_t pos = str.size();
+
+    str.append(reinterpret_cast<char*>(&total_size), sizeof(total_size));
+    str.append(reinterpret_cast<char*>(&flags), sizeof(flags));
+    str.append(reinterpret_cast<char*>(&nb_removed), sizeof(nb_removed));
+    for (auto const& removed : _removedLeaves)
+    {
+        if (removed.second <= checkpoint)
+            continue;
+        int position[3] = { removed.first.x, removed.first.y, removed.first.z };
+        str.append(reinterpret_cast<char const*>(&position), sizeof(position));
+        ++nb_removed;
+    }
+
+    size_t container_pos = str.size();
+    str.append(reinterpret_cast<char*>(&nb_container), sizeof(nb_container));
+    if (this->getRootNode())
+        nb_container = this->getRootNode()->serializeDelta(str, checkpoint);
+
+    total_size = static_cast<uint32_t>(str.size() - pos);
+    std::memcpy(&str[pos], &total_size, sizeof(total_size));
+    std::memcpy(&str[pos + sizeof(total_size) + sizeof(flags)], &nb_removed, sizeof(nb_removed));
+    std::memcpy(&str[container_pos], &nb_container, sizeof(nb_container));
+}
+
+template <class T_Container>
+size_t VoxelOctree<T_Container>::applyDelta(char const* str, size_t strsize)
+{
+    uint32_t total_size;
+    uint32_t flags;
+    uint32_t nb_removed;
+    uint32_t nb_container;
+    size_t pos = 0;
+
+    if (strsize < sizeof(total_size) + sizeof(flags) + sizeof(nb_removed))
+        return 0;
+    std::memcpy(&total_size, str, sizeof(total_size));
+    if (strsize < total_size)
+        return 0;
+    pos += sizeof(total_size);
+    std::memcpy(&flags, &str[pos], sizeof(flags));
+    pos += sizeof(flags);
+    std::memcpy(&nb_removed, &str[pos], sizeof(nb_removed));
+    pos += sizeof(nb_removed);
+    if (nb_removed > (strsize - pos) / (3 * sizeof(int)))
+        return 0;
+
+    if (flags & DELTA_CLEAR)
+        this->clear();
+
+    for (uint32_t i = 0; i < nb_removed; ++i)
+    {
+        int position[3];
+        std::memcpy(position, &str[pos], sizeof(position));
+        pos += sizeof(position);
+        auto node = this->findVoxelNode(position[0], position[1], position[2]);
+        if (node)
+        {
+            unsigned int nb_voxel = node->getNbVoxel();
+            if (this->pop(*node))
+                _nbVoxels -= std::min(nb_voxel, _nbVoxels);
+        }
+    }
+
+    if (pos + sizeof(nb_container) > strsize)
+        return 0;
+    std::memcpy(&nb_container, &str[pos], sizeof(nb_container));
+    pos += sizeof(nb_container);
+    for (uint32_t i = 0; i < nb_container; ++i)
+    {
+        int position[4];
+        if (pos + sizeof(position) > strsize)
+            return 0;
+        std::memcpy(position, &str[pos], sizeof(position));
+        pos += sizeof(position);
+        auto container = std::make_shared<T_Container>();
+        size_t container_size = container->unserialize(&str[pos], strsize - pos);
+        if (container_size == 0)
+            return 0;
+        pos += container_size;
+
+        // The container of the delta replaces the existing one
+        auto node = this->findVoxelNode(position[0], position[1], position[2]);
+        if (node)
+        {
+            unsigned int nb_voxel = node->getNbVoxel();
+            node->setVoxelContainer(container);
+            _nbVoxels = _nbVoxels - std::min(nb_voxel, _nbVoxels) + container->getNbVoxel();
+        }
+        else
+        {
+            node = this->createNode(position[0], position[1], position[2], position[3]);
+            node->setVoxelContainer(container);
+            this->push(*node);
+        }
+    }
+    return pos;
+}
+
+template <class T_Container>
+void VoxelOctree<T_Container>::discardRemovedLeaves(uint64_t checkpoint)
+{
+    for (auto it = _removedLeaves.begin(); it != _removedLeaves.end();)
+    {
+        if (it->second <= checkpoint)
+            it = _removedLeaves.erase(it);
+        else
+            ++it;
+    }
+}
+
 template <class T_Container>
 VoxelNode<T_Container>* VoxelOctree<T_Container>::pushContainerNode(int x, int y, int z)
 {
-    auto node = new VoxelNode<T_Container>(x & ~(T_Container::NB_VOXELS - 1), y & ~(T_Container::NB_VOXELS - 1), z & ~(T_Container::NB_VOXELS - 1), T_Container::NB_VOXELS);
-    return this->Octree<VoxelNode<T_Container>>::push(*node);
+    auto node = this->createNode(x & ~(T_Container::NB_VOXELS - 1), y & ~(T_Container::NB_VOXELS - 1), z & ~(T_Container::NB_VOXELS - 1), T_Container::NB_VOXELS);
+    auto result = this->Octree<VoxelNode<T_Container>>::push(*node);
+    if (_leafIndexEnabled && result)
+        _leafIndex[Vector3I(result->getX(), result->getY(), result->getZ())] = result;
+    // Stamps the intermediate nodes created by the push
+    if (result)
+        this->markSubtreeModified(*result);
+    return result;
 }
 
 template <class T_Container>
@@ -293,10 +997,166 @@ typename std::enable_if<std::is_floating_point<T>::value, VoxelNode<T_Container>
     );
 }
 
+template <class T_Container>
+template <typename T_Predicate>
+void VoxelOctree<T_Container>::pushVoxels(Vector3I const* positions, size_t nbVoxels, T_Predicate&& predicate)
+{
+    VoxelNode<T_Container>* node = nullptr;
+    auto pushVoxel = [&](size_t i) {
+        Vector3I const& position = positions[i];
+        if (!node || !node->isInside(position.x, position.y, position.z))
+        {
+            node = this->_findVoxelNode(position.x, position.y, position.z);
+            if (!node)
+                node = this->pushContainerNode(position.x, position.y, position.z);
+        }
+
+        iterator it;
+        it.initPosition(position.x, position.y, position.z);
+        it.node = node;
+        predicate(it, i);
+    };
+
+    std::vector<std::pair<uint64_t, size_t>> order;
+    if (!sortByContainer(positions, nbVoxels, order))
+    {
+        for (size_t i = 0; i < nbVoxels; ++i)
+            pushVoxel(i);
+        return;
+    }
+
+    for (auto const& pair : order)
+        pushVoxel(pair.second);
+}
+
+template <class T_Container>
+bool VoxelOctree<T_Container>::sortByContainer(Vector3I const* positions, size_t nbVoxels, std::vector<std::pair<uint64_t, size_t>>& order)
+{
+    static_assert(T_Container::VoxelContainer::NB_VOXELS == 8, "Voxel containers are expected to be 8 voxels wide");
+    const int shift = 3;
+
+    // Positions already grouped by container don't need to be sorted
+    size_t nbGroups = 0;
+    for (size_t i = 0; i < nbVoxels; ++i)
+    {
+        if (i == 0 || (positions[i].x >> shift) != (positions[i - 1].x >> shift) ||
+            (positions[i].y >> shift) != (positions[i - 1].y >> shift) ||
+            (positions[i].z >> shift) != (positions[i - 1].z >> shift))
+            ++nbGroups;
+    }
+    if (nbGroups * 4 <= nbVoxels)
+        return false;
+
+    order.resize(nbVoxels);
+    for (size_t i = 0; i < nbVoxels; ++i)
+        order[i] = std::make_pair(mortonEncode(positions[i].x >> shift, positions[i].y >> shift, positions[i].z >> shift), i);
+    mortonSort(order);
+    return true;
+}
+
 template <class T_Container>
 void VoxelOctree<T_Container>::notifyNodeRemoving(VoxelNode<T_Container>& node)
 {
     this->removeOfCache(node);
+    if (_leafIndexEnabled && node.getSize() == T_Container::NB_VOXELS)
+    {
+        auto it = _leafIndex.find(Vector3I(node.getX(), node.getY(), node.getZ()));
+        if (it != _leafIndex.end() && it->second == &node)
+            _leafIndex.erase(it);
+    }
+}
+
+template <class T_Container>
+void VoxelOctree<T_Container>::indexLeaves(VoxelNode<T_Container> const& node, bool add)
+{
+    if (node.getSize() == T_Container::NB_VOXELS)
+    {
+        Vector3I position(node.getX(), node.getY(), node.getZ());
+        if (add)
+            _leafIndex[position] = const_cast<VoxelNode<T_Container>*>(&node);
+        else
+        {
+            auto it = _leafIndex.find(position);
+            if (it != _leafIndex.end() && it->second == &node)
+                _leafIndex.erase(it);
+        }
+        return;
+    }
+
+    for (auto child : node.getChildren())
+    {
+        if (child)
+            this->indexLeaves(*child, add);
+    }
+}
+
+template <class T_Container>
+void VoxelOctree<T_Container>::markSubtreeModified(VoxelNode<T_Container>& node)
+{
+    std::vector<VoxelNode<T_Container>*> nodes(1, &node);
+    while (!nodes.empty())
+    {
+        auto current = nodes.back();
+        nodes.pop_back();
+        current->_epoch = _epoch;
+        if (!_removedLeaves.empty() && current->getSize() == T_Container::NB_VOXELS)
+            _removedLeaves.erase(Vector3I(current->getX(), current->getY(), current->getZ()));
+        for (auto child : current->getChildren())
+        {
+            if (child)
+                nodes.push_back(child);
+        }
+    }
+    if (node.getParent())
+        this->markModified(*node.getParent());
+}
+
+template <class T_Container>
+void VoxelOctree<T_Container>::recordRemovedLeaves(VoxelNode<T_Container> const& node)
+{
+    if (node.getSize() == T_Container::NB_VOXELS)
+    {
+        _removedLeaves[Vector3I(node.getX(), node.getY(), node.getZ())] = _epoch;
+        return;
+    }
+
+    for (auto child : node.getChildren())
+    {
+        if (child)
+            this->recordRemovedLeaves(*child);
+    }
+}
+
+template <class T_Container>
+inline void VoxelOctree<T_Container>::notifyVoxelModified(iterator const& it)
+{
+    for (auto listener : _listeners)
+        listener->onVoxelModified(it);
+}
+
+template <class T_Container>
+void VoxelOctree<T_Container>::notifyLeaves(VoxelNode<T_Container> const& node, bool removing)
+{
+    if (_listeners.empty())
+        return;
+
+    if (node.getSize() == T_Container::NB_VOXELS)
+    {
+        for (auto listener : _listeners)
+        {
+            if (removing)
+                listener->onLeafRemoving(node);
+            else
+                listener->onLeafModified(node);
+        }
+        return;
+    }
+
+    for (auto child : node.getChildren())
+    {
+        if (child)
+            this->notifyLeaves(*child, removing);
+    }
 }
 
 }
@@ -2,6 +2,7 @@
 #define _VOXOMAP_ITERATOR_HPP_
 
 #include <cstdint>
+#include "VoxelContainer/OccupancyMask.hpp"
 
 namespace voxomap
 {
@@ -108,27 +108,18 @@ bool container_iterator<T>::findNextChildNode(VoxelNode<T>& i_node)
 template <class T>
 bool container_iterator<T>::findNextVoxel(VoxelContainer& container)
 {
-	for (uint8_t ix = this->x; ix < VoxelContainer::NB_VOXELS; ++ix)
-	{
-		for (uint8_t iy = this->y; iy < VoxelContainer::NB_VOXELS; ++iy)
-		{
-			for (uint8_t iz = this->z; iz < VoxelContainer::NB_VOXELS; ++iz)
-			{
-				this->voxel = container.findVoxel(ix, iy, iz);
-				if (this->voxel)
-				{
-					this->x = ix;
-					this->y = iy;
-					this->z = iz;
-					this->voxelContainer = &container;
-					return true;
-				}
-			}
-			this->z = 0;
-		}
-		this->y = 0;
-	}
-	return false;
+	// The empty cells are skipped a word at a time with the occupancy mask
+	auto const& occupancy = container.getOccupancy();
+	uint16_t id = occupancy.findNext(OccupancyMask::getIndex(this->x, this->y, this->z));
+	if (id >= OccupancyMask::NB_BITS)
+		return false;
+
+	this->x = static_cast<uint8_t>(id >> 6);
+	this->y = static_cast<uint8_t>(id >> 3 & 7);
+	this->z = static_cast<uint8_t>(id & 7);
+	this->voxel = container.findVoxel(this->x, this->y, this->z);
+	this->voxelContainer = &container;
+	return true;
 }
 
 template <class T>